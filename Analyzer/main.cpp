@@ -0,0 +1,114 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "..//Invaders/ControlFlowAnalyzer.hpp"
+#include "..//Invaders/ToolSupport.hpp"
+
+// Build time tool finding reachable code of ROM images. Writes code map, which
+// BlockCacheCpuImpl::predecodeBlocks() loads at startup and Recompiler takes
+// with --code-map.
+//
+// Usage: Analyzer <output.map> [options] <address>:<file>...
+//   --entry <address>  Additional entry point, reset and RST vectors are always used
+//   --listing <file>   Write blocks with their successors and jump tables as text
+//
+// Space Invaders:
+//   Analyzer invaders.map --listing invaders.cfg 0x0000:invaders.h 0x0800:invaders.g 0x1000:invaders.f 0x1800:invaders.e
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: Analyzer <output.map> [--entry <address>] [--listing <file>] <address>:<file>..." << std::endl;
+        return 1;
+    }
+
+    const std::string outputPath = argv[1];
+    std::string listingPath;
+    std::vector<u16> entryPoints;
+    std::vector<RomFile> roms;
+
+    for (int i = 2; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        if ((argument == "--entry" || argument == "--listing") && i + 1 < argc)
+        {
+            const std::string value = argv[++i];
+            u16 addr = 0;
+            if (argument == "--listing")
+            {
+                listingPath = value;
+            }
+            else if (ToolSupport::parseAddress(value, addr))
+            {
+                entryPoints.push_back(addr);
+            }
+            else
+            {
+                std::cerr << "Invalid entry point " << value << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            RomFile rom;
+            std::string error;
+            if (!ToolSupport::loadRomFile(argument, rom, error))
+            {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+            roms.push_back(std::move(rom));
+        }
+    }
+
+    if (roms.empty())
+    {
+        std::cerr << "No ROM files given" << std::endl;
+        return 1;
+    }
+
+    u16 origin = 0;
+    std::vector<u8> image;
+    if (!ToolSupport::buildImage(roms, origin, image))
+    {
+        std::cerr << "ROM files do not fit into address space" << std::endl;
+        return 1;
+    }
+
+    ControlFlowAnalyzer analyzer(origin, image);
+    analyzer.addRestartVectors();
+    for (auto addr : entryPoints)
+    {
+        analyzer.addEntryPoint(addr);
+    }
+    analyzer.analyze();
+
+    std::ofstream output(outputPath, std::ios::binary);
+    if (!output)
+    {
+        std::cerr << "Cannot write " << outputPath << std::endl;
+        return 1;
+    }
+    analyzer.getCodeMap().write(output);
+
+    if (!listingPath.empty())
+    {
+        std::ofstream listing(listingPath);
+        if (!listing)
+        {
+            std::cerr << "Cannot write " << listingPath << std::endl;
+            return 1;
+        }
+        analyzer.writeListing(listing);
+    }
+
+    std::cout << "Found " << analyzer.getBlocks().size() << " blocks in " << analyzer.getRoutines().size() << " routines, "
+              << analyzer.getJumpTables().size() << " jump tables, " << analyzer.getUnresolvedJumps().size() << " unresolved PCHL" << std::endl;
+    std::cout << "Code " << analyzer.getByteCount(ByteClass::OPCODE) + analyzer.getByteCount(ByteClass::OPERAND)
+              << " bytes, data " << analyzer.getByteCount(ByteClass::DATA)
+              << " bytes, unknown " << analyzer.getByteCount(ByteClass::UNKNOWN) << " bytes" << std::endl;
+    return 0;
+}
@@ -0,0 +1,140 @@
+#include "PerfCounters.hpp"
+
+#ifdef __linux__
+#include <cerrno>
+#include <cstring>
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char* const EVENT_NAMES[] = { "host_cycles", "host_instructions", "branch_misses", "l1_icache_misses" };
+
+#ifdef __linux__
+    struct EventConfig
+    {
+        u32 type;
+        u64 config;
+    };
+
+    const EventConfig EVENT_CONFIGS[] = {
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS },
+        { PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES },
+        { PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1I | (PERF_COUNT_HW_CACHE_OP_READ << 8) | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16) }
+    };
+
+    int openCounter(const EventConfig& event)
+    {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = event.type;
+        attr.config = event.config;
+        attr.disabled = 1;
+        // Excluding kernel keeps counters usable with default perf_event_paranoid
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        return static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, -1, 0));
+    }
+#endif
+}
+
+PerfCounters::PerfCounters()
+    : descriptors()
+    , error()
+{
+    descriptors.fill(-1);
+#ifdef __linux__
+    for (std::size_t event = 0; event < descriptors.size(); event++)
+    {
+        descriptors[event] = openCounter(EVENT_CONFIGS[event]);
+        if (descriptors[event] < 0 && error.empty())
+        {
+            error = std::string(EVENT_NAMES[event]) + ": " + std::strerror(errno);
+        }
+    }
+#else
+    error = "perf_event_open is available only on Linux";
+#endif
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef __linux__
+    for (auto descriptor : descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            close(descriptor);
+        }
+    }
+#endif
+}
+
+bool PerfCounters::isAvailable(HostEvent event) const
+{
+    return descriptors[static_cast<std::size_t>(event)] >= 0;
+}
+
+bool PerfCounters::isAnyAvailable() const
+{
+    for (std::size_t event = 0; event < descriptors.size(); event++)
+    {
+        if (isAvailable(static_cast<HostEvent>(event)))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+const std::string& PerfCounters::getError() const
+{
+    return error;
+}
+
+void PerfCounters::start()
+{
+#ifdef __linux__
+    for (auto descriptor : descriptors)
+    {
+        if (descriptor >= 0)
+        {
+            ioctl(descriptor, PERF_EVENT_IOC_RESET, 0);
+            ioctl(descriptor, PERF_EVENT_IOC_ENABLE, 0);
+        }
+    }
+#endif
+}
+
+HostEventCounts PerfCounters::stop()
+{
+    HostEventCounts counts = {};
+#ifdef __linux__
+    for (std::size_t event = 0; event < descriptors.size(); event++)
+    {
+        if (descriptors[event] >= 0)
+        {
+            ioctl(descriptors[event], PERF_EVENT_IOC_DISABLE, 0);
+        }
+    }
+    for (std::size_t event = 0; event < descriptors.size(); event++)
+    {
+        u64 value = 0;
+        if (descriptors[event] >= 0 && read(descriptors[event], &value, sizeof(value)) == sizeof(value))
+        {
+            counts[event] = value;
+        }
+    }
+#endif
+    return counts;
+}
+
+const char* PerfCounters::getEventName(HostEvent event)
+{
+    return EVENT_NAMES[static_cast<std::size_t>(event)];
+}
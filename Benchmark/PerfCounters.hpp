@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+#include "..//Invaders/Types.hpp"
+
+enum class HostEvent
+{
+    CYCLES = 0,
+    INSTRUCTIONS = 1,
+    BRANCH_MISSES = 2,
+    L1_ICACHE_MISSES = 3,
+    COUNT = 4
+};
+
+using HostEventCounts = std::array<u64, static_cast<std::size_t>(HostEvent::COUNT)>;
+
+// Host hardware counters read through Linux perf_event_open, counting user space
+// of the calling thread only. Every counter is opened on its own, so event
+// which is not supported (like icache misses on many virtual machines) does not
+// disable the others. When counters are not permitted (perf_event_paranoid)
+// or on other systems none of them is available and results are reported
+// without them.
+class PerfCounters
+{
+    public:
+        PerfCounters();
+
+        ~PerfCounters();
+
+        PerfCounters(const PerfCounters&) = delete;
+
+        PerfCounters& operator=(const PerfCounters&) = delete;
+
+        bool isAvailable(HostEvent event) const;
+
+        bool isAnyAvailable() const;
+
+        // Reason why counters which are not available could not be opened
+        const std::string& getError() const;
+
+        // Resets and enables counters
+        void start();
+
+        // Disables counters and reads their values, 0 for counters which are not available
+        HostEventCounts stop();
+
+        static const char* getEventName(HostEvent event);
+
+    private:
+        std::array<int, static_cast<std::size_t>(HostEvent::COUNT)> descriptors;
+        std::string error;
+};
@@ -0,0 +1,393 @@
+#include <algorithm>
+#include <chrono>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "..//Invaders/BlockCacheCpuImpl.hpp"
+#include "..//Invaders/BusImpl.hpp"
+#include "..//Invaders/CpuImpl.hpp"
+#include "..//Invaders/ToolSupport.hpp"
+
+#include "PerfCounters.hpp"
+
+// Measures throughput of cpu backends and writes results as JSON, so they can
+// be compared between backends and commits.
+//
+// Micro benchmarks run loops made of one class of instructions (ALU with register
+// or immedate operand, MOV, stack, taken and not taken branches, memory at (HL)).
+// Macro benchmark runs frames of attract mode when ROM files are given.
+//
+// On Linux host cycles, instructions, branch misses and L1 icache misses are counted
+// around every run, and reported per emulated instruction. Counters which cannot
+// be opened are reported as null.
+//
+// Usage: Benchmark [options] [<address>:<file>...]
+//   --backend <name>      decoder, table, threaded, block, tiered or jit, can be repeated, all by default
+//   --lazy-flags          Enable lazy flag evaluation
+//   --repetitions <n>     Times every benchmark is run, best and median time are reported (5)
+//   --frames <n>          Frames of attract mode run by macro benchmark (600)
+//   --output <file>       Write JSON into file instead of standard output
+//   --opcode-stats <file> Write JSON with opcodes executed in attract mode, needs build
+//                         with OPCODE_STATS_ENABLED
+//
+// Space Invaders:
+//   Benchmark --output results.json 0x0000:invaders.h 0x0800:invaders.g 0x1000:invaders.f 0x1800:invaders.e
+
+namespace
+{
+    constexpr u64 MICRO_BENCHMARK_CYCLES = 20000000;
+    constexpr unsigned BODY_REPEATS = 8;
+
+    constexpr u8 JMP_OPCODE = 0xC3;
+    constexpr u8 JZ_OPCODE = 0xCA;
+    constexpr u8 JNZ_OPCODE = 0xC2;
+
+    struct MicroBenchmark
+    {
+        const char* name;
+        std::vector<u8> setup;
+        std::vector<u8> body;  // Repeated BODY_REPEATS times in loop
+        bool jumpsToNext;      // Body is single jump, its operand is patched to address of next instruction
+    };
+
+    const std::vector<MicroBenchmark> MICRO_BENCHMARKS = {
+        // ADD B; SUB C; ANA D; XRA E; ORA H; CMP L; ADC B; SBB C
+        { "alu_register", {}, { 0x80, 0x91, 0xA2, 0xAB, 0xB4, 0xBD, 0x88, 0x99 }, false },
+        // ADI 01; SUI 02; ANI FF; XRI 55; ORI 00; CPI 03; ACI 01; SBI 02
+        { "alu_immedate", {}, { 0xC6, 0x01, 0xD6, 0x02, 0xE6, 0xFF, 0xEE, 0x55, 0xF6, 0x00, 0xFE, 0x03, 0xCE, 0x01, 0xDE, 0x02 }, false },
+        // MOV B,C; MOV C,D; MOV D,E; MOV E,A; MOV A,B; MOV H,D; MOV L,E; MOV A,H
+        { "mov", {}, { 0x41, 0x4A, 0x53, 0x5F, 0x78, 0x62, 0x6B, 0x7C }, false },
+        // LXI SP,2400
+        // PUSH B; PUSH D; PUSH H; PUSH PSW; POP PSW; POP H; POP D; POP B
+        { "stack", { 0x31, 0x00, 0x24 }, { 0xC5, 0xD5, 0xE5, 0xF5, 0xF1, 0xE1, 0xD1, 0xC1 }, false },
+        // XRA A
+        // JZ next
+        { "branch_taken", { 0xAF }, { JZ_OPCODE }, true },
+        // XRA A
+        // JNZ 0000
+        { "branch_not_taken", { 0xAF }, { JNZ_OPCODE, 0x00, 0x00 }, false },
+        // LXI H,2100
+        // MOV A,M; MOV M,A; INR M; ADD M; DCR M; MVI M,12; CMP M; MOV M,B
+        { "memory_hl", { 0x21, 0x00, 0x21 }, { 0x7E, 0x77, 0x34, 0x86, 0x35, 0x36, 0x12, 0xBE, 0x70 }, false }
+    };
+
+    struct Result
+    {
+        std::string name;
+        const char* kind;
+        const char* backend;
+        u64 instructions;
+        u64 cycles;
+        double bestSeconds;
+        double medianSeconds;
+        HostEventCounts hostEvents;  // Of the fastest run
+    };
+
+    struct Sample
+    {
+        double seconds;
+        HostEventCounts hostEvents;
+    };
+
+    // Setup, then body repeated in endless loop
+    std::vector<u8> buildMicroProgram(const MicroBenchmark& benchmark)
+    {
+        std::vector<u8> program = benchmark.setup;
+        const auto loop = static_cast<u16>(program.size());
+        for (unsigned i = 0; i < BODY_REPEATS; i++)
+        {
+            program.insert(program.end(), benchmark.body.begin(), benchmark.body.end());
+            if (benchmark.jumpsToNext)
+            {
+                const auto next = static_cast<u16>(program.size() + 2);
+                program.push_back(next & 0xFF);
+                program.push_back(next >> 8);
+            }
+        }
+        program.insert(program.end(), { JMP_OPCODE, static_cast<u8>(loop & 0xFF), static_cast<u8>(loop >> 8) });
+        return program;
+    }
+
+    // Creates cpu over fresh machine with given ROM loaded, returns time and host events of runCpu.
+    // Idle loop detection is disabled, as skipped loops would not be counted by countInstructions
+    // and micro benchmarks would be skipped entirely.
+    template <typename TRun>
+    Sample measure(PerfCounters& counters, const CpuBackend& backend, bool lazyFlags, const std::vector<RomFile>& roms,
+                   TRun runCpu)
+    {
+        auto bus = std::make_shared<BusImpl>();
+        for (const auto& rom : roms)
+        {
+            bus->loadIntoMemory(rom.addr, rom.data);
+        }
+        auto cpu = backend.create(bus);
+        cpu->setLazyFlagsEnabled(lazyFlags);
+        if (auto blockCacheCpu = dynamic_cast<BlockCacheCpuImpl*>(cpu.get()))
+        {
+            blockCacheCpu->setIdleLoopDetectionEnabled(false);
+        }
+
+        counters.start();
+        const auto start = std::chrono::steady_clock::now();
+        runCpu(*cpu);
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        const auto hostEvents = counters.stop();
+        return { elapsed.count(), hostEvents };
+    }
+
+    // Instruction count does not depend on backend, it is taken by stepping interpreter.
+    // Opcodes it executed are copied into opcodeStats when it is not null.
+    template <typename TRun>
+    u64 countInstructions(const std::vector<RomFile>& roms, TRun runCpu, OpcodeStats* opcodeStats = nullptr)
+    {
+        auto bus = std::make_shared<BusImpl>();
+        for (const auto& rom : roms)
+        {
+            bus->loadIntoMemory(rom.addr, rom.data);
+        }
+        CpuImpl cpu(bus);
+        u64 instructions = 0;
+        runCpu(cpu, [&instructions](CpuImpl& steppedCpu, u32 cycles)
+        {
+            // Budget of one cycle runs exactly one instruction
+            const u64 target = steppedCpu.getCycles() + cycles;
+            while (steppedCpu.getCycles() < target)
+            {
+                // Halted cpu waits one cycle, or takes interrupt which wakes it
+                instructions += steppedCpu.isHalted() ? 0 : 1;
+                steppedCpu.run(1);
+            }
+        });
+        if (opcodeStats != nullptr)
+        {
+            *opcodeStats = cpu.getOpcodeStats();
+        }
+        return instructions;
+    }
+
+    Result runBenchmark(PerfCounters& counters, const std::string& name, const char* kind, const CpuBackend& backend, bool lazyFlags, unsigned repetitions,
+                        u64 instructions, u64 cycles, const std::vector<RomFile>& roms,
+                        const std::function<void(CpuImpl&)>& runCpu)
+    {
+        std::vector<Sample> samples;
+        for (unsigned i = 0; i < repetitions; i++)
+        {
+            samples.push_back(measure(counters, backend, lazyFlags, roms, runCpu));
+        }
+        std::sort(samples.begin(), samples.end(), [](const Sample& lhs, const Sample& rhs) { return lhs.seconds < rhs.seconds; });
+        const auto& best = samples.front();
+        return { name, kind, backend.name, instructions, cycles, best.seconds, samples[samples.size() / 2].seconds, best.hostEvents };
+    }
+
+    void writeHostEvents(std::ostream& out, const PerfCounters& counters, const Result& result)
+    {
+        for (std::size_t index = 0; index < result.hostEvents.size(); index++)
+        {
+            const auto event = static_cast<HostEvent>(index);
+            out << ", \"" << PerfCounters::getEventName(event) << "\": ";
+            if (counters.isAvailable(event))
+            {
+                out << result.hostEvents[index];
+            }
+            else
+            {
+                out << "null";
+            }
+        }
+
+        const std::pair<HostEvent, const char*> ratios[] = {
+            { HostEvent::INSTRUCTIONS, "host_instructions_per_instruction" },
+            { HostEvent::BRANCH_MISSES, "branch_misses_per_instruction" },
+            { HostEvent::L1_ICACHE_MISSES, "l1_icache_misses_per_instruction" }
+        };
+        for (const auto& ratio : ratios)
+        {
+            out << ", \"" << ratio.second << "\": ";
+            if (counters.isAvailable(ratio.first))
+            {
+                out << static_cast<double>(result.hostEvents[static_cast<std::size_t>(ratio.first)]) / result.instructions;
+            }
+            else
+            {
+                out << "null";
+            }
+        }
+    }
+
+    void writeJson(std::ostream& out, const std::vector<Result>& results, const PerfCounters& counters, bool lazyFlags, unsigned repetitions, unsigned frames)
+    {
+        out << "{\n";
+        out << "  \"lazy_flags\": " << (lazyFlags ? "true" : "false") << ",\n";
+        out << "  \"repetitions\": " << repetitions << ",\n";
+        out << "  \"frames\": " << frames << ",\n";
+        out << "  \"host_counters_error\": ";
+        if (counters.getError().empty())
+        {
+            out << "null,\n";
+        }
+        else
+        {
+            out << "\"" << counters.getError() << "\",\n";
+        }
+        out << "  \"benchmarks\": [\n";
+        for (std::size_t i = 0; i < results.size(); i++)
+        {
+            const auto& result = results[i];
+            out << "    { \"name\": \"" << result.name << "\", \"kind\": \"" << result.kind << "\", \"backend\": \"" << result.backend << "\""
+                << ", \"instructions\": " << result.instructions << ", \"cycles\": " << result.cycles
+                << ", \"best_seconds\": " << result.bestSeconds << ", \"median_seconds\": " << result.medianSeconds
+                << ", \"mips\": " << result.instructions / result.bestSeconds / 1e6
+                << ", \"mhz\": " << result.cycles / result.bestSeconds / 1e6
+                << ", \"ns_per_instruction\": " << result.bestSeconds * 1e9 / result.instructions;
+            writeHostEvents(out, counters, result);
+            out << " }" << (i + 1 < results.size() ? ",\n" : "\n");
+        }
+        out << "  ]\n";
+        out << "}\n";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::vector<const CpuBackend*> backends;
+    bool lazyFlags = false;
+    unsigned repetitions = 5;
+    unsigned frames = 600;
+    std::string outputPath;
+    std::string opcodeStatsPath;
+    std::vector<RomFile> roms;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (argument == "--backend" && hasValue)
+        {
+            const std::string name = argv[++i];
+            const auto backend = ToolSupport::findBackend(name);
+            if (backend == nullptr)
+            {
+                std::cerr << "Unknown backend " << name << std::endl;
+                return 1;
+            }
+            backends.push_back(backend);
+        }
+        else if (argument == "--lazy-flags")
+        {
+            lazyFlags = true;
+        }
+        else if ((argument == "--repetitions" || argument == "--frames") && hasValue)
+        {
+            if (!ToolSupport::parseNumber(argv[++i], argument == "--repetitions" ? repetitions : frames) || repetitions == 0)
+            {
+                std::cerr << "Invalid value of " << argument << std::endl;
+                return 1;
+            }
+        }
+        else if (argument == "--output" && hasValue)
+        {
+            outputPath = argv[++i];
+        }
+        else if (argument == "--opcode-stats" && hasValue)
+        {
+            opcodeStatsPath = argv[++i];
+            if (!OpcodeStats::ENABLED)
+            {
+                std::cerr << "Built without OPCODE_STATS_ENABLED, opcode statistics will be empty" << std::endl;
+            }
+        }
+        else
+        {
+            RomFile rom;
+            std::string error;
+            if (!ToolSupport::loadRomFile(argument, rom, error))
+            {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+            roms.push_back(std::move(rom));
+        }
+    }
+    if (backends.empty())
+    {
+        for (const auto& backend : ToolSupport::getBackends())
+        {
+            backends.push_back(&backend);
+        }
+    }
+
+    PerfCounters counters;
+    if (!counters.isAnyAvailable())
+    {
+        std::cerr << "Host performance counters are not available (" << counters.getError() << "), only time is measured" << std::endl;
+    }
+
+    std::vector<Result> results;
+    for (const auto& benchmark : MICRO_BENCHMARKS)
+    {
+        const std::vector<RomFile> program = { { 0x0000, buildMicroProgram(benchmark) } };
+        const auto runLoop = [](CpuImpl& cpu, const std::function<void(CpuImpl&, u32)>& run)
+        {
+            run(cpu, static_cast<u32>(MICRO_BENCHMARK_CYCLES));
+        };
+        const auto instructions = countInstructions(program, runLoop);
+        for (const auto* backend : backends)
+        {
+            results.push_back(runBenchmark(counters, benchmark.name, "micro", *backend, lazyFlags, repetitions, instructions, MICRO_BENCHMARK_CYCLES,
+                program, [&runLoop](CpuImpl& cpu) { runLoop(cpu, [](CpuImpl& c, u32 cycles) { c.run(cycles); }); }));
+        }
+    }
+
+    if (!roms.empty())
+    {
+        // Attract mode with interrupts of both halves of every frame
+        const auto runFrames = [frames](CpuImpl& cpu, const std::function<void(CpuImpl&, u32)>& run)
+        {
+            for (unsigned frame = 0; frame < frames; frame++)
+            {
+                run(cpu, ToolSupport::CYCLES_PER_HALF_FRAME);
+                cpu.requestInterrupt(1);
+                run(cpu, ToolSupport::CYCLES_PER_HALF_FRAME);
+                cpu.requestInterrupt(2);
+            }
+        };
+        OpcodeStats opcodeStats;
+        const auto instructions = countInstructions(roms, runFrames, &opcodeStats);
+        const u64 cycles = static_cast<u64>(frames) * ToolSupport::CYCLES_PER_HALF_FRAME * 2;
+
+        for (const auto* backend : backends)
+        {
+            results.push_back(runBenchmark(counters, "attract_mode", "macro", *backend, lazyFlags, repetitions, instructions, cycles,
+                roms, [&runFrames](CpuImpl& cpu) { runFrames(cpu, [](CpuImpl& c, u32 cycles) { c.run(cycles); }); }));
+        }
+
+        if (!opcodeStatsPath.empty())
+        {
+            std::ofstream opcodeStatsOutput(opcodeStatsPath);
+            if (!opcodeStatsOutput)
+            {
+                std::cerr << "Cannot write " << opcodeStatsPath << std::endl;
+                return 1;
+            }
+            opcodeStats.writeJson(opcodeStatsOutput);
+        }
+    }
+
+    if (outputPath.empty())
+    {
+        writeJson(std::cout, results, counters, lazyFlags, repetitions, roms.empty() ? 0 : frames);
+        return 0;
+    }
+
+    std::ofstream output(outputPath);
+    if (!output)
+    {
+        std::cerr << "Cannot write " << outputPath << std::endl;
+        return 1;
+    }
+    writeJson(output, results, counters, lazyFlags, repetitions, roms.empty() ? 0 : frames);
+    return 0;
+}
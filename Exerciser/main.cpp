@@ -0,0 +1,193 @@
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+#include "..//Invaders/CpmBus.hpp"
+#include "..//Invaders/CpuImpl.hpp"
+#include "..//Invaders/InstructionTrace.hpp"
+#include "..//Invaders/ToolSupport.hpp"
+
+// Runs CP/M cpu test programs (TST8080.COM, CPUDIAG.COM, 8080PRE.COM, 8080EXM.COM)
+// to completion and reports whether they passed, with instructions per second
+// and emulated clock rate. 8080EXM takes about 23 billion cycles, which makes it
+// a throughput benchmark as well.
+//
+// Usage: Exerciser <backend> [options] <program.com>...
+//   backend             decoder, table, threaded, block, tiered or jit
+//   --lazy-flags        Enable lazy flag evaluation
+//   --no-count          Skip counting pass, instructions per second is not reported then
+//   --max-cycles <n>    Cycles after which program is stopped, 100 billion by default
+//   --trace <file>      Trace last instructions and write them into file when program
+//                       does not pass or crashes (read it with TraceDecoder). Tracing
+//                       runs every backend as interpreter.
+//
+// Instructions are counted by separate pass stepping interpreter one instruction at a time,
+// so timed run is not slowed down by counting.
+
+namespace
+{
+    constexpr u32 CYCLES_PER_BATCH = 1000000;
+    constexpr u64 DEFAULT_MAX_CYCLES = 100000000000ull;
+
+    struct ProgramResult
+    {
+        bool completed;  // Program returned to CP/M before cycle limit
+        u64 cycles;
+        double seconds;
+    };
+
+    std::unique_ptr<CpuImpl> prepareCpu(const CpuBackend& backend, bool lazyFlags, const std::vector<u8>& program, std::shared_ptr<CpmBus>& bus)
+    {
+        bus = std::make_shared<CpmBus>();
+        bus->loadProgram(program);
+        auto cpu = backend.create(bus);
+        cpu->setLazyFlagsEnabled(lazyFlags);
+        cpu->getRegisters().getPc() = CpmBus::TPA_START;
+        cpu->getRegisters().getSp() = CpmBus::BDOS_STUB;
+        return cpu;
+    }
+
+    ProgramResult runProgram(CpuImpl& cpu, u64 maxCycles)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        while (!cpu.isHalted() && cpu.getCycles() < maxCycles)
+        {
+            cpu.run(CYCLES_PER_BATCH);
+        }
+        const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+        // Halted time after warm boot is not a part of the program
+        const u64 cycles = cpu.getCycles() - cpu.getIdleStats().haltedCycles;
+        return { cpu.isHalted(), cycles, elapsed.count() };
+    }
+
+    u64 countInstructions(CpuImpl& cpu, u64 maxCycles)
+    {
+        u64 instructions = 0;
+        while (!cpu.isHalted() && cpu.getCycles() < maxCycles)
+        {
+            // Budget of one cycle runs exactly one instruction
+            cpu.run(1);
+            instructions++;
+        }
+        return instructions;
+    }
+
+    bool reportsFailure(std::string output)
+    {
+        std::transform(output.begin(), output.end(), output.begin(), [](unsigned char c) { return static_cast<char>(std::toupper(c)); });
+        return output.find("ERROR") != std::string::npos || output.find("FAIL") != std::string::npos;
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: Exerciser <" << ToolSupport::getBackendNames() << "> [--lazy-flags] [--no-count] [--max-cycles <n>] [--trace <file>] <program.com>..." << std::endl;
+        return 1;
+    }
+
+    const auto* backend = ToolSupport::findBackend(argv[1]);
+    if (backend == nullptr)
+    {
+        std::cerr << "Unknown backend " << argv[1] << std::endl;
+        return 1;
+    }
+
+    bool lazyFlags = false;
+    bool countEnabled = true;
+    u64 maxCycles = DEFAULT_MAX_CYCLES;
+    std::string tracePath;
+    std::vector<std::string> paths;
+    for (int i = 2; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        if (argument == "--lazy-flags")
+        {
+            lazyFlags = true;
+        }
+        else if (argument == "--no-count")
+        {
+            countEnabled = false;
+        }
+        else if (argument == "--max-cycles" && i + 1 < argc)
+        {
+            maxCycles = std::strtoull(argv[++i], nullptr, 0);
+        }
+        else if (argument == "--trace" && i + 1 < argc)
+        {
+            tracePath = argv[++i];
+        }
+        else
+        {
+            paths.push_back(argument);
+        }
+    }
+
+    bool allPassed = true;
+    for (const auto& path : paths)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            std::cerr << "Cannot open " << path << std::endl;
+            return 1;
+        }
+        const std::vector<u8> program((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+        if (program.empty() || program.size() > CpmBus::BDOS_STUB - CpmBus::TPA_START)
+        {
+            std::cerr << path << " is not a valid program" << std::endl;
+            return 1;
+        }
+
+        std::shared_ptr<CpmBus> bus;
+        auto cpu = prepareCpu(*backend, lazyFlags, program, bus);
+
+        InstructionTrace trace;
+        if (!tracePath.empty())
+        {
+            cpu->setTrace(&trace);
+            if (!trace.setCrashDumpPath(tracePath))
+            {
+                std::cerr << "Trace path is too long to dump trace on crash" << std::endl;
+            }
+        }
+
+        std::cout << "=== " << path << " on " << backend->name << std::endl;
+        bus->setConsole(&std::cout);
+        const auto result = runProgram(*cpu, maxCycles);
+        const bool passed = result.completed && !reportsFailure(bus->getConsoleOutput());
+        allPassed = allPassed && passed;
+
+        if (!tracePath.empty())
+        {
+            trace.setCrashDumpPath("");
+            if (!passed && !trace.writeToFile(tracePath.c_str()))
+            {
+                std::cerr << "Cannot write " << tracePath << std::endl;
+            }
+        }
+
+        std::cout << "\n=== " << path << ": " << (passed ? "PASSED" : (result.completed ? "FAILED" : "TIMED OUT"))
+                  << ", " << result.cycles << " cycles, " << result.seconds << " s, "
+                  << result.cycles / result.seconds / 1e6 << " MHz";
+        if (countEnabled)
+        {
+            // Table dispatched interpreter, count does not depend on backend
+            std::shared_ptr<CpmBus> countingBus;
+            auto countingCpu = prepareCpu(*ToolSupport::findBackend("table"), false, program, countingBus);
+            const auto instructions = countInstructions(*countingCpu, maxCycles);
+            std::cout << ", " << instructions << " instructions, " << instructions / result.seconds / 1e6 << " MIPS";
+        }
+        std::cout << std::endl;
+    }
+    return allPassed ? 0 : 2;
+}
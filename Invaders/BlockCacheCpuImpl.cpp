@@ -0,0 +1,472 @@
+#include <algorithm>
+#include <map>
+
+#include "BlockCacheCpuImpl.hpp"
+#include "Disassembler.hpp"
+
+BlockCacheCpuImpl::BlockCacheCpuImpl(const std::shared_ptr<Bus>& busPtr)
+    : CpuImpl(busPtr, DispatchMode::TABLE)
+    , blocks(busPtr->getAddressMask())
+    , retiredBlock()
+    , currentBlock(nullptr)
+    , currentBlockInvalidated(false)
+    , fusionEnabled(true)
+    , idleLoopDetectionEnabled(true)
+    , stats()
+{
+}
+
+void BlockCacheCpuImpl::executeInstruction(u8 opcode)
+{
+    // Instruction executed from outside may write into cached code as well
+    const auto write = OpcodeTraits::getMemoryWrite(opcode);
+    if (write == MemoryWrite::NONE)
+    {
+        CpuImpl::executeInstruction(opcode);
+        return;
+    }
+
+    u16 operand = 0;
+    if (write == MemoryWrite::IMMEDATE_BYTE || write == MemoryWrite::IMMEDATE_WORD)
+    {
+        const u16 pc = registers.getPc();
+        operand = bus->fetchWordFromMemory(pc);
+    }
+    const auto addr = resolveWriteAddress(write, operand);
+
+    CpuImpl::executeInstruction(opcode);
+    invalidateWrittenMemory(addr, write);
+}
+
+void BlockCacheCpuImpl::invalidateBlocks(u16 addr, u16 length)
+{
+    for (u16 offset = 0; offset < length; offset++)
+    {
+        invalidateAddress(addr + offset);
+    }
+}
+
+void BlockCacheCpuImpl::invalidateAllBlocks()
+{
+    blocks.clear([this](std::unique_ptr<BasicBlock> block) { retireBlock(std::move(block)); });
+}
+
+bool BlockCacheCpuImpl::predecodeBlocks(const ReachableCodeMap& map)
+{
+    if (!map.matchesMemory(*bus))
+    {
+        return false;
+    }
+
+    for (auto pc : map.getBlocks())
+    {
+        // Blocks longer than MAX_BLOCK_INSTRUCTIONS continue in the next decoded block
+        while (!isBlockCached(pc))
+        {
+            const auto& block = decodeBlock(pc);
+            const auto& last = block.ops.back();
+            if (OpcodeTraits::endsBasicBlock(last.opcode))
+            {
+                break;
+            }
+            pc = last.nextPc;
+        }
+    }
+    return true;
+}
+
+const BlockCacheStats& BlockCacheCpuImpl::getBlockCacheStats() const
+{
+    return stats;
+}
+
+void BlockCacheCpuImpl::resetBlockCacheStats()
+{
+    stats = BlockCacheStats();
+
+    const auto entries = blocks.getEntries();
+    for (unsigned pc = 0; pc < 0x10000; pc++)
+    {
+        if (entries[pc] != nullptr)
+        {
+            entries[pc]->executions = 0;
+        }
+    }
+}
+
+std::size_t BlockCacheCpuImpl::getCachedBlockCount() const
+{
+    return blocks.getBlockCount();
+}
+
+bool BlockCacheCpuImpl::isFusionEnabled() const
+{
+    return fusionEnabled;
+}
+
+void BlockCacheCpuImpl::setFusionEnabled(bool enabled)
+{
+    // Blocks are decoded again, so they are not counted as invalidated
+    fusionEnabled = enabled;
+    blocks.clear([](std::unique_ptr<BasicBlock>) {});
+}
+
+std::vector<SequenceCount> BlockCacheCpuImpl::getSequenceProfile(unsigned length) const
+{
+    std::map<std::vector<u8>, u64> counts;
+    const auto entries = blocks.getEntries();
+    for (unsigned pc = 0; pc < 0x10000; pc++)
+    {
+        const auto* block = entries[pc];
+        if (block == nullptr || block->executions == 0 || block->ops.size() < length)
+        {
+            continue;
+        }
+
+        for (std::size_t i = 0; i + length <= block->ops.size(); i++)
+        {
+            std::vector<u8> opcodes;
+            for (std::size_t j = i; j < i + length; j++)
+            {
+                opcodes.push_back(block->ops[j].opcode);
+            }
+            counts[opcodes] += block->executions;
+        }
+    }
+
+    std::vector<SequenceCount> profile;
+    for (auto& count : counts)
+    {
+        profile.push_back({ count.first, count.second });
+    }
+    std::stable_sort(profile.begin(), profile.end(),
+        [](const SequenceCount& a, const SequenceCount& b) { return a.executions > b.executions; });
+    return profile;
+}
+
+void BlockCacheCpuImpl::writeSequenceReport(std::ostream& out, std::size_t count) const
+{
+    const auto& patterns = getFusionPatterns();
+    for (unsigned length = 2; length <= 4; length++)
+    {
+        const auto profile = getSequenceProfile(length);
+        u64 total = 0;
+        for (const auto& sequence : profile)
+        {
+            total += sequence.executions;
+        }
+
+        out << "Sequences of " << length << " instructions (" << total << " executed)\n";
+        for (std::size_t i = 0; i < profile.size() && i < count; i++)
+        {
+            const auto& sequence = profile[i];
+            std::string text;
+            for (auto opcode : sequence.opcodes)
+            {
+                text += (text.empty() ? "" : "; ") + Disassembler::getMnemonic(opcode);
+            }
+
+            const bool fused = std::any_of(patterns.begin(), patterns.end(),
+                [&sequence](const FusionPattern& pattern) { return pattern.opcodes == sequence.opcodes; });
+
+            out << "  " << sequence.executions << "  "
+                << (100.0 * sequence.executions / total) << "%  "
+                << text << (fused ? "  (fused)" : "") << "\n";
+        }
+    }
+}
+
+bool BlockCacheCpuImpl::isIdleLoopDetectionEnabled() const
+{
+    return idleLoopDetectionEnabled;
+}
+
+void BlockCacheCpuImpl::setIdleLoopDetectionEnabled(bool enabled)
+{
+    idleLoopDetectionEnabled = enabled;
+}
+
+void BlockCacheCpuImpl::runUntilTarget()
+{
+    while (cycles < cycleTarget)
+    {
+        executeBlockAt(registers.getPc());
+    }
+}
+
+bool BlockCacheCpuImpl::isBlockCached(u16 pc) const
+{
+    return blocks.find(pc) != nullptr;
+}
+
+void BlockCacheCpuImpl::executeBlockAt(u16 pc)
+{
+    executeBlock(findBlock(pc));
+    retiredBlock.reset();
+}
+
+void BlockCacheCpuImpl::onBlockInvalidated(u16)
+{
+}
+
+BlockCacheCpuImpl::BasicBlock& BlockCacheCpuImpl::findBlock(u16 pc)
+{
+    auto* block = blocks.find(pc);
+    if (block != nullptr)
+    {
+        stats.hits++;
+        return *block;
+    }
+
+    stats.misses++;
+    return decodeBlock(pc);
+}
+
+BlockCacheCpuImpl::BasicBlock& BlockCacheCpuImpl::decodeBlock(u16 pc)
+{
+    auto block = std::make_unique<BasicBlock>();
+    block->startPc = pc;
+    block->length = 0;
+    block->executions = 0;
+
+    u16 addr = pc;
+    u8 opcode;
+    do
+    {
+        const u32 window = bus->fetchInstructionWindow(addr);
+        opcode = window & 0xFF;
+        const auto length = lengthTable[opcode];
+
+        u16 operand = 0;
+        if (length == 2)
+            operand = (window >> 8) & 0xFF;
+        else if (length == 3)
+            operand = window >> 8;
+
+        addr += length;
+        block->length += length;
+        block->ops.push_back({ operandDispatchTable[opcode], operand, addr, cycleTable[opcode], opcode, OpcodeTraits::getMemoryWrite(opcode), nullptr });
+    }
+    while (!OpcodeTraits::endsBasicBlock(opcode) && block->ops.size() < MAX_BLOCK_INSTRUCTIONS);
+
+    if (fusionEnabled)
+    {
+        fuseBlock(*block);
+    }
+    block->pollingLoop = isPollingLoop(*block);
+    return blocks.insert(std::move(block));
+}
+
+void BlockCacheCpuImpl::executeBlock(BasicBlock& block)
+{
+    // Cycle target is checked after every instruction, so batches end
+    // at exactly the same instruction as in other execution modes
+
+    currentBlock = &block;
+    currentBlockInvalidated = false;
+    block.executions++;
+
+    const bool pollingLoop = block.pollingLoop && idleLoopDetectionEnabled;
+    const u64 cyclesBefore = cycles;
+    RegisterSnapshot registersBefore = {};
+    if (pollingLoop)
+    {
+        registersBefore = takeRegisterSnapshot();
+    }
+
+    auto& pc = registers.getPc();
+    auto op = block.ops.begin();
+    const auto end = block.ops.end();
+    do
+    {
+        if (op->fusion != nullptr && canExecuteFused(*op))
+        {
+            const auto& fusion = *op->fusion;
+            (this->*fusion.handler)(&*op);
+            cycles += fusion.cycles;
+            stats.fusedSequences[static_cast<std::size_t>(fusion.sequence)]++;
+            op += fusion.opcodes.size();
+            continue;
+        }
+
+        pc = op->nextPc;
+        if (op->write == MemoryWrite::NONE)
+        {
+            (this->*op->handler)(op->operand);
+            cycles += op->cycles;
+        }
+        else
+        {
+            const auto addr = resolveWriteAddress(op->write, op->operand);
+            (this->*op->handler)(op->operand);
+            cycles += op->cycles;
+
+            invalidateWrittenMemory(addr, op->write);
+            if (currentBlockInvalidated)
+                break;
+        }
+        ++op;
+    }
+    while (op != end && cycles < cycleTarget);
+
+    currentBlock = nullptr;
+
+    if (pollingLoop && pc == block.startPc && takeRegisterSnapshot() == registersBefore)
+    {
+        skipIdleIterations(cycles - cyclesBefore);
+    }
+}
+
+bool BlockCacheCpuImpl::isPollingLoop(const BasicBlock& block)
+{
+    const auto& last = block.ops.back();
+    const auto x = OpcodeTraits::getX(last.opcode);
+    const auto y = OpcodeTraits::getY(last.opcode);
+    const auto z = OpcodeTraits::getZ(last.opcode);
+    const bool jump = x == 3 && (z == 2 || (z == 3 && y < 2));
+    if (!jump || last.operand != block.startPc)
+    {
+        return false;
+    }
+
+    return std::all_of(block.ops.begin(), block.ops.end(), [](const MicroOp& op)
+    {
+        const auto x = OpcodeTraits::getX(op.opcode);
+        const auto y = OpcodeTraits::getY(op.opcode);
+        const auto z = OpcodeTraits::getZ(op.opcode);
+        // OUT, IN, DI, EI
+        const bool sideEffects = x == 3 && z == 3 && y >= 2 && y != 4 && y != 5;
+        return op.write == MemoryWrite::NONE && !sideEffects;
+    });
+}
+
+BlockCacheCpuImpl::RegisterSnapshot BlockCacheCpuImpl::takeRegisterSnapshot()
+{
+    materializeFlags();
+    return { registers.getAf().getRaw(), registers.getBc().getRaw(), registers.getDe().getRaw(),
+             registers.getHl().getRaw(), registers.getSp() };
+}
+
+template <u8... opcodes>
+BlockCacheCpuImpl::FusionPattern BlockCacheCpuImpl::makeFusionPattern(FusedSequence sequence, int writeIndex)
+{
+    const unsigned cycles = (OpcodeTraits::getCycles(opcodes) + ...);
+    return { { opcodes... }, sequence, &BlockCacheCpuImpl::executeFused<opcodes...>, cycles, writeIndex };
+}
+
+template <u8... registers>
+void BlockCacheCpuImpl::addDecrementJumps(std::vector<FusionPattern>& patterns)
+{
+    // DCR r; JNZ
+    (patterns.push_back(makeFusionPattern<registers, 0xC2>(FusedSequence::DECREMENT_JUMP, -1)), ...);
+}
+
+template <u8 pair, u8... registers>
+void BlockCacheCpuImpl::addIncrementDecrementJumps(std::vector<FusionPattern>& patterns)
+{
+    // INX rp; DCR r; JNZ
+    (patterns.push_back(makeFusionPattern<pair, registers, 0xC2>(FusedSequence::INCREMENT_DECREMENT_JUMP, -1)), ...);
+}
+
+template <u8... opcodes>
+void BlockCacheCpuImpl::executeFused(const MicroOp* ops)
+{
+    // Same handlers as used for single instructions, with PC set before each of them
+    auto& pc = registers.getPc();
+    ((pc = ops->nextPc, executeOpcodeWithOperand<opcodes>(ops->operand), ++ops), ...);
+}
+
+const std::vector<BlockCacheCpuImpl::FusionPattern>& BlockCacheCpuImpl::getFusionPatterns()
+{
+    // Longer patterns go first, so they win when sequences overlap.
+    // Decrements of M are left out, as they write into memory.
+    static const std::vector<FusionPattern> patterns = []()
+    {
+        std::vector<FusionPattern> result = {
+            makeFusionPattern<0x1A, 0x77, 0x23, 0x13>(FusedSequence::COPY_BYTE, 1),
+            makeFusionPattern<0x0A, 0x77, 0x23, 0x03>(FusedSequence::COPY_BYTE, 1),
+            makeFusionPattern<0x7E, 0xE6, 0xCA>(FusedSequence::TEST_MEMORY_JUMP, -1),
+            makeFusionPattern<0x7E, 0xE6, 0xC2>(FusedSequence::TEST_MEMORY_JUMP, -1)
+        };
+        addIncrementDecrementJumps<0x03, 0x05, 0x0D, 0x15, 0x1D, 0x25, 0x2D, 0x3D>(result);
+        addIncrementDecrementJumps<0x13, 0x05, 0x0D, 0x15, 0x1D, 0x25, 0x2D, 0x3D>(result);
+        addIncrementDecrementJumps<0x23, 0x05, 0x0D, 0x15, 0x1D, 0x25, 0x2D, 0x3D>(result);
+        addIncrementDecrementJumps<0x33, 0x05, 0x0D, 0x15, 0x1D, 0x25, 0x2D, 0x3D>(result);
+        addDecrementJumps<0x05, 0x0D, 0x15, 0x1D, 0x25, 0x2D, 0x3D>(result);
+        return result;
+    }();
+    return patterns;
+}
+
+void BlockCacheCpuImpl::fuseBlock(BasicBlock& block) const
+{
+    const auto& patterns = getFusionPatterns();
+    auto& ops = block.ops;
+    for (std::size_t i = 0; i < ops.size(); i++)
+    {
+        for (const auto& pattern : patterns)
+        {
+            const auto length = pattern.opcodes.size();
+            if (i + length > ops.size())
+                continue;
+
+            bool matches = true;
+            for (std::size_t j = 0; j < length && matches; j++)
+            {
+                matches = ops[i + j].opcode == pattern.opcodes[j];
+            }
+            if (matches)
+            {
+                ops[i].fusion = &pattern;
+                break;
+            }
+        }
+    }
+}
+
+bool BlockCacheCpuImpl::canExecuteFused(const MicroOp& op)
+{
+    const auto& fusion = *op.fusion;
+    if (cycles + fusion.cycles > cycleTarget)
+    {
+        return false;
+    }
+    if (fusion.writeIndex < 0)
+    {
+        return true;
+    }
+
+    // Writes into pages holding code go through single instructions, which handle invalidation
+    const auto& writer = (&op)[fusion.writeIndex];
+    return !blocks.mayContainCode(resolveWriteAddress(writer.write, writer.operand));
+}
+
+void BlockCacheCpuImpl::invalidateWrittenMemory(u16 addr, MemoryWrite write)
+{
+    const auto length = OpcodeTraits::getMemoryWriteLength(write);
+    for (unsigned offset = 0; offset < length; offset++)
+    {
+        const u16 writtenAddr = addr + offset;
+        if (blocks.mayContainCode(writtenAddr))
+        {
+            invalidateAddress(writtenAddr);
+        }
+    }
+}
+
+void BlockCacheCpuImpl::invalidateAddress(u16 addr)
+{
+    blocks.invalidate(addr, [this](std::unique_ptr<BasicBlock> block) { retireBlock(std::move(block)); });
+}
+
+void BlockCacheCpuImpl::retireBlock(std::unique_ptr<BasicBlock> block)
+{
+    stats.invalidations++;
+    onBlockInvalidated(block->startPc);
+    if (block.get() == currentBlock)
+    {
+        // Block being executed is kept alive until it finishes
+        currentBlockInvalidated = true;
+        retiredBlock = std::move(block);
+    }
+}
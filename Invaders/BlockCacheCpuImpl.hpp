@@ -0,0 +1,183 @@
+#pragma once
+
+#include <array>
+#include <ostream>
+#include <vector>
+
+#include "CodeBlockMap.hpp"
+#include "CpuImpl.hpp"
+#include "ReachableCodeMap.hpp"
+
+// Common instruction sequences executed by single fused handler
+enum class FusedSequence
+{
+    DECREMENT_JUMP = 0,            // DCR r; JNZ
+    INCREMENT_DECREMENT_JUMP = 1,  // INX rp; DCR r; JNZ
+    COPY_BYTE = 2,                 // LDAX rp; MOV M,A; INX H; INX rp
+    TEST_MEMORY_JUMP = 3,          // MOV A,M; ANI; JZ/JNZ
+    COUNT = 4
+};
+
+struct BlockCacheStats
+{
+    u64 hits;           // Blocks found in cache
+    u64 misses;         // Blocks which had to be decoded
+    u64 invalidations;  // Blocks dropped because memory they were decoded from was written
+    // Executions of fused sequences, indexed by FusedSequence
+    std::array<u64, static_cast<std::size_t>(FusedSequence::COUNT)> fusedSequences;
+};
+
+struct SequenceCount
+{
+    std::vector<u8> opcodes;
+    u64 executions;
+};
+
+// Interpreter decoding guest code into basic blocks of predecoded instructions,
+// which are cached by their start address and executed without fetching
+// and decoding opcodes again.
+//
+// Decoder fuses common instruction sequences, which are then executed by single
+// handler. Fused handler runs only when the whole sequence fits into cycle budget
+// and does not write into memory holding code, otherwise instructions are executed
+// one by one, so behaviour is exactly the same as without fusion.
+//
+// Blocks jumping back to their own start, which neither write memory nor access
+// ports, are polling loops. When iteration of such loop leaves registers unchanged,
+// nothing will change until an interrupt arrives, so the rest of batch is skipped
+// (see getIdleStats()).
+//
+// Writes made by the cpu itself invalidate cached blocks covering written memory.
+// Anything else writing into memory holding code has to call invalidateBlocks().
+class BlockCacheCpuImpl : public CpuImpl
+{
+    public:
+        // Maximal number of instructions decoded into single block
+        static constexpr unsigned MAX_BLOCK_INSTRUCTIONS = 32;
+
+        BlockCacheCpuImpl(const std::shared_ptr<Bus>& busPtr);
+
+        ~BlockCacheCpuImpl() = default;
+
+        void executeInstruction(u8 opcode) override;
+
+        // Drops cached blocks containing any byte of given memory range
+        void invalidateBlocks(u16 addr, u16 length);
+
+        void invalidateAllBlocks();
+
+        // Decodes blocks of code map ahead of time, so they are already cached when
+        // first executed. Decodes nothing and returns false when memory does not hold
+        // the image map was made from. Not counted in statistics.
+        bool predecodeBlocks(const ReachableCodeMap& map);
+
+        const BlockCacheStats& getBlockCacheStats() const;
+
+        void resetBlockCacheStats();
+
+        std::size_t getCachedBlockCount() const;
+
+        // Enabled by default. Changing it drops all cached blocks.
+        bool isFusionEnabled() const;
+
+        void setFusionEnabled(bool enabled);
+
+        // Instruction sequences of given length executed inside cached blocks, most
+        // frequent first. Counted from number of times every block was entered, so
+        // sequences after the point where block was left early are overcounted.
+        // Reset together with statistics.
+        std::vector<SequenceCount> getSequenceProfile(unsigned length) const;
+
+        // Writes given number of most frequent sequences of 2 to 4 instructions,
+        // marking those which are fused
+        void writeSequenceReport(std::ostream& out, std::size_t count) const;
+
+        // Enabled by default
+        bool isIdleLoopDetectionEnabled() const;
+
+        void setIdleLoopDetectionEnabled(bool enabled);
+
+    protected:
+        void runUntilTarget() override;
+
+        bool isBlockCached(u16 pc) const;
+
+        // Executes block starting at given address, decoding it when it is not cached
+        void executeBlockAt(u16 pc);
+
+        // Called for every cached block dropped because memory it was decoded from was written
+        virtual void onBlockInvalidated(u16 startPc);
+
+    private:
+        struct MicroOp;
+
+        // Handler of fused sequence, gets first of its instructions
+        using FusedHandler = void (BlockCacheCpuImpl::*)(const MicroOp* ops);
+
+        struct FusionPattern
+        {
+            std::vector<u8> opcodes;
+            FusedSequence sequence;
+            FusedHandler handler;
+            unsigned cycles;
+            // Instruction writing into memory, its address has to be resolvable
+            // before the sequence starts. -1 when sequence does not write.
+            int writeIndex;
+        };
+
+        struct MicroOp
+        {
+            OperandHandler handler;
+            u16 operand;
+            u16 nextPc;
+            u8 cycles;
+            u8 opcode;
+            MemoryWrite write;
+            // Sequence starting at this instruction, nullptr if none
+            const FusionPattern* fusion;
+        };
+
+        struct BasicBlock
+        {
+            u16 startPc;
+            u16 length;
+            u64 executions;
+            bool pollingLoop;
+            std::vector<MicroOp> ops;
+        };
+
+        using RegisterSnapshot = std::array<u16, 5>;
+
+        static const std::vector<FusionPattern>& getFusionPatterns();
+        template <u8... opcodes>
+        static FusionPattern makeFusionPattern(FusedSequence sequence, int writeIndex);
+        template <u8... registers>
+        static void addDecrementJumps(std::vector<FusionPattern>& patterns);
+        template <u8 pair, u8... registers>
+        static void addIncrementDecrementJumps(std::vector<FusionPattern>& patterns);
+        template <u8... opcodes>
+        void executeFused(const MicroOp* ops);
+
+        void fuseBlock(BasicBlock& block) const;
+        bool canExecuteFused(const MicroOp& op);
+
+        static bool isPollingLoop(const BasicBlock& block);
+        RegisterSnapshot takeRegisterSnapshot();
+
+        BasicBlock& findBlock(u16 pc);
+        BasicBlock& decodeBlock(u16 pc);
+        void executeBlock(BasicBlock& block);
+
+        void invalidateWrittenMemory(u16 addr, MemoryWrite write);
+        void invalidateAddress(u16 addr);
+        void retireBlock(std::unique_ptr<BasicBlock> block);
+
+        CodeBlockMap<BasicBlock> blocks;
+        // Block invalidated while it was being executed
+        std::unique_ptr<BasicBlock> retiredBlock;
+        const BasicBlock* currentBlock;
+        bool currentBlockInvalidated;
+        bool fusionEnabled;
+        bool idleLoopDetectionEnabled;
+        BlockCacheStats stats;
+};
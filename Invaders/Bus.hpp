@@ -2,6 +2,14 @@
 
 #include "Types.hpp"
 
+// How instruction uses its M operand
+enum class OperandAccess
+{
+    READ = 1,        // MOV r,M and arithmetic with M
+    WRITE = 2,       // MOV M,r and MVI M
+    READ_WRITE = 3   // INR M and DCR M
+};
+
 class Bus
 {
     public:
@@ -16,4 +24,68 @@ class Bus
         virtual void writeIntoOutputPort(u8 port, u8 value) = 0;
 
         virtual u8& getMemoryLocationRef(u16 addr) = 0;
+
+        // Addresses equal in bits of the mask reach the same memory, the rest are
+        // mirrors of it. Power of two minus one, at least 0xFF.
+        virtual u16 getAddressMask() const
+        {
+            return 0xFFFF;
+        }
+
+        // Reference to M operand, which bus decorators can count by direction
+        // this way. Default implementation is the plain reference.
+        virtual u8& getOperandLocationRef(u16 addr, OperandAccess)
+        {
+            return getMemoryLocationRef(addr);
+        }
+
+        // Wide accessors save a virtual call per byte. Words are little endian,
+        // and address of their second byte wraps from 0xFFFF to 0x0000.
+        // Default implementations go through single byte accessors.
+
+        virtual u16 readWordFromMemory(u16 addr) const
+        {
+            return readFromMemory(addr) | (readFromMemory(static_cast<u16>(addr + 1)) << 8);
+        }
+
+        virtual void writeWordIntoMemory(u16 addr, u16 value)
+        {
+            writeIntoMemory(addr, value & 0xFF);
+            writeIntoMemory(static_cast<u16>(addr + 1), value >> 8);
+        }
+
+        // Reads of opcodes and their operands, which bus decorators can tell from
+        // data reads this way. Default implementations are the data accessors.
+
+        virtual u8 fetchFromMemory(u16 addr) const
+        {
+            return readFromMemory(addr);
+        }
+
+        virtual u16 fetchWordFromMemory(u16 addr) const
+        {
+            return readWordFromMemory(addr);
+        }
+
+        // Three bytes starting at given address, first one in the lowest byte.
+        // Used to fetch opcode together with its operands in one call.
+        virtual u32 fetchInstructionWindow(u16 addr) const
+        {
+            return readFromMemory(addr)
+                | (readFromMemory(static_cast<u16>(addr + 1)) << 8)
+                | (static_cast<u32>(readFromMemory(static_cast<u16>(addr + 2))) << 16);
+        }
+
+        // Reads made by diagnostics (instruction traces, watchpoints) rather than
+        // by the program. Bus decorators pass them through without counting.
+
+        virtual u8 peekMemory(u16 addr) const
+        {
+            return readFromMemory(addr);
+        }
+
+        virtual u32 peekInstructionWindow(u16 addr) const
+        {
+            return fetchInstructionWindow(addr);
+        }
 };
\ No newline at end of file
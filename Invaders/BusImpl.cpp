@@ -1,11 +1,8 @@
 #include "BusImpl.hpp"
 
-u8 BusImpl::readFromMemory(u16 addr) const
-{
-    return u8();
-}
-
-void BusImpl::writeIntoMemory(u16 addr, u8 value)
+BusImpl::BusImpl()
+    : memory()
+    , temp(0)
 {
 }
 
@@ -18,7 +15,11 @@ void BusImpl::writeIntoOutputPort(u8 port, u8 value)
 {
 }
 
-u8& BusImpl::getMemoryLocationRef(u16 addr)
+void BusImpl::loadIntoMemory(u16 addr, const std::vector<u8>& data)
 {
-    return temp;
+    for (auto byte : data)
+    {
+        memory[addr & ADDRESS_MASK] = byte;
+        addr++;
+    }
 }
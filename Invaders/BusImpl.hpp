@@ -1,22 +1,92 @@
 #pragma once
 
+#include <array>
+#include <vector>
+
 #include "Bus.hpp"
 
-class BusImpl : public Bus
+// Space Invaders memory map:
+// 0x0000 - 0x1FFF ROM
+// 0x2000 - 0x23FF Work RAM
+// 0x2400 - 0x3FFF Video RAM
+// Addresses above 0x3FFF mirror the first 16 KiB.
+//
+// Memory accessors are defined inline, so cpu instantiated over BusImpl
+// (CpuCore<BusImpl>) can inline them into instruction handlers.
+class BusImpl final : public Bus
 {
     public:
+        static constexpr u16 ROM_SIZE = 0x2000;
+        static constexpr u16 ADDRESS_MASK = 0x3FFF;
+
+        BusImpl();
+
         ~BusImpl() = default;
 
-        u8 readFromMemory(u16 addr) const override;
+        u8 readFromMemory(u16 addr) const override
+        {
+            return memory[addr & ADDRESS_MASK];
+        }
+
+        void writeIntoMemory(u16 addr, u8 value) override
+        {
+            // Writes into ROM are ignored
+            addr &= ADDRESS_MASK;
+            if (addr >= ROM_SIZE)
+                memory[addr] = value;
+        }
+
+        u16 readWordFromMemory(u16 addr) const override
+        {
+            return memory[addr & ADDRESS_MASK] | (memory[(addr + 1) & ADDRESS_MASK] << 8);
+        }
 
-        void writeIntoMemory(u16 addr, u8 value) override;
+        void writeWordIntoMemory(u16 addr, u16 value) override
+        {
+            writeIntoMemory(addr, value & 0xFF);
+            writeIntoMemory(static_cast<u16>(addr + 1), value >> 8);
+        }
+
+        u8 fetchFromMemory(u16 addr) const override
+        {
+            return memory[addr & ADDRESS_MASK];
+        }
+
+        u16 fetchWordFromMemory(u16 addr) const override
+        {
+            return readWordFromMemory(addr);
+        }
+
+        u32 fetchInstructionWindow(u16 addr) const override
+        {
+            return memory[addr & ADDRESS_MASK]
+                | (memory[(addr + 1) & ADDRESS_MASK] << 8)
+                | (static_cast<u32>(memory[(addr + 2) & ADDRESS_MASK]) << 16);
+        }
 
         u8 readFromInputPort(u8 port) const override;
 
         void writeIntoOutputPort(u8 port, u8 value) override;
 
-        u8& getMemoryLocationRef(u16 addr) override;
+        u16 getAddressMask() const override
+        {
+            return ADDRESS_MASK;
+        }
+
+        u8& getMemoryLocationRef(u16 addr) override
+        {
+            // Reference to ROM points to scratch copy, so writes through it are lost
+            addr &= ADDRESS_MASK;
+            if (addr >= ROM_SIZE)
+                return memory[addr];
+            temp = memory[addr];
+            return temp;
+        }
+
+        // Copies data into memory starting at given address, ignoring ROM write protection
+        void loadIntoMemory(u16 addr, const std::vector<u8>& data);
 
     private:
+        std::array<u8, ADDRESS_MASK + 1> memory;
         u8 temp;
-};
\ No newline at end of file
+};
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <vector>
+
+#include "Types.hpp"
+
+// Owns blocks of translated guest code, indexed by their start address,
+// and finds blocks overlapping written memory.
+// TBlock has to provide u16 startPc and u16 length (in bytes) members.
+//
+// Address mask of the bus (see Bus::getAddressMask()) tells which addresses are
+// mirrors of the same memory. Blocks are indexed by pages of the memory they were
+// decoded from, so write through any mirror finds blocks decoded through the others.
+template <typename TBlock>
+class CodeBlockMap
+{
+    public:
+        CodeBlockMap(u16 mask = 0xFFFF)
+            : entries(0x10000, nullptr)
+            , pageBlocks()
+            , blockCount(0)
+            , addressMask(mask)
+        {
+        }
+
+        ~CodeBlockMap()
+        {
+            clear([](std::unique_ptr<TBlock>) {});
+        }
+
+        CodeBlockMap(const CodeBlockMap&) = delete;
+
+        CodeBlockMap& operator=(const CodeBlockMap&) = delete;
+
+        TBlock* find(u16 pc) const
+        {
+            return entries[pc];
+        }
+
+        // Table of 0x10000 block pointers indexed by start address, nullptr where there is no block
+        TBlock* const* getEntries() const
+        {
+            return entries.data();
+        }
+
+        std::size_t getBlockCount() const
+        {
+            return blockCount;
+        }
+
+        // Whether any block may overlap given address. Cheap check done before invalidate().
+        bool mayContainCode(u16 addr) const
+        {
+            return !pageBlocks[(addr & addressMask) >> 8].empty();
+        }
+
+        // Inserts block, replacing one which starts at the same address
+        TBlock& insert(std::unique_ptr<TBlock> block)
+        {
+            const u16 pc = block->startPc;
+            if (entries[pc] != nullptr)
+            {
+                remove(entries[pc]);
+            }
+
+            forEachPage(*block, [this, &block](unsigned page) { pageBlocks[page].push_back(block.get()); });
+            entries[pc] = block.release();
+            blockCount++;
+            return *entries[pc];
+        }
+
+        // Removes every block containing given address, handing its ownership to callback
+        template <typename TCallback>
+        void invalidate(u16 addr, TCallback onRemoved)
+        {
+            auto& page = pageBlocks[(addr & addressMask) >> 8];
+            for (std::size_t i = 0; i < page.size();)
+            {
+                auto* block = page[i];
+                if ((static_cast<u16>(addr - block->startPc) & addressMask) < block->length)
+                {
+                    // Removes block from this page, moving another one into its place
+                    onRemoved(remove(block));
+                }
+                else
+                {
+                    i++;
+                }
+            }
+        }
+
+        // Removes every block, handing its ownership to callback
+        template <typename TCallback>
+        void clear(TCallback onRemoved)
+        {
+            for (auto* block : entries)
+            {
+                if (block != nullptr)
+                {
+                    onRemoved(remove(block));
+                }
+            }
+        }
+
+    private:
+        template <typename TFunction>
+        void forEachPage(const TBlock& block, TFunction function) const
+        {
+            const unsigned firstPage = (block.startPc & addressMask) >> 8;
+            const unsigned lastPage = (static_cast<u16>(block.startPc + block.length - 1) & addressMask) >> 8;
+            function(firstPage);
+            if (lastPage != firstPage)
+            {
+                function(lastPage);
+            }
+        }
+
+        std::unique_ptr<TBlock> remove(TBlock* block)
+        {
+            forEachPage(*block, [this, block](unsigned pageIndex) {
+                auto& page = pageBlocks[pageIndex];
+                auto it = std::find(page.begin(), page.end(), block);
+                *it = page.back();
+                page.pop_back();
+            });
+
+            entries[block->startPc] = nullptr;
+            blockCount--;
+            return std::unique_ptr<TBlock>(block);
+        }
+
+        std::vector<TBlock*> entries;
+        // Blocks overlapping every 256 byte page of memory
+        std::array<std::vector<TBlock*>, 0x100> pageBlocks;
+        std::size_t blockCount;
+        u16 addressMask;
+};
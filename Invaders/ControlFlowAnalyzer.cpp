@@ -0,0 +1,511 @@
+#include "ControlFlowAnalyzer.hpp"
+
+#include <algorithm>
+#include <cstdio>
+
+#include "OpcodeTraits.hpp"
+
+namespace
+{
+    constexpr u8 LXI_D_OPCODE = 0x11;
+    constexpr u8 LXI_H_OPCODE = 0x21;
+    constexpr u8 PCHL_OPCODE = 0xE9;
+
+    // MOV r,M
+    constexpr bool isMemoryLoad(u8 opcode)
+    {
+        return OpcodeTraits::getX(opcode) == 1 && OpcodeTraits::getZ(opcode) == 6 && OpcodeTraits::getY(opcode) != 6;
+    }
+
+    const char* getExitName(BlockExit exit)
+    {
+        switch (exit)
+        {
+            case BlockExit::NEXT: return "next";
+            case BlockExit::JUMP: return "jump";
+            case BlockExit::CONDITIONAL_JUMP: return "conditional jump";
+            case BlockExit::CALL: return "call";
+            case BlockExit::RETURN: return "return";
+            case BlockExit::INDIRECT: return "indirect";
+            case BlockExit::HALT: return "halt";
+            default: return "truncated";
+        }
+    }
+}
+
+ControlFlowAnalyzer::ControlFlowAnalyzer(u16 origin, const std::vector<u8>& image)
+    : origin(origin)
+    , image(image)
+    , entryPoints()
+    , byteClasses()
+    , dataBytes()
+    , pendingLeaders()
+    , pendingJumps()
+    , fallThroughs()
+    , leaders()
+    , routines()
+    , blocks()
+    , jumpTables()
+    , unresolvedJumps()
+{
+}
+
+void ControlFlowAnalyzer::addEntryPoint(u16 addr)
+{
+    entryPoints.push_back(addr);
+}
+
+void ControlFlowAnalyzer::addRestartVectors()
+{
+    for (unsigned vector = 0; vector < 0x40; vector += 8)
+    {
+        if (contains(vector, 1))
+        {
+            addEntryPoint(vector);
+        }
+    }
+}
+
+void ControlFlowAnalyzer::analyze()
+{
+    byteClasses.assign(image.size(), ByteClass::UNKNOWN);
+    dataBytes.assign(image.size(), false);
+    pendingLeaders.clear();
+    pendingJumps.clear();
+    fallThroughs.clear();
+    leaders.clear();
+    routines.clear();
+    blocks.clear();
+    jumpTables.clear();
+    unresolvedJumps.clear();
+
+    for (auto entry : entryPoints)
+    {
+        addRoutine(entry);
+        addLeader(entry);
+    }
+
+    // Jump tables are resolved once direct control flow is followed, so more of the
+    // code which ends them is known
+    while (!pendingLeaders.empty() || !pendingJumps.empty())
+    {
+        while (!pendingLeaders.empty())
+        {
+            const u16 leader = pendingLeaders.back();
+            pendingLeaders.pop_back();
+            followCode(leader);
+        }
+        if (!pendingJumps.empty())
+        {
+            const u16 jumpAddr = pendingJumps.back();
+            pendingJumps.pop_back();
+            if (!resolveJumpTable(jumpAddr))
+            {
+                unresolvedJumps.push_back(jumpAddr);
+            }
+        }
+    }
+    std::sort(unresolvedJumps.begin(), unresolvedJumps.end());
+
+    buildBlocks();
+
+    for (std::size_t i = 0; i < image.size(); i++)
+    {
+        if (dataBytes[i] && byteClasses[i] == ByteClass::UNKNOWN)
+        {
+            byteClasses[i] = ByteClass::DATA;
+        }
+    }
+}
+
+const std::map<u16, CfgBlock>& ControlFlowAnalyzer::getBlocks() const
+{
+    return blocks;
+}
+
+const std::set<u16>& ControlFlowAnalyzer::getRoutines() const
+{
+    return routines;
+}
+
+const std::vector<JumpTable>& ControlFlowAnalyzer::getJumpTables() const
+{
+    return jumpTables;
+}
+
+const std::vector<u16>& ControlFlowAnalyzer::getUnresolvedJumps() const
+{
+    return unresolvedJumps;
+}
+
+ByteClass ControlFlowAnalyzer::getByteClass(u16 addr) const
+{
+    if (!contains(addr, 1) || byteClasses.empty())
+    {
+        return ByteClass::UNKNOWN;
+    }
+    return byteClasses[addr - origin];
+}
+
+std::size_t ControlFlowAnalyzer::getByteCount(ByteClass byteClass) const
+{
+    if (byteClasses.empty())
+    {
+        return byteClass == ByteClass::UNKNOWN ? image.size() : 0;
+    }
+    return static_cast<std::size_t>(std::count(byteClasses.begin(), byteClasses.end(), byteClass));
+}
+
+ReachableCodeMap ControlFlowAnalyzer::getCodeMap() const
+{
+    std::vector<u16> blockStarts;
+    for (const auto& block : blocks)
+    {
+        blockStarts.push_back(block.first);
+    }
+    return ReachableCodeMap(origin, image, blockStarts, std::vector<u16>(routines.begin(), routines.end()));
+}
+
+void ControlFlowAnalyzer::writeListing(std::ostream& out) const
+{
+    char line[64];
+    for (const auto& entry : blocks)
+    {
+        const auto& block = entry.second;
+        if (routines.count(block.start) != 0)
+        {
+            std::snprintf(line, sizeof(line), "routine %04X\n", block.start);
+            out << line;
+        }
+
+        std::snprintf(line, sizeof(line), "  block %04X-%04X %s", block.start,
+                      static_cast<u16>(block.start + block.length - 1), getExitName(block.exit));
+        out << line;
+        for (std::size_t i = 0; i < block.successors.size(); i++)
+        {
+            std::snprintf(line, sizeof(line), "%s%04X", i == 0 ? " -> " : " ", block.successors[i]);
+            out << line;
+        }
+        out << "\n";
+    }
+
+    for (const auto& table : jumpTables)
+    {
+        std::snprintf(line, sizeof(line), "jump table %04X of PCHL at %04X:", table.tableAddr, table.jumpAddr);
+        out << line;
+        for (auto target : table.targets)
+        {
+            std::snprintf(line, sizeof(line), " %04X", target);
+            out << line;
+        }
+        out << "\n";
+    }
+    for (auto jumpAddr : unresolvedJumps)
+    {
+        std::snprintf(line, sizeof(line), "unresolved PCHL at %04X\n", jumpAddr);
+        out << line;
+    }
+}
+
+bool ControlFlowAnalyzer::contains(u16 addr, unsigned length) const
+{
+    return addr >= origin && static_cast<std::size_t>(addr - origin) + length <= image.size();
+}
+
+u8 ControlFlowAnalyzer::readByte(u16 addr) const
+{
+    return image[addr - origin];
+}
+
+u16 ControlFlowAnalyzer::readWord(u16 addr) const
+{
+    return readByte(addr) | (readByte(addr + 1) << 8);
+}
+
+u16 ControlFlowAnalyzer::readOperand(u16 addr, unsigned length) const
+{
+    if (length == 2)
+        return readByte(addr + 1);
+    if (length == 3)
+        return readWord(addr + 1);
+    return 0;
+}
+
+void ControlFlowAnalyzer::addLeader(u16 addr)
+{
+    if (contains(addr, 1) && leaders.insert(addr).second)
+    {
+        pendingLeaders.push_back(addr);
+    }
+}
+
+void ControlFlowAnalyzer::addRoutine(u16 addr)
+{
+    if (contains(addr, 1))
+    {
+        routines.insert(addr);
+    }
+}
+
+void ControlFlowAnalyzer::followCode(u16 leader)
+{
+    u16 addr = leader;
+    u16 previous = leader;
+    while (contains(addr, 1))
+    {
+        if (addr != leader)
+        {
+            fallThroughs.emplace(addr, previous);
+        }
+        if (byteClasses[addr - origin] == ByteClass::OPCODE)
+        {
+            // Already followed from elsewhere, control merges here
+            if (addr != leader)
+            {
+                addLeader(addr);
+            }
+            return;
+        }
+
+        const u8 opcode = readByte(addr);
+        const auto length = OpcodeTraits::getLength(opcode);
+        if (!contains(addr, length))
+        {
+            return;
+        }
+
+        markInstruction(addr, length);
+
+        const u16 operand = readOperand(addr, length);
+        const u16 next = addr + length;
+        markDataReference(opcode, operand);
+
+        if (!OpcodeTraits::endsBasicBlock(opcode))
+        {
+            previous = addr;
+            addr = next;
+            continue;
+        }
+
+        const auto y = OpcodeTraits::getY(opcode);
+        const auto z = OpcodeTraits::getZ(opcode);
+        const auto q = OpcodeTraits::getQ(opcode);
+
+        if (OpcodeTraits::getX(opcode) == 1)
+        {
+            addLeader(next);                  // HLT
+        }
+        else if (z == 2 || (z == 3 && y < 2))
+        {
+            addLeader(operand);               // Jcc, JMP
+            if (z == 2)
+                addLeader(next);
+        }
+        else if (z == 4 || (z == 5 && q == 1))
+        {
+            addRoutine(operand);              // Ccc, CALL
+            addLeader(operand);
+            addLeader(next);
+        }
+        else if (z == 7)
+        {
+            addRoutine(y * 8);                // RST
+            addLeader(y * 8);
+            addLeader(next);
+        }
+        else if (z == 0)
+        {
+            addLeader(next);                  // Rcc
+        }
+        else if (opcode == PCHL_OPCODE)
+        {
+            pendingJumps.push_back(addr);
+        }
+        return;
+    }
+}
+
+void ControlFlowAnalyzer::markInstruction(u16 addr, unsigned length)
+{
+    byteClasses[addr - origin] = ByteClass::OPCODE;
+    for (unsigned i = 1; i < length; i++)
+    {
+        auto& byteClass = byteClasses[addr - origin + i];
+        if (byteClass == ByteClass::UNKNOWN)
+        {
+            byteClass = ByteClass::OPERAND;
+        }
+    }
+}
+
+void ControlFlowAnalyzer::markDataReference(u8 opcode, u16 operand)
+{
+    for (auto access : { OpcodeTraits::getMemoryRead(opcode), OpcodeTraits::getMemoryWrite(opcode) })
+    {
+        if (access != MemoryWrite::IMMEDATE_BYTE && access != MemoryWrite::IMMEDATE_WORD)
+        {
+            continue;
+        }
+        for (unsigned i = 0; i < OpcodeTraits::getMemoryWriteLength(access); i++)
+        {
+            const u16 addr = operand + i;
+            if (contains(addr, 1))
+            {
+                dataBytes[addr - origin] = true;
+            }
+        }
+    }
+}
+
+bool ControlFlowAnalyzer::resolveJumpTable(u16 jumpAddr)
+{
+    // Target has to be read through M twice after table address is loaded,
+    // e.g. LXI H,table; DAD D; MOV E,M; INX H; MOV D,M; XCHG; PCHL
+    unsigned memoryLoads = 0;
+    bool found = false;
+    u16 tableAddr = 0;
+    u16 addr = jumpAddr;
+    for (unsigned i = 0; i < MAX_DISPATCH_INSTRUCTIONS; i++)
+    {
+        const auto fallThrough = fallThroughs.find(addr);
+        if (fallThrough == fallThroughs.end())
+        {
+            break;
+        }
+        addr = fallThrough->second;
+
+        const u8 opcode = readByte(addr);
+        if (isMemoryLoad(opcode))
+        {
+            memoryLoads++;
+        }
+        else if (opcode == LXI_H_OPCODE || opcode == LXI_D_OPCODE)
+        {
+            found = memoryLoads >= 2;
+            tableAddr = readWord(addr + 1);
+            break;
+        }
+    }
+    if (!found)
+    {
+        return false;
+    }
+
+    JumpTable table = { jumpAddr, tableAddr, {} };
+    for (unsigned i = 0; i < MAX_JUMP_TABLE_ENTRIES; i++)
+    {
+        const u16 entry = tableAddr + 2 * i;
+        if (!contains(entry, 2)
+            || byteClasses[entry - origin] != ByteClass::UNKNOWN
+            || byteClasses[entry - origin + 1] != ByteClass::UNKNOWN)
+        {
+            break;
+        }
+        const u16 target = readWord(entry);
+        if (!contains(target, 1))
+        {
+            break;
+        }
+        table.targets.push_back(target);
+    }
+    if (table.targets.empty())
+    {
+        return false;
+    }
+
+    for (std::size_t i = 0; i < table.targets.size() * 2; i++)
+    {
+        dataBytes[tableAddr - origin + i] = true;
+    }
+    for (auto target : table.targets)
+    {
+        addRoutine(target);
+        addLeader(target);
+    }
+    jumpTables.push_back(std::move(table));
+    return true;
+}
+
+void ControlFlowAnalyzer::buildBlocks()
+{
+    for (auto leader : leaders)
+    {
+        // Leader which did not fit into image
+        if (byteClasses[leader - origin] != ByteClass::OPCODE)
+        {
+            continue;
+        }
+
+        CfgBlock block = { leader, 0, 0, BlockExit::TRUNCATED, {} };
+        u16 addr = leader;
+        while (true)
+        {
+            const u8 opcode = readByte(addr);
+            const auto length = OpcodeTraits::getLength(opcode);
+            const u16 operand = readOperand(addr, length);
+            const u16 next = addr + length;
+            block.length += length;
+            block.instructionCount++;
+
+            if (OpcodeTraits::endsBasicBlock(opcode))
+            {
+                const auto z = OpcodeTraits::getZ(opcode);
+
+                if (OpcodeTraits::getX(opcode) == 1)
+                {
+                    block.exit = BlockExit::HALT;
+                    block.successors = { next };
+                }
+                else if (z == 2)
+                {
+                    block.exit = BlockExit::CONDITIONAL_JUMP;
+                    block.successors = { operand, next };
+                }
+                else if (z == 3)
+                {
+                    block.exit = BlockExit::JUMP;
+                    block.successors = { operand };
+                }
+                else if (z == 4 || z == 5 || z == 7)
+                {
+                    block.exit = BlockExit::CALL;
+                    block.successors = { next };
+                }
+                else if (opcode != PCHL_OPCODE)
+                {
+                    block.exit = BlockExit::RETURN;
+                    if (z == 0)
+                        block.successors = { next };
+                }
+                else
+                {
+                    block.exit = BlockExit::INDIRECT;
+                    for (const auto& table : jumpTables)
+                    {
+                        if (table.jumpAddr == addr)
+                            block.successors = table.targets;
+                    }
+                }
+                break;
+            }
+
+            if (!contains(next, 1) || byteClasses[next - origin] != ByteClass::OPCODE)
+            {
+                break;
+            }
+            if (leaders.count(next) != 0)
+            {
+                block.exit = BlockExit::NEXT;
+                block.successors = { next };
+                break;
+            }
+            addr = next;
+        }
+
+        // Successors outside of image are not blocks
+        block.successors.erase(std::remove_if(block.successors.begin(), block.successors.end(),
+                                              [this](u16 successor) { return leaders.count(successor) == 0; }),
+                               block.successors.end());
+        blocks.emplace(leader, std::move(block));
+    }
+}
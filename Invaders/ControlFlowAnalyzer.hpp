@@ -0,0 +1,129 @@
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <set>
+#include <vector>
+
+#include "ReachableCodeMap.hpp"
+
+// What byte of image was found to be
+enum class ByteClass
+{
+    UNKNOWN = 0,   // Not reached by control flow nor referenced as data
+    OPCODE = 1,    // First byte of reachable instruction
+    OPERAND = 2,   // Operand of reachable instruction
+    DATA = 3       // Read or written by reachable instruction, or jump table
+};
+
+// How control leaves basic block
+enum class BlockExit
+{
+    NEXT = 0,              // Falls into block starting after it
+    JUMP = 1,              // JMP
+    CONDITIONAL_JUMP = 2,  // Jcc
+    CALL = 3,              // CALL, Ccc and RST, returning after the block
+    RETURN = 4,            // RET and Rcc
+    INDIRECT = 5,          // PCHL, successors are targets of its jump table if resolved
+    HALT = 6,              // HLT, continues after the block when interrupt handler returns
+    TRUNCATED = 7          // Last instruction does not fit into image
+};
+
+struct CfgBlock
+{
+    u16 start;
+    u16 length;                   // Bytes of all instructions
+    u16 instructionCount;
+    BlockExit exit;
+    std::vector<u16> successors;  // Blocks control may continue at, targets of calls not included
+};
+
+struct JumpTable
+{
+    u16 jumpAddr;                 // PCHL taking the jump
+    u16 tableAddr;
+    std::vector<u16> targets;
+};
+
+// Builds control-flow graph of ROM image by following 8080 instructions from
+// entry points, usually the reset and RST vectors.
+//
+// Indirect jumps can not be followed in general. PCHL is resolved only when
+// instructions running straight into it load table address with LXI H or LXI D
+// and then read the target through M, which is how 8080 code dispatches through
+// jump tables. Table entries are taken
+// until one points outside of image or runs into code, so tables followed by data
+// which looks like addresses may get extra targets.
+class ControlFlowAnalyzer
+{
+    public:
+        // Maximal number of entries taken from single jump table
+        static constexpr unsigned MAX_JUMP_TABLE_ENTRIES = 64;
+
+        // Maximal number of instructions before PCHL searched for table address
+        static constexpr unsigned MAX_DISPATCH_INSTRUCTIONS = 16;
+
+        ControlFlowAnalyzer(u16 origin, const std::vector<u8>& image);
+
+        ~ControlFlowAnalyzer() = default;
+
+        void addEntryPoint(u16 addr);
+
+        // Adds reset vector and all RST vectors which are inside image
+        void addRestartVectors();
+
+        void analyze();
+
+        // Basic blocks by start address
+        const std::map<u16, CfgBlock>& getBlocks() const;
+
+        // Entry points, targets of CALL, Ccc and RST and targets of resolved jump tables
+        const std::set<u16>& getRoutines() const;
+
+        const std::vector<JumpTable>& getJumpTables() const;
+
+        // PCHL instructions whose targets are not known, sorted
+        const std::vector<u16>& getUnresolvedJumps() const;
+
+        // UNKNOWN for addresses outside of image
+        ByteClass getByteClass(u16 addr) const;
+
+        std::size_t getByteCount(ByteClass byteClass) const;
+
+        ReachableCodeMap getCodeMap() const;
+
+        // Writes routines, blocks with their successors and jump tables as text
+        void writeListing(std::ostream& out) const;
+
+    private:
+        bool contains(u16 addr, unsigned length) const;
+        u8 readByte(u16 addr) const;
+        u16 readWord(u16 addr) const;
+        u16 readOperand(u16 addr, unsigned length) const;
+
+        void addLeader(u16 addr);
+        void addRoutine(u16 addr);
+        void followCode(u16 leader);
+        void markInstruction(u16 addr, unsigned length);
+        void markDataReference(u8 opcode, u16 operand);
+        bool resolveJumpTable(u16 jumpAddr);
+        void buildBlocks();
+
+        u16 origin;
+        std::vector<u8> image;
+        std::vector<u16> entryPoints;
+
+        std::vector<ByteClass> byteClasses;
+        // Data references are applied after code is known, so code always wins
+        std::vector<bool> dataBytes;
+        std::vector<u16> pendingLeaders;
+        std::vector<u16> pendingJumps;
+        // Instruction to instruction which falls through into it, for looking up
+        // how PCHL got its address
+        std::map<u16, u16> fallThroughs;
+        std::set<u16> leaders;
+        std::set<u16> routines;
+        std::map<u16, CfgBlock> blocks;
+        std::vector<JumpTable> jumpTables;
+        std::vector<u16> unresolvedJumps;
+};
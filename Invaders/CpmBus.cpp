@@ -0,0 +1,97 @@
+#include "CpmBus.hpp"
+
+#include <algorithm>
+
+namespace
+{
+    // Ports written by BDOS stub
+    constexpr u8 BDOS_FUNCTION_PORT = 0x01;
+    constexpr u8 BDOS_ARGUMENT_LOW_PORT = 0x02;
+    constexpr u8 BDOS_ARGUMENT_HIGH_PORT = 0x03;
+
+    constexpr u8 CONSOLE_OUTPUT = 2;  // Prints character in E
+    constexpr u8 PRINT_STRING = 9;    // Prints string at DE terminated by '$'
+
+    // MOV A,E; OUT 02; MOV A,D; OUT 03; MOV A,C; OUT 01; RET
+    const std::vector<u8> BDOS_STUB_CODE = { 0x7B, 0xD3, 0x02, 0x7A, 0xD3, 0x03, 0x79, 0xD3, 0x01, 0xC9 };
+}
+
+CpmBus::CpmBus()
+    : memory()
+    , bdosArgument(0)
+    , consoleOutput()
+    , console(nullptr)
+{
+    // HLT
+    memory[0x0000] = 0x76;
+    // JMP BDOS_STUB
+    memory[BDOS_ENTRY] = 0xC3;
+    memory[BDOS_ENTRY + 1] = BDOS_STUB & 0xFF;
+    memory[BDOS_ENTRY + 2] = BDOS_STUB >> 8;
+    std::copy(BDOS_STUB_CODE.begin(), BDOS_STUB_CODE.end(), memory.begin() + BDOS_STUB);
+}
+
+u8 CpmBus::readFromInputPort(u8) const
+{
+    return 0;
+}
+
+void CpmBus::writeIntoOutputPort(u8 port, u8 value)
+{
+    switch (port)
+    {
+        case BDOS_ARGUMENT_LOW_PORT:
+            bdosArgument = (bdosArgument & 0xFF00) | value;
+            break;
+        case BDOS_ARGUMENT_HIGH_PORT:
+            bdosArgument = (bdosArgument & 0x00FF) | (value << 8);
+            break;
+        case BDOS_FUNCTION_PORT:
+            callBdos(value);
+            break;
+        default:
+            break;
+    }
+}
+
+bool CpmBus::loadProgram(const std::vector<u8>& program)
+{
+    if (program.size() > BDOS_STUB - TPA_START)
+    {
+        return false;
+    }
+    std::copy(program.begin(), program.end(), memory.begin() + TPA_START);
+    return true;
+}
+
+const std::string& CpmBus::getConsoleOutput() const
+{
+    return consoleOutput;
+}
+
+void CpmBus::setConsole(std::ostream* stream)
+{
+    console = stream;
+}
+
+void CpmBus::callBdos(u8 function)
+{
+    const auto printedBefore = consoleOutput.size();
+    if (function == CONSOLE_OUTPUT)
+    {
+        consoleOutput += static_cast<char>(bdosArgument & 0xFF);
+    }
+    else if (function == PRINT_STRING)
+    {
+        for (u16 addr = bdosArgument; memory[addr] != '$' && addr != BDOS_STUB; addr++)
+        {
+            consoleOutput += static_cast<char>(memory[addr]);
+        }
+    }
+
+    if (console != nullptr)
+    {
+        console->write(consoleOutput.data() + printedBefore, consoleOutput.size() - printedBefore);
+        console->flush();
+    }
+}
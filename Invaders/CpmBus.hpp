@@ -0,0 +1,90 @@
+#pragma once
+
+#include <array>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Bus.hpp"
+
+// Flat 64 KiB of RAM with just enough of CP/M to run cpu test programs
+// (TST8080, CPUDIAG, 8080PRE, 8080EXM) loaded at TPA_START:
+// 0x0000 - HLT, so warm boot at the end of program halts the cpu
+// 0x0005 - JMP to BDOS stub, address of which doubles as top of memory
+// BDOS stub passes DE and function number in C to the bus through output ports.
+// Only console output functions (2 and 9) are implemented.
+class CpmBus final : public Bus
+{
+    public:
+        static constexpr u16 TPA_START = 0x0100;
+        static constexpr u16 BDOS_ENTRY = 0x0005;
+        static constexpr u16 BDOS_STUB = 0xFE00;
+
+        CpmBus();
+
+        ~CpmBus() = default;
+
+        u8 readFromMemory(u16 addr) const override
+        {
+            return memory[addr];
+        }
+
+        void writeIntoMemory(u16 addr, u8 value) override
+        {
+            memory[addr] = value;
+        }
+
+        u16 readWordFromMemory(u16 addr) const override
+        {
+            return memory[addr] | (memory[static_cast<u16>(addr + 1)] << 8);
+        }
+
+        void writeWordIntoMemory(u16 addr, u16 value) override
+        {
+            memory[addr] = value & 0xFF;
+            memory[static_cast<u16>(addr + 1)] = value >> 8;
+        }
+
+        u8 fetchFromMemory(u16 addr) const override
+        {
+            return memory[addr];
+        }
+
+        u16 fetchWordFromMemory(u16 addr) const override
+        {
+            return readWordFromMemory(addr);
+        }
+
+        u32 fetchInstructionWindow(u16 addr) const override
+        {
+            return memory[addr]
+                | (memory[static_cast<u16>(addr + 1)] << 8)
+                | (static_cast<u32>(memory[static_cast<u16>(addr + 2)]) << 16);
+        }
+
+        u8 readFromInputPort(u8 port) const override;
+
+        void writeIntoOutputPort(u8 port, u8 value) override;
+
+        u8& getMemoryLocationRef(u16 addr) override
+        {
+            return memory[addr];
+        }
+
+        // Copies program into memory at TPA_START. Returns false when it does not fit below BDOS.
+        bool loadProgram(const std::vector<u8>& program);
+
+        // Everything program printed so far
+        const std::string& getConsoleOutput() const;
+
+        // Stream to which console output is copied as it is printed, nullptr to disable
+        void setConsole(std::ostream* stream);
+
+    private:
+        void callBdos(u8 function);
+
+        std::array<u8, 0x10000> memory;
+        u16 bdosArgument;  // DE of last BDOS call
+        std::string consoleOutput;
+        std::ostream* console;
+};
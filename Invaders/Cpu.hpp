@@ -15,5 +15,15 @@ class Cpu
 
         virtual bool interruptsEnabled() = 0;
 
+        // Latches interrupt of device placing RST instruction with given number (0-7)
+        // on data bus. It is taken at the start of next run() once interrupts are enabled,
+        // or after instruction following EI when it is executed within batch.
+        // Newer request replaces older one which was not taken yet.
+        virtual void requestInterrupt(u8 rstVector) = 0;
+
         virtual void executeInstruction(u8 opcode) = 0;
+
+        // Executes instructions until given number of clock cycles elapses.
+        // Returns number of cycles by which last instruction overran the budget.
+        virtual u32 run(u32 cycles) = 0;
 };
\ No newline at end of file
@@ -0,0 +1,281 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <memory>
+#include <utility>
+
+#include "Cpu.hpp"
+#include "Condition.hpp"
+#include "Debugger.hpp"
+#include "DispatchMode.hpp"
+#include "FlagTables.hpp"
+#include "GuestProfiler.hpp"
+#include "IdleStats.hpp"
+#include "InstructionTrace.hpp"
+#include "OpcodeStats.hpp"
+#include "OpcodeTraits.hpp"
+
+// Interpreter core parametrized with type of the bus it is connected to.
+// When TBus is concrete (final) bus implementation, memory and port accesses
+// are resolved statically and can be inlined into instruction handlers.
+template <typename TBus>
+class CpuCore : public Cpu
+{
+    public:
+        CpuCore(const std::shared_ptr<TBus>& busPtr, DispatchMode mode = DispatchMode::DECODER);
+
+        ~CpuCore() = default;
+
+        u8 fetchOpcode() override;
+
+        Registers& getRegisters() override;
+
+        bool isHalted() override;
+
+        bool interruptsEnabled() override;
+
+        void requestInterrupt(u8 rstVector) override;
+
+        bool isInterruptPending() const;
+
+        void executeInstruction(u8 opcode) override;
+
+        u32 run(u32 cycles) override;
+
+        // Total number of clock cycles elapsed since cpu was created
+        u64 getCycles() const;
+
+        DispatchMode getDispatchMode() const;
+
+        void setDispatchMode(DispatchMode mode);
+
+        // In lazy flags mode ALU instructions only record their operands, and
+        // Sign, Zero, Parity and Aux-Carry flags are computed when something reads them.
+        // getRegisters() brings flag register up to date, so references obtained
+        // from it have to be refreshed after executing instructions.
+        bool isLazyFlagsEnabled() const;
+
+        void setLazyFlagsEnabled(bool enabled);
+
+        const IdleStats& getIdleStats() const;
+
+        void resetIdleStats();
+
+        // Opcodes executed by interpreter, empty unless built with OPCODE_STATS_ENABLED
+        const OpcodeStats& getOpcodeStats() const;
+
+        void resetOpcodeStats();
+
+        // Attaches profiler (not owned), nullptr detaches it. Batches are split
+        // at its sample points, and calls and returns are reported to it.
+        void setProfiler(GuestProfiler* profiler);
+
+        GuestProfiler* getProfiler() const;
+
+        // Attaches trace (not owned), nullptr detaches it. While attached, instructions
+        // are executed one at a time through executeInstruction(), so backends which
+        // cache code run as interpreter and keep their caches coherent.
+        void setTrace(InstructionTrace* trace);
+
+        InstructionTrace* getTrace() const;
+
+        // Attaches debugger (not owned), nullptr detaches it. Its breakpoints and
+        // watchpoints are checked only in batches started while it has any, and
+        // run() returns early when it stops. Like tracing, instructions are then
+        // executed one at a time through executeInstruction().
+        void setDebugger(Debugger* debugger);
+
+        Debugger* getDebugger() const;
+
+    protected:
+        using InstructionHandler = void (CpuCore::*)();
+        // Handler of instruction whose operand was already fetched (or predecoded).
+        // PC has to point past the instruction when it is called.
+        using OperandHandler = void (CpuCore::*)(u16);
+
+        bool interrupt_enable;
+        bool halted;
+        bool interruptPending;
+        u8 interruptVector;
+        // Set by EI, cleared when the next batch starts, which runs instruction
+        // following EI first unless control went elsewhere already. Address of
+        // that instruction tells whether batch ended right after EI.
+        bool interruptDelayed;
+        u16 interruptDelayPc;
+        Registers registers;
+        std::shared_ptr<TBus> bus;
+        DispatchMode dispatchMode;
+        const FlagTables& flagTables;
+        bool lazyFlagsEnabled;
+        // Table entry of last ALU operation whose Sign, Zero, Parity and Aux-Carry
+        // flags were not written into flag register yet, nullptr when it is up to date.
+        // Address of entry encodes both operation and its operands, and is computed
+        // without touching table memory. Carry is never deferred.
+        const AluResult* lazyFlagsEntry;
+
+        u64 cycles;
+        u64 cycleTarget;
+        IdleStats idleStats;
+        OpcodeStats opcodeStats;
+        GuestProfiler* profiler;
+        u64 nextSampleCycle;
+        InstructionTrace* trace;
+        Debugger* debugger;
+        // Set when debugger stopped cpu during current run()
+        bool debugStopped;
+
+        static const std::array<InstructionHandler, 256> dispatchTable;
+        static const std::array<u8, 256> cycleTable;
+        static const std::array<u8, 256> lengthTable;
+        static const std::array<OperandHandler, 256> operandDispatchTable;
+
+        template <std::size_t... opcodes>
+        static constexpr std::array<InstructionHandler, 256> makeDispatchTable(std::index_sequence<opcodes...>);
+        template <std::size_t... opcodes>
+        static constexpr std::array<OperandHandler, 256> makeOperandDispatchTable(std::index_sequence<opcodes...>);
+        template <std::size_t... opcodes>
+        static constexpr std::array<u8, 256> makeCycleTable(std::index_sequence<opcodes...>);
+        template <std::size_t... opcodes>
+        static constexpr std::array<u8, 256> makeLengthTable(std::index_sequence<opcodes...>);
+
+        // Executes instructions until cycle counter reaches cycleTarget.
+        // Instructions may lower cycleTarget to end batch early.
+        virtual void runUntilTarget();
+
+        // Runs until cycleTarget by runUntilTarget(), or by instantiation of stepped
+        // loop instrumented for tracing or debugging. They are selected once per batch,
+        // so instrumentation costs nothing when it is off.
+        void runBatch();
+
+        template <bool traced, bool debugged>
+        void runSteppedUntilTarget();
+
+        // Executes next instruction and stops debugger when it accessed watched memory
+        void executeWatchedInstruction();
+
+        // Records state of cpu before next instruction or taken interrupt
+        void recordTrace(TraceRecordKind kind);
+
+        template <u8 opcode>
+        void executeOpcode();
+        template <u8 opcode>
+        void executeOpcodeWithOperand(u16 operand);
+
+        void executeDecodedInstruction(u8 opcode);
+        void executeFirstGroupInstruction(u8 y, u8 z, u8 p, u8 q);
+        void executeSecondGroupInstruction(u8 y, u8 z);
+        void executeThirdGroupInstruction(u8 y, u8 z);
+        void executeFourthGroupInstruction(u8 y, u8 z, u8 p, u8 q);
+
+        u8& resolveRegister(unsigned index, OperandAccess access);
+        u16& resolveRegisterPair1(unsigned index);
+        u16& resolveRegisterPair2(unsigned index);
+        Condition resolveCondition(unsigned index);
+        bool evaluateCondition(Condition c);
+
+        template <unsigned index, OperandAccess access>
+        u8& resolveRegister();
+        template <unsigned index, unsigned table>
+        u16& resolveRegisterPair();
+        template <Condition c>
+        bool evaluateCondition();
+
+        // Executes RST instruction of latched interrupt, which pushes PC, clears
+        // interrupt enable and wakes cpu from HLT
+        void serviceInterrupt();
+
+        // Called after iteration of loop which took given number of cycles and left
+        // registers and memory as they were. Every next iteration would do the same
+        // until an interrupt arrives, so iterations fitting into budget are skipped.
+        void skipIdleIterations(u64 iterationCycles);
+
+        // Counts opcode which started executing at given cycle count, does nothing
+        // unless built with OPCODE_STATS_ENABLED
+        void recordOpcode(u8 opcode, u64 cyclesBefore);
+
+        // Samples PC at every sample point the cycle counter passed
+        void takeProfilerSamples();
+
+        // Reports call which pushed given return address, does nothing without profiler
+        void reportCall(u16 target, u16 returnAddress);
+
+        // Reports return about to pop return address, does nothing without profiler
+        void reportReturn();
+
+        // Address of memory written by instruction, resolved before it is executed
+        u16 resolveWriteAddress(MemoryWrite write, u16 operand);
+
+        u16 fetchImmedate16();
+        u8 fetchImmedate8();
+        u16 popFromStack16();
+        void pushIntoStack16(u16 value);
+
+        void applyAluResult(const AluResult& result);
+        void applyLogicResult(u8 result);
+        void deferAdd(u8 value, u8 carry, bool storeResult);
+        void deferSubtract(u8 value, u8 borrow, bool storeResult);
+        void deferLogic(u8 result);
+        void materializeFlags();
+
+        // Instructions
+        void nop();                         // NOP  - No operation
+        void lxi(u16& reg16, u16 immedate); // LXI  - Load extended register with immedate
+        void dad(u16& reg16);               // DAD  - Double Add
+        void stax(u16& reg16);              // STAX - Store Accumulator at address stored in extended register
+        void shld(u16 addr);                // SHLD - Store HL at immedate address
+        void sta(u16 addr);                 // STA  - Store Accumulator at immedate address
+        void ldax(u16& reg16);              // LDAX - Load Accumulator from address stored in extended register
+        void lhld(u16 addr);                // LHLD - Load HL from immedate address
+        void lda(u16 addr);                 // LDA  - Load Accumulator from immedate address
+        void inx(u16& reg16);               // INX  - Increment extended register
+        void dcx(u16& reg16);               // DCX  - Decrement extended register
+        void inr(u8& reg8);                 // INR  - Increment register
+        void dcr(u8& reg8);                 // DCR  - Decrement register
+        void mvi(u8& reg8, u8 immedate);    // MVI  - Move immedate value to register
+        void rlc();                         // RLC  - Rotate Accumulator Left
+        void rrc();                         // RRC  - Rotate Accumulator Right
+        void ral();                         // RAL  - Rotate Accumulator Left trough Carry
+        void rar();                         // RAR  - Rotate Accumulator Right through Carry
+        void daa();                         // DAA  - Decimal adjust accumulator
+        void cma();                         // CMA  - Complement accumulator
+        void stc();                         // STC  - Set carry
+        void cmc();                         // CMC  - Complement carry
+        void mov(u8& dest, u8& src);        // MOV  - Move one register value to another    
+        void halt();                        // HALT - Halt cpu
+        void add(u8& src);                  // ADD  - Add register value to accumulator
+        void adc(u8& src);                  // ADC  - Add register value to accumulator with carry
+        void sub(u8& src);                  // SUB  - Subtract register value from accumulator
+        void sbb(u8& src);                  // SBB  - Subtract register value from accumulator with borrow
+        void ana(u8& src);                  // ANA  - Logical AND register value with accumulator
+        void xra(u8& src);                  // XRA  - Logical XOR register value with accumulator
+        void ora(u8& src);                  // ORA  - Logical OR register value with accumulator
+        void cmp(u8& src);                  // CMP  - Compare register value with accumulator (subtract without storing result)
+        void ret(Condition c);              // Rcc  - Conditional return
+        void pop(u16& reg16);               // POP  - Pop 16 bit value from stack and store in extended register
+        void ret();                         // RET  - Unconditional return
+        void pchl();                        // PCHL - Load PC from HL
+        void sphl();                        // SPHL - Load SP from HL
+        void jmp(Condition c, u16 addr);    // Jcc  - Conditional Jump
+        void jmp(u16 addr);                 // JMP  - Unconditional Jump
+        void out(u8 port);                  // OUT  - Write accumulator value to output port
+        void xthl();                        // XTHL - Exchange HL with memory contents pointed by SP
+        void di();                          // DI   - Disable interrupts
+        void in(u8 port);                   // IN   - Read value from input port and store in accumulator
+        void xchg();                        // XCHG - Exchange HL with DE
+        void ei();                          // EI   - Enable interrupts
+        void call(Condition c, u16 addr);   // Ccc  - Conditional call
+        void push(u16& reg);                // PUSH - Push extended register value into stack
+        void call(u16 addr);                // CALL - Unconditional call
+        void adi(u8 immedate);              // ADI  - Add immedate to accumulator
+        void aci(u8 immedate);              // ACI  - Add immedate to accumulator with carry
+        void sui(u8 immedate);              // SUI  - Subtract immedate from accumulator
+        void sbi(u8 immedate);              // SBI  - Subtract immedate from accumulator with borrow
+        void ani(u8 immedate);              // ANI  - Logical AND accumulator with immedate
+        void xri(u8 immedate);              // XRI  - Logical XOR accumulator with immedate
+        void ori(u8 immedate);              // ORI  - Logical OR accumulator with immedate
+        void cpi(u8 immedate);              // CPI  - Compare accumulator with immedate
+        void rst(u8 vector);                // RST  - Jump to reset vector
+};
+
+#include "CpuCore.inl"
\ No newline at end of file
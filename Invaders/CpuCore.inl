@@ -0,0 +1,1792 @@
+template <typename TBus>
+template <std::size_t... opcodes>
+constexpr std::array<typename CpuCore<TBus>::InstructionHandler, 256> CpuCore<TBus>::makeDispatchTable(std::index_sequence<opcodes...>)
+{
+    return { { &CpuCore::template executeOpcode<opcodes>... } };
+}
+
+template <typename TBus>
+template <std::size_t... opcodes>
+constexpr std::array<typename CpuCore<TBus>::OperandHandler, 256> CpuCore<TBus>::makeOperandDispatchTable(std::index_sequence<opcodes...>)
+{
+    return { { &CpuCore::template executeOpcodeWithOperand<opcodes>... } };
+}
+
+template <typename TBus>
+template <std::size_t... opcodes>
+constexpr std::array<u8, 256> CpuCore<TBus>::makeCycleTable(std::index_sequence<opcodes...>)
+{
+    return { { static_cast<u8>(OpcodeTraits::getCycles(opcodes))... } };
+}
+
+template <typename TBus>
+template <std::size_t... opcodes>
+constexpr std::array<u8, 256> CpuCore<TBus>::makeLengthTable(std::index_sequence<opcodes...>)
+{
+    return { { static_cast<u8>(OpcodeTraits::getLength(opcodes))... } };
+}
+
+template <typename TBus>
+template <u8 opcode>
+void CpuCore<TBus>::executeOpcode()
+{
+    // Operand length is known at compile time, so it is fetched up front
+    // and handler receives it already assembled
+
+    constexpr auto length = OpcodeTraits::getLength(opcode);
+
+    u16 operand = 0;
+    if constexpr (length == 2)
+        operand = fetchImmedate8();
+    else if constexpr (length == 3)
+        operand = fetchImmedate16();
+
+    executeOpcodeWithOperand<opcode>(operand);
+}
+
+template <typename TBus>
+template <u8 opcode>
+void CpuCore<TBus>::executeOpcodeWithOperand(u16 operand)
+{
+    // Mirrors execute*GroupInstruction methods, but every decision
+    // is resolved at compile time for given opcode
+
+    constexpr auto x = OpcodeTraits::getX(opcode);
+    constexpr auto y = OpcodeTraits::getY(opcode);
+    constexpr auto z = OpcodeTraits::getZ(opcode);
+    constexpr auto p = OpcodeTraits::getP(opcode);
+    constexpr auto q = OpcodeTraits::getQ(opcode);
+
+    if constexpr (x == 0)
+    {
+        if constexpr (z == 0)
+        {
+            nop();
+        }
+        else if constexpr (z == 1)
+        {
+            if constexpr (q == 0)
+                lxi(resolveRegisterPair<p, 1>(), operand);
+            else
+                dad(resolveRegisterPair<p, 1>());
+        }
+        else if constexpr (z == 2)
+        {
+            if constexpr (p < 2 && q == 0)
+                stax(resolveRegisterPair<p, 1>());
+            else if constexpr (p < 2)
+                ldax(resolveRegisterPair<p, 1>());
+            else if constexpr (p == 2 && q == 0)
+                shld(operand);
+            else if constexpr (p == 2)
+                lhld(operand);
+            else if constexpr (q == 0)
+                sta(operand);
+            else
+                lda(operand);
+        }
+        else if constexpr (z == 3)
+        {
+            if constexpr (q == 0)
+                inx(resolveRegisterPair<p, 1>());
+            else
+                dcx(resolveRegisterPair<p, 1>());
+        }
+        else if constexpr (z == 4)
+        {
+            inr(resolveRegister<y, OperandAccess::READ_WRITE>());
+        }
+        else if constexpr (z == 5)
+        {
+            dcr(resolveRegister<y, OperandAccess::READ_WRITE>());
+        }
+        else if constexpr (z == 6)
+        {
+            mvi(resolveRegister<y, OperandAccess::WRITE>(), static_cast<u8>(operand));
+        }
+        else
+        {
+            if constexpr (y == 0)
+                rlc();
+            else if constexpr (y == 1)
+                rrc();
+            else if constexpr (y == 2)
+                ral();
+            else if constexpr (y == 3)
+                rar();
+            else if constexpr (y == 4)
+                daa();
+            else if constexpr (y == 5)
+                cma();
+            else if constexpr (y == 6)
+                stc();
+            else
+                cmc();
+        }
+    }
+    else if constexpr (x == 1)
+    {
+        if constexpr (z == 6 && y == 6)
+            halt();
+        else
+            mov(resolveRegister<y, OperandAccess::WRITE>(), resolveRegister<z, OperandAccess::READ>());
+    }
+    else if constexpr (x == 2)
+    {
+        u8& reg = resolveRegister<z, OperandAccess::READ>();
+
+        if constexpr (y == 0)
+            add(reg);
+        else if constexpr (y == 1)
+            adc(reg);
+        else if constexpr (y == 2)
+            sub(reg);
+        else if constexpr (y == 3)
+            sbb(reg);
+        else if constexpr (y == 4)
+            ana(reg);
+        else if constexpr (y == 5)
+            xra(reg);
+        else if constexpr (y == 6)
+            ora(reg);
+        else
+            cmp(reg);
+    }
+    else
+    {
+        constexpr auto condition = static_cast<Condition>(y);
+
+        if constexpr (z == 0)
+        {
+            if (evaluateCondition<condition>())
+            {
+                ret();
+                cycles += OpcodeTraits::CONDITION_MET_EXTRA_CYCLES;
+            }
+        }
+        else if constexpr (z == 1)
+        {
+            if constexpr (q == 0)
+                pop(resolveRegisterPair<p, 2>());
+            else if constexpr (p < 2)
+                ret();
+            else if constexpr (p == 2)
+                pchl();
+            else
+                sphl();
+        }
+        else if constexpr (z == 2)
+        {
+            if (evaluateCondition<condition>())
+                jmp(operand);
+        }
+        else if constexpr (z == 3)
+        {
+            if constexpr (p == 0)
+                jmp(operand);
+            else if constexpr (p == 1 && q == 0)
+                out(static_cast<u8>(operand));
+            else if constexpr (p == 1)
+                in(static_cast<u8>(operand));
+            else if constexpr (p == 2 && q == 0)
+                xthl();
+            else if constexpr (p == 2)
+                xchg();
+            else if constexpr (q == 0)
+                di();
+            else
+                ei();
+        }
+        else if constexpr (z == 4)
+        {
+            if (evaluateCondition<condition>())
+            {
+                call(operand);
+                cycles += OpcodeTraits::CONDITION_MET_EXTRA_CYCLES;
+            }
+        }
+        else if constexpr (z == 5)
+        {
+            if constexpr (q == 0)
+                push(resolveRegisterPair<p, 2>());
+            else
+                call(operand);
+        }
+        else if constexpr (z == 6)
+        {
+            const auto immedate = static_cast<u8>(operand);
+
+            if constexpr (y == 0)
+                adi(immedate);
+            else if constexpr (y == 1)
+                aci(immedate);
+            else if constexpr (y == 2)
+                sui(immedate);
+            else if constexpr (y == 3)
+                sbi(immedate);
+            else if constexpr (y == 4)
+                ani(immedate);
+            else if constexpr (y == 5)
+                xri(immedate);
+            else if constexpr (y == 6)
+                ori(immedate);
+            else
+                cpi(immedate);
+        }
+        else
+        {
+            rst(y * 8);
+        }
+    }
+}
+
+template <typename TBus>
+template <unsigned index, OperandAccess access>
+u8& CpuCore<TBus>::resolveRegister()
+{
+    // Register table:
+    // B, C, D, E, H, L, (HL), A
+
+    if constexpr (index == RegisterFile::MEMORY_OPERAND)
+        return bus->getOperandLocationRef(registers.getHl().getRaw(), access);
+    else
+        return registers.getFile().getRegister(index);
+}
+
+template <typename TBus>
+template <unsigned index, unsigned table>
+u16& CpuCore<TBus>::resolveRegisterPair()
+{
+    // Register pair table 1:
+    // BC, DE, HL, SP
+    // Register pair table 2:
+    // BC, DE, HL, AF
+
+    if constexpr (table == 1)
+        return registers.getFile().getRegisterPair(index);
+    else
+        return registers.getFile().getStackRegisterPair(index);
+}
+
+template <typename TBus>
+template <Condition c>
+bool CpuCore<TBus>::evaluateCondition()
+{
+    if constexpr (c != Condition::NOT_CARRY && c != Condition::CARRY)
+        materializeFlags();
+
+    const auto& flags = registers.getAf().getLow();
+
+    if constexpr (c == Condition::NOT_ZERO)
+        return !flags.Z;
+    else if constexpr (c == Condition::ZERO)
+        return flags.Z;
+    else if constexpr (c == Condition::NOT_CARRY)
+        return !flags.C;
+    else if constexpr (c == Condition::CARRY)
+        return flags.C;
+    else if constexpr (c == Condition::ODD)
+        return !flags.P;
+    else if constexpr (c == Condition::EVEN)
+        return flags.P;
+    else if constexpr (c == Condition::POSITIVE)
+        return !flags.S;
+    else
+        return flags.S;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::materializeFlags()
+{
+    if (lazyFlagsEntry != nullptr)
+    {
+        auto& flags = registers.getAf().getLow();
+        flags.raw = (flags.raw & ~FlagTables::INCREMENT_FLAGS) | (lazyFlagsEntry->flags & FlagTables::INCREMENT_FLAGS);
+        lazyFlagsEntry = nullptr;
+    }
+}
+
+template <typename TBus>
+const std::array<typename CpuCore<TBus>::InstructionHandler, 256> CpuCore<TBus>::dispatchTable =
+    CpuCore<TBus>::makeDispatchTable(std::make_index_sequence<256>());
+
+template <typename TBus>
+const std::array<u8, 256> CpuCore<TBus>::cycleTable =
+    CpuCore<TBus>::makeCycleTable(std::make_index_sequence<256>());
+
+template <typename TBus>
+const std::array<u8, 256> CpuCore<TBus>::lengthTable =
+    CpuCore<TBus>::makeLengthTable(std::make_index_sequence<256>());
+
+template <typename TBus>
+const std::array<typename CpuCore<TBus>::OperandHandler, 256> CpuCore<TBus>::operandDispatchTable =
+    CpuCore<TBus>::makeOperandDispatchTable(std::make_index_sequence<256>());
+
+template <typename TBus>
+CpuCore<TBus>::CpuCore(const std::shared_ptr<TBus>& busPtr, DispatchMode mode)
+    : registers()
+    , bus(busPtr)
+    , interrupt_enable(false)
+    , halted(false)
+    , interruptPending(false)
+    , interruptVector(0)
+    , interruptDelayed(false)
+    , interruptDelayPc(0)
+    , dispatchMode(mode)
+    , flagTables(FlagTables::getInstance())
+    , lazyFlagsEnabled(false)
+    , lazyFlagsEntry(nullptr)
+    , cycles(0)
+    , cycleTarget(0)
+    , idleStats()
+    , opcodeStats()
+    , profiler(nullptr)
+    , nextSampleCycle(0)
+    , trace(nullptr)
+    , debugger(nullptr)
+    , debugStopped(false)
+{
+    auto& rawFlags = registers.getAf().getLow().raw;
+    rawFlags = 0x2; // Set bit between Carry and Parity to 1
+}
+
+template <typename TBus>
+u8 CpuCore<TBus>::fetchOpcode()
+{
+    u16& pc = registers.getPc();
+    u8 opcode = bus->fetchFromMemory(pc);
+    pc += 1;
+    return opcode;
+}
+
+template <typename TBus>
+Registers& CpuCore<TBus>::getRegisters()
+{
+    materializeFlags();
+    return registers;
+}
+
+template <typename TBus>
+bool CpuCore<TBus>::isHalted()
+{
+    return halted;
+}
+
+template <typename TBus>
+bool CpuCore<TBus>::interruptsEnabled()
+{
+    return interrupt_enable;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::requestInterrupt(u8 rstVector)
+{
+    interruptPending = true;
+    interruptVector = rstVector & 0x7;
+}
+
+template <typename TBus>
+bool CpuCore<TBus>::isInterruptPending() const
+{
+    return interruptPending;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::executeInstruction(u8 opcode)
+{
+    const u64 cyclesBefore = cycles;
+    if (dispatchMode == DispatchMode::TABLE)
+    {
+        auto handler = dispatchTable[opcode];
+        (this->*handler)();
+    }
+    else
+    {
+        executeDecodedInstruction(opcode);
+    }
+    cycles += cycleTable[opcode];
+    recordOpcode(opcode, cyclesBefore);
+}
+
+template <typename TBus>
+u32 CpuCore<TBus>::run(u32 cycleBudget)
+{
+    const u64 target = cycles + cycleBudget;
+    debugStopped = false;
+
+    // Pending interrupt is checked only between batches. EI lowers cycleTarget
+    // when interrupt is pending, so batch is resumed after it is taken.
+    while (!debugStopped)
+    {
+        if (interruptPending && interrupt_enable)
+        {
+            if (interruptDelayed && registers.getPc() == interruptDelayPc)
+            {
+                // Batch ended right after EI, instruction following it runs first
+                if (cycles >= target)
+                {
+                    break;
+                }
+                interruptDelayed = false;
+                cycleTarget = cycles + 1;
+                runBatch();
+                continue;
+            }
+            serviceInterrupt();
+        }
+        if (halted || cycles >= target)
+        {
+            break;
+        }
+
+        // Instruction following EI either runs first in this batch or has run already
+        interruptDelayed = false;
+        cycleTarget = profiler != nullptr ? std::min(target, nextSampleCycle) : target;
+        runBatch();
+    }
+
+    if (debugStopped)
+    {
+        return cycles > target ? static_cast<u32>(cycles - target) : 0;
+    }
+
+    // Halted cpu does nothing until interrupt arrives, but time still passes
+    if (halted && cycles < target)
+    {
+        idleStats.haltedCycles += target - cycles;
+        cycles = target;
+        takeProfilerSamples();
+    }
+
+    return static_cast<u32>(cycles - target);
+}
+
+template <typename TBus>
+u64 CpuCore<TBus>::getCycles() const
+{
+    return cycles;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::runUntilTarget()
+{
+    if (dispatchMode == DispatchMode::TABLE)
+    {
+        while (cycles < cycleTarget)
+        {
+            const u64 cyclesBefore = cycles;
+            u8 opcode = CpuCore::fetchOpcode();
+            auto handler = dispatchTable[opcode];
+            (this->*handler)();
+            cycles += cycleTable[opcode];
+            recordOpcode(opcode, cyclesBefore);
+        }
+    }
+    else
+    {
+        while (cycles < cycleTarget)
+        {
+            const u64 cyclesBefore = cycles;
+            u8 opcode = CpuCore::fetchOpcode();
+            executeDecodedInstruction(opcode);
+            cycles += cycleTable[opcode];
+            recordOpcode(opcode, cyclesBefore);
+        }
+    }
+}
+
+template <typename TBus>
+void CpuCore<TBus>::runBatch()
+{
+    if (debugger != nullptr && debugger->isActive())
+    {
+        if (trace != nullptr)
+        {
+            runSteppedUntilTarget<true, true>();
+        }
+        else
+        {
+            runSteppedUntilTarget<false, true>();
+        }
+    }
+    else if (trace != nullptr)
+    {
+        runSteppedUntilTarget<true, false>();
+    }
+    else
+    {
+        runUntilTarget();
+    }
+    takeProfilerSamples();
+}
+
+template <typename TBus>
+template <bool traced, bool debugged>
+void CpuCore<TBus>::runSteppedUntilTarget()
+{
+    while (cycles < cycleTarget)
+    {
+        if constexpr (debugged)
+        {
+            if (debugger->checkBreakpoint(registers.getPc()))
+            {
+                debugStopped = true;
+                return;
+            }
+        }
+        if constexpr (traced)
+        {
+            recordTrace(TraceRecordKind::INSTRUCTION);
+        }
+        if constexpr (debugged)
+        {
+            executeWatchedInstruction();
+            if (debugStopped)
+            {
+                return;
+            }
+        }
+        else
+        {
+            executeInstruction(CpuCore::fetchOpcode());
+        }
+    }
+}
+
+template <typename TBus>
+void CpuCore<TBus>::executeWatchedInstruction()
+{
+    const u16 pc = registers.getPc();
+    const u16 sp = registers.getSp();
+    const u32 window = bus->peekInstructionWindow(pc);
+    const u8 opcode = window & 0xFF;
+    const u16 operand = (window >> 8) & 0xFFFF;
+
+    // Addresses depend on registers, so they are resolved before instruction changes them
+    const auto read = OpcodeTraits::getMemoryRead(opcode);
+    const auto write = OpcodeTraits::getMemoryWrite(opcode);
+    const u16 readAddr = resolveWriteAddress(read, operand);
+    const u16 writeAddr = resolveWriteAddress(write, operand);
+
+    executeInstruction(CpuCore::fetchOpcode());
+
+    // Conditional calls and returns touch stack only when taken, which moves SP.
+    // XTHL is the only stack access leaving it where it was.
+    const auto accessed = [this, opcode, sp](MemoryWrite access)
+    {
+        const bool stackAccess = access == MemoryWrite::STACK_PUSH || access == MemoryWrite::STACK_TOP;
+        return access != MemoryWrite::NONE && (!stackAccess || opcode == 0xE3 || registers.getSp() != sp);
+    };
+    const auto stopOnWatched = [this, pc](MemoryWrite access, u16 addr, WatchAccess type)
+    {
+        for (unsigned i = 0; i < OpcodeTraits::getMemoryWriteLength(access); i++)
+        {
+            const u16 byteAddr = static_cast<u16>(addr + i);
+            if (debugger->isWatched(byteAddr, type))
+            {
+                debugger->stopOnWatchpoint(pc, byteAddr, type, bus->peekMemory(byteAddr));
+                debugStopped = true;
+                return true;
+            }
+        }
+        return false;
+    };
+
+    if (accessed(write) && stopOnWatched(write, writeAddr, WatchAccess::WRITE))
+    {
+        return;
+    }
+    if (accessed(read))
+    {
+        stopOnWatched(read, readAddr, WatchAccess::READ);
+    }
+}
+
+template <typename TBus>
+void CpuCore<TBus>::recordTrace(TraceRecordKind kind)
+{
+    materializeFlags();
+    const u16 pc = registers.getPc();
+    // Taken interrupt executes RST which is not in memory
+    const u32 window = kind == TraceRecordKind::INSTRUCTION ? bus->peekInstructionWindow(pc) : 0xC7 | (interruptVector << 3);
+
+    TraceRecord record = {};
+    record.cycles = static_cast<u32>(cycles);
+    record.pc = pc;
+    record.sp = registers.getSp();
+    record.opcode = window & 0xFF;
+    record.operand[0] = (window >> 8) & 0xFF;
+    record.operand[1] = (window >> 16) & 0xFF;
+    record.a = registers.getAf().getHigh();
+    record.flags = registers.getAf().getLow().raw;
+    record.kind = kind;
+    trace->record(record, cycles);
+}
+
+template <typename TBus>
+const IdleStats& CpuCore<TBus>::getIdleStats() const
+{
+    return idleStats;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::resetIdleStats()
+{
+    idleStats = IdleStats();
+}
+
+template <typename TBus>
+const OpcodeStats& CpuCore<TBus>::getOpcodeStats() const
+{
+    return opcodeStats;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::resetOpcodeStats()
+{
+    opcodeStats.reset();
+}
+
+template <typename TBus>
+void CpuCore<TBus>::recordOpcode(u8 opcode, u64 cyclesBefore)
+{
+    if constexpr (OpcodeStats::ENABLED)
+    {
+        opcodeStats.record(opcode, cycles - cyclesBefore);
+    }
+}
+
+template <typename TBus>
+void CpuCore<TBus>::setProfiler(GuestProfiler* profilerPtr)
+{
+    profiler = profilerPtr;
+    if (profiler != nullptr)
+    {
+        nextSampleCycle = cycles + profiler->getSampleInterval();
+    }
+}
+
+template <typename TBus>
+GuestProfiler* CpuCore<TBus>::getProfiler() const
+{
+    return profiler;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::setTrace(InstructionTrace* tracePtr)
+{
+    trace = tracePtr;
+}
+
+template <typename TBus>
+InstructionTrace* CpuCore<TBus>::getTrace() const
+{
+    return trace;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::setDebugger(Debugger* debuggerPtr)
+{
+    debugger = debuggerPtr;
+}
+
+template <typename TBus>
+Debugger* CpuCore<TBus>::getDebugger() const
+{
+    return debugger;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::takeProfilerSamples()
+{
+    // Instruction crossing sample point is attributed to the address following it
+    while (profiler != nullptr && cycles >= nextSampleCycle)
+    {
+        profiler->onSample(registers.getPc(), registers.getSp());
+        nextSampleCycle += profiler->getSampleInterval();
+    }
+}
+
+template <typename TBus>
+void CpuCore<TBus>::reportCall(u16 target, u16 returnAddress)
+{
+    if (profiler != nullptr)
+    {
+        profiler->onCall(target, returnAddress, registers.getSp());
+    }
+}
+
+template <typename TBus>
+void CpuCore<TBus>::reportReturn()
+{
+    if (profiler != nullptr)
+    {
+        profiler->onReturn(registers.getSp());
+    }
+}
+
+template <typename TBus>
+void CpuCore<TBus>::serviceInterrupt()
+{
+    interruptPending = false;
+    interrupt_enable = false;
+    interruptDelayed = false;
+    halted = false;
+    if (trace != nullptr)
+    {
+        recordTrace(TraceRecordKind::INTERRUPT);
+    }
+    // Called through virtual executeInstruction, so implementations caching code
+    // see write into stack
+    executeInstruction(0xC7 | (interruptVector << 3));
+}
+
+template <typename TBus>
+void CpuCore<TBus>::skipIdleIterations(u64 iterationCycles)
+{
+    // Batch still ends on the same instruction, as the remaining
+    // part of budget is shorter than single iteration
+    if (cycles >= cycleTarget)
+    {
+        return;
+    }
+
+    const u64 iterations = (cycleTarget - cycles) / iterationCycles;
+    if (iterations == 0)
+    {
+        return;
+    }
+
+    idleStats.idleLoops++;
+    idleStats.idleLoopCycles += iterations * iterationCycles;
+    cycles += iterations * iterationCycles;
+}
+
+template <typename TBus>
+DispatchMode CpuCore<TBus>::getDispatchMode() const
+{
+    return dispatchMode;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::setDispatchMode(DispatchMode mode)
+{
+    dispatchMode = mode;
+}
+
+template <typename TBus>
+bool CpuCore<TBus>::isLazyFlagsEnabled() const
+{
+    return lazyFlagsEnabled;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::setLazyFlagsEnabled(bool enabled)
+{
+    materializeFlags();
+    lazyFlagsEnabled = enabled;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::executeDecodedInstruction(u8 opcode)
+{
+    // Extracting bitfields from opcode in following format
+    // 
+    // |xx|yy y|zzz|
+    // |  |pp|q|   |
+    
+    const auto x = (opcode >> 6) & 3;
+    const auto y = (opcode >> 3) & 7;
+    const auto z = opcode & 7;
+    const auto p = y >> 1;
+    const auto q = y % 2;
+
+    switch (x)
+    {
+        case 0:
+            executeFirstGroupInstruction(y, z, p, q);
+            break;
+        case 1:
+            executeSecondGroupInstruction(y, z);
+            break;
+        case 2:
+            executeThirdGroupInstruction(y, z);
+            break;
+        default:
+            executeFourthGroupInstruction(y, z, p, q);
+            break;
+    }
+}
+
+template <typename TBus>
+void CpuCore<TBus>::executeFirstGroupInstruction(u8 y, u8 z, u8 p, u8 q)
+{
+    // x == 0
+    if (z == 0)
+    {
+        nop();
+    }
+    else if (z == 1)
+    {
+        u16& reg = resolveRegisterPair1(p);
+        if (q == 0)
+        {
+            u16 immedate = fetchImmedate16();
+            lxi(reg, immedate);
+        }
+        else
+        {
+            dad(reg);
+        }
+    }
+    else if (z == 2)
+    {
+        u16& reg = resolveRegisterPair1(p);
+        if (p < 2)
+        {
+            if (q == 0)
+                stax(reg);
+            else
+                ldax(reg);
+        }
+        else if (p == 2)
+        {
+            u16 addr = fetchImmedate16();
+            if (q == 0)
+                shld(addr);
+            else
+                lhld(addr);
+        }
+        else
+        {
+            u16 addr = fetchImmedate16();
+            if (q == 0)
+                sta(addr);
+            else
+                lda(addr);
+        }
+    }
+    else if (z == 3)
+    {
+        u16& reg = resolveRegisterPair1(p);
+        if (q == 0)
+            inx(reg);
+        else
+            dcx(reg);
+    }
+    else if (z == 4)
+    {
+        u8& reg = resolveRegister(y, OperandAccess::READ_WRITE);
+        inr(reg);
+    }
+    else if (z == 5)
+    {
+        u8& reg = resolveRegister(y, OperandAccess::READ_WRITE);
+        dcr(reg);
+    }
+    else if (z == 6)
+    {
+        u8& reg = resolveRegister(y, OperandAccess::WRITE);
+        u8 immedate = fetchImmedate8();
+        mvi(reg, immedate);
+    }
+    else
+    {
+        if (y == 0)
+            rlc();
+        else if (y == 1)
+            rrc();
+        else if (y == 2)
+            ral();
+        else if (y == 3)
+            rar();
+        else if (y == 4)
+            daa();
+        else if (y == 5)
+            cma();
+        else if (y == 6)
+            stc();
+        else if (y == 7)
+            cmc();
+    }
+}
+
+template <typename TBus>
+void CpuCore<TBus>::executeSecondGroupInstruction(u8 y, u8 z)
+{
+    // x == 1
+    if (z == 6 && y == 6)
+    {
+        halt();
+    }
+    else
+    {
+        u8& destination = resolveRegister(y, OperandAccess::WRITE);
+        u8& source = resolveRegister(z, OperandAccess::READ);
+        mov(destination, source);
+    }
+}
+
+template <typename TBus>
+void CpuCore<TBus>::executeThirdGroupInstruction(u8 y, u8 z)
+{
+    // x == 2
+    u8& reg = resolveRegister(z, OperandAccess::READ);
+
+    if (y == 0)
+        add(reg);
+    else if (y == 1)
+        adc(reg);
+    else if (y == 2)
+        sub(reg);
+    else if (y == 3)
+        sbb(reg);
+    else if (y == 4)
+        ana(reg);
+    else if (y == 5)
+        xra(reg);
+    else if (y == 6)
+        ora(reg);
+    else
+        cmp(reg);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::executeFourthGroupInstruction(u8 y, u8 z, u8 p, u8 q)
+{
+    // x == 3
+    if (z == 0)
+    {
+        Condition condition = resolveCondition(y);
+        ret(condition);
+    }
+    else if (z == 1)
+    {
+        if (q == 0)
+        {
+            u16& reg = resolveRegisterPair2(p);
+            pop(reg);
+        }
+        else
+        {
+            if (p < 2)
+                ret();
+            else if (p == 2)
+                pchl();
+            else
+                sphl();
+        }
+    }
+    else if (z == 2)
+    {
+        Condition condition = resolveCondition(y);
+        u16 addr = fetchImmedate16();
+        jmp(condition, addr);
+    }
+    else if (z == 3)
+    {
+        if (p == 0)
+        {
+            u16 addr = fetchImmedate16();
+            jmp(addr);
+        }
+        else if (p == 1)
+        {
+            u8 port = fetchImmedate8();
+            if (q == 0)
+                out(port);
+            else
+                in(port);
+        }
+        else if (p == 2)
+        {
+            if (q == 0)
+                xthl();
+            else
+                xchg();
+        }
+        else if (p == 3)
+        {
+            if (q == 0)
+                di();
+            else
+                ei();
+        }
+    }
+    else if (z == 4)
+    {
+        Condition condition = resolveCondition(y);
+        u16 addr = fetchImmedate16();
+        call(condition, addr);
+    }
+    else if (z == 5)
+    {
+        if (q == 0)
+        {
+            u16& reg = resolveRegisterPair2(p);
+            push(reg);
+        }
+        else
+        {
+            u16 addr = fetchImmedate16();
+            call(addr);
+        }
+    }
+    else if (z == 6)
+    {
+        u8 immedate = fetchImmedate8();
+        if (y == 0)
+            adi(immedate);
+        else if (y == 1)
+            aci(immedate);
+        else if (y == 2)
+            sui(immedate);
+        else if (y == 3)
+            sbi(immedate);
+        else if (y == 4)
+            ani(immedate);
+        else if (y == 5)
+            xri(immedate);
+        else if (y == 6)
+            ori(immedate);
+        else
+            cpi(immedate);
+    }
+    else
+    {
+        rst(y * 8);
+    }
+}
+
+template <typename TBus>
+u8& CpuCore<TBus>::resolveRegister(unsigned index, OperandAccess access)
+{
+    // Register table:
+    // B, C, D, E, H, L, (HL), A
+
+    if (index == RegisterFile::MEMORY_OPERAND)
+        return bus->getOperandLocationRef(registers.getHl().getRaw(), access);
+    return registers.getFile().getRegister(index);
+}
+
+template <typename TBus>
+u16& CpuCore<TBus>::resolveRegisterPair1(unsigned index)
+{
+    // Register pair table 1:
+    // BC, DE, HL, SP
+
+    return registers.getFile().getRegisterPair(index);
+}
+
+template <typename TBus>
+u16& CpuCore<TBus>::resolveRegisterPair2(unsigned index)
+{
+    // Register pair table 2:
+    // BC, DE, HL, AF
+
+    return registers.getFile().getStackRegisterPair(index);
+}
+
+template <typename TBus>
+Condition CpuCore<TBus>::resolveCondition(unsigned index)
+{
+    if (index > 7)
+    {
+        index = 7;
+    }
+
+    return static_cast<Condition>(index);
+}
+
+template <typename TBus>
+bool CpuCore<TBus>::evaluateCondition(Condition c)
+{
+    if (c != Condition::NOT_CARRY && c != Condition::CARRY)
+        materializeFlags();
+
+    const auto& flags = registers.getAf().getLow();
+
+    switch (c)
+    {
+        case Condition::NOT_ZERO:
+            return !flags.Z;
+        case Condition::ZERO:
+            return flags.Z;
+        case Condition::NOT_CARRY:
+            return !flags.C;
+        case Condition::CARRY:
+            return flags.C;
+        case Condition::ODD:
+            return !flags.P;
+        case Condition::EVEN:
+            return flags.P;
+        case Condition::POSITIVE:
+            return !flags.S;
+        case Condition::MINUS:
+            return flags.S;
+    }
+}
+
+template <typename TBus>
+u16 CpuCore<TBus>::resolveWriteAddress(MemoryWrite write, u16 operand)
+{
+    switch (write)
+    {
+        case MemoryWrite::HL: return registers.getHl().getRaw();
+        case MemoryWrite::BC: return registers.getBc().getRaw();
+        case MemoryWrite::DE: return registers.getDe().getRaw();
+        case MemoryWrite::IMMEDATE_BYTE:
+        case MemoryWrite::IMMEDATE_WORD: return operand;
+        case MemoryWrite::STACK_PUSH: return registers.getSp() - 2;
+        case MemoryWrite::STACK_TOP: return registers.getSp();
+        default: return 0;
+    }
+}
+
+template <typename TBus>
+u16 CpuCore<TBus>::fetchImmedate16()
+{
+    auto& pc = registers.getPc();
+    u16 immedate = bus->fetchWordFromMemory(pc);
+    pc += 2;
+    return immedate;
+}
+
+template <typename TBus>
+u8 CpuCore<TBus>::fetchImmedate8()
+{
+    auto& pc = registers.getPc();
+    u8 immedate = bus->fetchFromMemory(pc);
+    pc++;
+    return immedate;
+}
+
+template <typename TBus>
+u16 CpuCore<TBus>::popFromStack16()
+{
+    auto& sp = registers.getSp();
+    u16 result = bus->readWordFromMemory(sp);
+    sp += 2;
+    return result;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::pushIntoStack16(u16 value)
+{
+    // High byte goes above low byte, so value is stored in memory little endian
+    auto& sp = registers.getSp();
+    sp -= 2;
+    bus->writeWordIntoMemory(sp, value);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::applyAluResult(const AluResult& result)
+{
+    auto& accumulator = registers.getAf().getHigh();
+    auto& flags = registers.getAf().getLow();
+    accumulator = result.result;
+    flags.raw = (flags.raw & ~FlagTables::ALU_FLAGS) | result.flags;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::applyLogicResult(u8 result)
+{
+    // Logical instructions clear both carry flags
+    auto& accumulator = registers.getAf().getHigh();
+    auto& flags = registers.getAf().getLow();
+    accumulator = result;
+    flags.raw = (flags.raw & ~FlagTables::ALU_FLAGS) | flagTables.getSzp(result);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::deferAdd(u8 value, u8 carry, bool storeResult)
+{
+    auto& accumulator = registers.getAf().getHigh();
+    auto& flags = registers.getAf().getLow();
+    u8 addend = value + carry;
+    unsigned result = accumulator + addend;
+    lazyFlagsEntry = &flagTables.getAdd(accumulator, value, carry);
+    flags.raw = (flags.raw & ~FlagTables::CARRY) | ((result >> 8) & FlagTables::CARRY);
+    if (storeResult)
+        accumulator = result & 0xFF;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::deferSubtract(u8 value, u8 borrow, bool storeResult)
+{
+    auto& accumulator = registers.getAf().getHigh();
+    auto& flags = registers.getAf().getLow();
+    u8 negated = ~(value + borrow) + 1;
+    unsigned result = accumulator + negated;
+    lazyFlagsEntry = &flagTables.getSubtract(accumulator, value, borrow);
+    flags.raw = (flags.raw & ~FlagTables::CARRY) | (~(result >> 8) & FlagTables::CARRY);
+    if (storeResult)
+        accumulator = result & 0xFF;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::deferLogic(u8 result)
+{
+    auto& accumulator = registers.getAf().getHigh();
+    auto& flags = registers.getAf().getLow();
+    lazyFlagsEntry = &flagTables.getLogic(result);
+    flags.raw &= ~FlagTables::CARRY;
+    accumulator = result;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::nop()
+{
+    // NOP - No Operation
+    // Left as a method for possible future implementation of CPU clock
+}
+
+template <typename TBus>
+void CpuCore<TBus>::lxi(u16& reg, u16 immedate)
+{
+    // LXI - Load Extended Immedate
+    reg = immedate;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::dad(u16& reg)
+{
+    // DAD - Double Add
+    auto& hl = registers.getHl().getRaw();
+    auto& flags = registers.getAf().getLow();
+    unsigned result = hl + reg;
+    flags.C = result >> 16;
+    hl = result & 0xFFFF;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::stax(u16& reg)
+{
+    // STAX - Store Accumulator Extended
+    u16 addr = reg;
+    auto& accumulator = registers.getAf().getHigh();
+    bus->writeIntoMemory(addr, accumulator);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::shld(u16 addr)
+{
+    // SHLD - Store HL Direct
+    auto& hl = registers.getHl().getRaw();
+    bus->writeWordIntoMemory(addr, hl);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::sta(u16 addr)
+{
+    // STA - Store Accumulator
+    auto& accumulator = registers.getAf().getHigh();
+    bus->writeIntoMemory(addr, accumulator);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::ldax(u16& reg)
+{
+    // LDAX - Load Accumulator Extended
+    u16 addr = reg;
+    auto& accumulator = registers.getAf().getHigh();
+    accumulator = bus->readFromMemory(addr);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::lhld(u16 addr)
+{
+    // LHLD - Load HL Direct
+    auto& hl = registers.getHl().getRaw();
+    hl = bus->readWordFromMemory(addr);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::lda(u16 addr)
+{
+    // LDA - Load Accumulator
+    auto& accumulator = registers.getAf().getHigh();
+    accumulator = bus->readFromMemory(addr);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::inx(u16& reg)
+{
+    // INX - Increment Extended
+    reg++;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::dcx(u16& reg)
+{
+    // DCX - Decrement Extended
+    reg--;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::inr(u8& reg)
+{
+    // INR - Increment
+    if (lazyFlagsEnabled)
+    {
+        lazyFlagsEntry = &flagTables.getIncrement(reg);
+        reg++;
+        return;
+    }
+    auto& flags = registers.getAf().getLow();
+    const auto& result = flagTables.getIncrement(reg);
+    reg = result.result;
+    flags.raw = (flags.raw & ~FlagTables::INCREMENT_FLAGS) | result.flags;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::dcr(u8& reg)
+{
+    // DCR - Decrement
+    if (lazyFlagsEnabled)
+    {
+        lazyFlagsEntry = &flagTables.getDecrement(reg);
+        reg--;
+        return;
+    }
+    auto& flags = registers.getAf().getLow();
+    const auto& result = flagTables.getDecrement(reg);
+    reg = result.result;
+    flags.raw = (flags.raw & ~FlagTables::INCREMENT_FLAGS) | result.flags;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::mvi(u8& reg, u8 immedate)
+{
+    // MVI - Move Immedate
+    reg = immedate;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::rlc()
+{
+    // RLC - Rotate Accumulator Left
+    auto& accumulator = registers.getAf().getHigh();
+    auto& flags = registers.getAf().getLow();
+    flags.C = (accumulator >> 7) & 0x1;
+    accumulator = (accumulator << 1) | flags.C;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::rrc()
+{
+    // RRC - Rotate Accumulator Right
+    auto& accumulator = registers.getAf().getHigh();
+    auto& flags = registers.getAf().getLow();
+    flags.C = accumulator & 0x1;
+    accumulator = (accumulator >> 1) | (flags.C << 7);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::ral()
+{
+    // RAL - Rotate Accumulator Left through Carry
+    auto& accumulator = registers.getAf().getHigh();
+    auto& flags = registers.getAf().getLow();
+    auto oldCarry = flags.C;
+    flags.C = (accumulator >> 7) & 0x1;
+    accumulator = (accumulator << 1) | oldCarry;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::rar()
+{
+    // RAR - Rotate Accumulator Right through Carry
+    auto& accumulator = registers.getAf().getHigh();
+    auto& flags = registers.getAf().getLow();
+    auto oldCarry = flags.C;
+    flags.C = accumulator & 0x1;
+    accumulator = (accumulator >> 1) | (oldCarry << 7);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::daa()
+{
+    // DAA - Decimal Adjust Accumulator
+    materializeFlags();
+    auto& accumulator = registers.getAf().getHigh();
+    auto& flags = registers.getAf().getLow();
+    applyAluResult(flagTables.getDecimalAdjust(accumulator, flags.C, flags.AC));
+}
+
+template <typename TBus>
+void CpuCore<TBus>::cma()
+{
+    // CMA - Complement Accumulator
+    auto& accumulator = registers.getAf().getHigh();
+    accumulator = ~accumulator;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::stc()
+{
+    // STC - Set Carry
+    auto& flags = registers.getAf().getLow();
+    flags.C = 1;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::cmc()
+{
+    // CMC - Complement Carry
+    auto& flags = registers.getAf().getLow();
+    flags.C = ~flags.C;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::mov(u8& destination, u8& source)
+{
+    // MOV - Move register
+    destination = source;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::halt()
+{
+    // HALT - Halt
+    halted = true;
+    cycleTarget = 0;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::add(u8& src)
+{
+    // ADD - Add to accumulator
+    adi(src);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::adc(u8& src)
+{
+    // ADC - Add with Carry
+    aci(src);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::sub(u8& src)
+{
+    // SUB - Subtract from accumulator
+    sui(src);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::sbb(u8& src)
+{
+    // SBB - Subtract with Borrow
+    sbi(src);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::ana(u8& src)
+{
+    // ANA - And Accumulator
+    ani(src);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::xra(u8& src)
+{
+    // XRA - Xor Accumulator
+    xri(src);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::ora(u8& src)
+{
+    // ORA - Or Accumulator
+    ori(src);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::cmp(u8& src)
+{
+    // CMP - Compare with accumulator
+    cpi(src);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::ret(Condition c)
+{
+    // R[cc] - Conditional Return
+    bool shouldReturn = evaluateCondition(c);
+    if (shouldReturn)
+    {
+        reportReturn();
+        auto& pc = registers.getPc();
+        auto addr = popFromStack16();
+        pc = addr;
+        cycles += OpcodeTraits::CONDITION_MET_EXTRA_CYCLES;
+    }
+}
+
+template <typename TBus>
+void CpuCore<TBus>::ret()
+{
+    // RET - Return
+    reportReturn();
+    auto& pc = registers.getPc();
+    auto addr = popFromStack16();
+    pc = addr;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::pop(u16& reg)
+{
+    // POP - Pop from stack
+    materializeFlags();
+    reg = popFromStack16();
+}
+
+template <typename TBus>
+void CpuCore<TBus>::push(u16& reg)
+{
+    // PUSH - Push into stack
+    materializeFlags();
+    pushIntoStack16(reg);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::pchl()
+{
+    // PCHL - Load PC from HL
+    auto& hl = registers.getHl().getRaw();
+    auto& pc = registers.getPc();
+    pc = hl;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::sphl()
+{
+    // SPHL - Load SP from HL
+    auto& hl = registers.getHl().getRaw();
+    auto& sp = registers.getSp();
+    sp = hl;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::jmp(Condition c, u16 addr)
+{
+    // J[cc] - Conditional Jump
+    bool shouldJump = evaluateCondition(c);
+    if (shouldJump)
+    {
+        auto& pc = registers.getPc();
+        pc = addr;
+    }
+}
+
+template <typename TBus>
+void CpuCore<TBus>::jmp(u16 addr)
+{
+    // JMP - Jump
+    auto& pc = registers.getPc();
+    pc = addr;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::out(u8 port)
+{
+    // OUT - Write to output port
+    auto& a = registers.getAf().getHigh();
+    bus->writeIntoOutputPort(port, a);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::in(u8 port)
+{
+    // IN - Read from input port
+    auto& a = registers.getAf().getHigh();
+    a = bus->readFromInputPort(port);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::ei()
+{
+    // EI - Enable Interrupts
+    interrupt_enable = true;
+    interruptDelayed = true;
+    interruptDelayPc = registers.getPc();
+
+    // Interrupts are enabled after next instruction, pending one is taken then
+    if (interruptPending)
+    {
+        cycleTarget = std::min<u64>(cycleTarget, cycles + OpcodeTraits::getCycles(0xFB) + 1);
+    }
+}
+
+template <typename TBus>
+void CpuCore<TBus>::di()
+{
+    // DI - Disable Interrupts
+    interrupt_enable = false;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::xthl()
+{
+    // XTHL - Exchange HL with memory contents pointed by SP
+    auto& hl = registers.getHl().getRaw();
+    auto& sp = registers.getSp();
+    u16 memValue = bus->readWordFromMemory(sp);
+    bus->writeWordIntoMemory(sp, hl);
+    hl = memValue;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::xchg()
+{
+    // XCHG - Exchange HL with contents of DE
+    auto& hl = registers.getHl().getRaw();
+    auto& de = registers.getDe().getRaw();
+    auto hlTemp = hl;
+    hl = de;
+    de = hlTemp;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::call(Condition c, u16 addr)
+{
+    // C[cc] - Conditional Call
+    bool shouldCall = evaluateCondition(c);
+    if (shouldCall)
+    {
+        auto& pc = registers.getPc();
+        pushIntoStack16(pc);
+        reportCall(addr, pc);
+        pc = addr;
+        cycles += OpcodeTraits::CONDITION_MET_EXTRA_CYCLES;
+    }
+}
+
+template <typename TBus>
+void CpuCore<TBus>::call(u16 addr)
+{
+    // CALL - Call
+    auto& pc = registers.getPc();
+    pushIntoStack16(pc);
+    reportCall(addr, pc);
+    pc = addr;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::adi(u8 immedate)
+{
+    // ADI - Add Immedate
+    if (lazyFlagsEnabled)
+    {
+        deferAdd(immedate, 0, true);
+        return;
+    }
+    auto& accumulator = registers.getAf().getHigh();
+    applyAluResult(flagTables.getAdd(accumulator, immedate, 0));
+}
+
+template <typename TBus>
+void CpuCore<TBus>::aci(u8 immedate)
+{
+    // ACI - Add Immedate with Carry
+    if (lazyFlagsEnabled)
+    {
+        deferAdd(immedate, registers.getAf().getLow().C, true);
+        return;
+    }
+    auto& accumulator = registers.getAf().getHigh();
+    auto& flags = registers.getAf().getLow();
+    applyAluResult(flagTables.getAdd(accumulator, immedate, flags.C));
+}
+
+template <typename TBus>
+void CpuCore<TBus>::sui(u8 immedate)
+{
+    // SUI - Subtract Immedate
+    if (lazyFlagsEnabled)
+    {
+        deferSubtract(immedate, 0, true);
+        return;
+    }
+    auto& accumulator = registers.getAf().getHigh();
+    applyAluResult(flagTables.getSubtract(accumulator, immedate, 0));
+}
+
+template <typename TBus>
+void CpuCore<TBus>::sbi(u8 immedate)
+{
+    // SBI - Subtract Immedate with Borrow
+    if (lazyFlagsEnabled)
+    {
+        deferSubtract(immedate, registers.getAf().getLow().C, true);
+        return;
+    }
+    auto& accumulator = registers.getAf().getHigh();
+    auto& flags = registers.getAf().getLow();
+    applyAluResult(flagTables.getSubtract(accumulator, immedate, flags.C));
+}
+
+template <typename TBus>
+void CpuCore<TBus>::ani(u8 immedate)
+{
+    // ANI - And Immedate
+    if (lazyFlagsEnabled)
+    {
+        deferLogic(registers.getAf().getHigh() & immedate);
+        return;
+    }
+    auto& accumulator = registers.getAf().getHigh();
+    applyLogicResult(accumulator & immedate);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::xri(u8 immedate)
+{
+    // XRI - Xor Immedate
+    if (lazyFlagsEnabled)
+    {
+        deferLogic(registers.getAf().getHigh() ^ immedate);
+        return;
+    }
+    auto& accumulator = registers.getAf().getHigh();
+    applyLogicResult(accumulator ^ immedate);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::ori(u8 immedate)
+{
+    // ORI - Or Immedate
+    if (lazyFlagsEnabled)
+    {
+        deferLogic(registers.getAf().getHigh() | immedate);
+        return;
+    }
+    auto& accumulator = registers.getAf().getHigh();
+    applyLogicResult(accumulator | immedate);
+}
+
+template <typename TBus>
+void CpuCore<TBus>::cpi(u8 immedate)
+{
+    // CPI - Compare Immedate
+    if (lazyFlagsEnabled)
+    {
+        deferSubtract(immedate, 0, false);
+        return;
+    }
+    auto& accumulator = registers.getAf().getHigh();
+    auto& flags = registers.getAf().getLow();
+    const auto& result = flagTables.getSubtract(accumulator, immedate, 0);
+    flags.raw = (flags.raw & ~FlagTables::ALU_FLAGS) | result.flags;
+}
+
+template <typename TBus>
+void CpuCore<TBus>::rst(u8 vector)
+{
+    // RST - Reset (call to reset vector)
+    auto& pc = registers.getPc();
+    pushIntoStack16(pc);
+    reportCall(vector, pc);
+    pc = vector;
+}
\ No newline at end of file
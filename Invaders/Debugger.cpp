@@ -0,0 +1,102 @@
+#include "Debugger.hpp"
+
+#include <algorithm>
+
+Debugger::Debugger()
+    : breakpoints(0x10000, false)
+    , breakpointCount(0)
+    , watchpoints()
+    , watchedAccesses(0x10000, 0)
+    , stop()
+    , resumingFromBreakpoint(false)
+{
+}
+
+void Debugger::addBreakpoint(u16 addr)
+{
+    if (!breakpoints[addr])
+    {
+        breakpoints[addr] = true;
+        breakpointCount++;
+    }
+}
+
+void Debugger::removeBreakpoint(u16 addr)
+{
+    if (breakpoints[addr])
+    {
+        breakpoints[addr] = false;
+        breakpointCount--;
+    }
+}
+
+bool Debugger::hasBreakpoint(u16 addr) const
+{
+    return breakpoints[addr];
+}
+
+void Debugger::addWatchpoint(u16 first, u16 last, WatchAccess access)
+{
+    watchpoints.push_back({ first, std::max(first, last), access });
+    updateWatchedAccesses();
+}
+
+void Debugger::removeWatchpoint(u16 first, u16 last)
+{
+    watchpoints.erase(std::remove_if(watchpoints.begin(), watchpoints.end(),
+                                     [first, last](const Watchpoint& w) { return w.first == first && w.last == last; }),
+                      watchpoints.end());
+    updateWatchedAccesses();
+}
+
+void Debugger::clear()
+{
+    std::fill(breakpoints.begin(), breakpoints.end(), false);
+    breakpointCount = 0;
+    watchpoints.clear();
+    updateWatchedAccesses();
+    resumingFromBreakpoint = false;
+}
+
+bool Debugger::isActive() const
+{
+    return breakpointCount != 0 || !watchpoints.empty();
+}
+
+bool Debugger::hasStopped() const
+{
+    return stop.reason != StopReason::NONE;
+}
+
+const DebugStop& Debugger::getStop() const
+{
+    return stop;
+}
+
+void Debugger::resume()
+{
+    stop = DebugStop();
+}
+
+void Debugger::stopOnWatchpoint(u16 pc, u16 addr, WatchAccess access, u8 value)
+{
+    stop = { StopReason::WATCHPOINT, pc, addr, access, value };
+}
+
+void Debugger::stopOnBreakpoint(u16 pc)
+{
+    stop = { StopReason::BREAKPOINT, pc, pc, WatchAccess::READ, 0 };
+    resumingFromBreakpoint = true;
+}
+
+void Debugger::updateWatchedAccesses()
+{
+    std::fill(watchedAccesses.begin(), watchedAccesses.end(), 0);
+    for (const auto& watchpoint : watchpoints)
+    {
+        for (u32 addr = watchpoint.first; addr <= watchpoint.last; addr++)
+        {
+            watchedAccesses[addr] |= static_cast<u8>(watchpoint.access);
+        }
+    }
+}
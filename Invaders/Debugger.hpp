@@ -0,0 +1,109 @@
+#pragma once
+
+#include <vector>
+
+#include "Types.hpp"
+
+enum class WatchAccess
+{
+    READ = 1,
+    WRITE = 2,
+    READ_WRITE = 3
+};
+
+enum class StopReason
+{
+    NONE = 0,
+    BREAKPOINT = 1,   // PC reached breakpoint, instruction there was not executed yet
+    WATCHPOINT = 2    // Instruction accessed watched memory, PC points past it
+};
+
+struct DebugStop
+{
+    StopReason reason;
+    u16 pc;              // Breakpoint address, or address of instruction which accessed memory
+    u16 addr;            // Watched address which was accessed
+    WatchAccess access;  // READ or WRITE
+    u8 value;            // Value read or written
+};
+
+// Breakpoints on PC and watchpoints on memory ranges. Cpu it is attached to
+// checks them in a separate instantiation of its run loop, used only for batches
+// started while debugger has any breakpoint or watchpoint, so normal runs do not
+// pay for it. Stop ends run() early.
+//
+// Memory accessed by instruction is resolved from its operands, so accesses
+// done by taken interrupts and by devices on the bus are not watched.
+class Debugger
+{
+    public:
+        Debugger();
+
+        ~Debugger() = default;
+
+        void addBreakpoint(u16 addr);
+
+        void removeBreakpoint(u16 addr);
+
+        bool hasBreakpoint(u16 addr) const;
+
+        // Watches addresses from first to last, inclusive
+        void addWatchpoint(u16 first, u16 last, WatchAccess access);
+
+        void removeWatchpoint(u16 first, u16 last);
+
+        // Removes all breakpoints and watchpoints
+        void clear();
+
+        // Whether there is any breakpoint or watchpoint
+        bool isActive() const;
+
+        // Whether cpu stopped since last resume()
+        bool hasStopped() const;
+
+        const DebugStop& getStop() const;
+
+        void resume();
+
+        // Called by cpu before executing instruction at given address. Breakpoint
+        // the cpu stopped on is passed once after stop, so the next run continues.
+        bool checkBreakpoint(u16 pc)
+        {
+            const bool resuming = resumingFromBreakpoint;
+            resumingFromBreakpoint = false;
+            if (breakpoints[pc] && !resuming)
+            {
+                stopOnBreakpoint(pc);
+                return true;
+            }
+            return false;
+        }
+
+        bool isWatched(u16 addr, WatchAccess access) const
+        {
+            return (watchedAccesses[addr] & static_cast<u8>(access)) != 0;
+        }
+
+        // Called by cpu after instruction accessed watched memory
+        void stopOnWatchpoint(u16 pc, u16 addr, WatchAccess access, u8 value);
+
+    private:
+        struct Watchpoint
+        {
+            u16 first;
+            u16 last;
+            WatchAccess access;
+        };
+
+        void stopOnBreakpoint(u16 pc);
+
+        void updateWatchedAccesses();
+
+        std::vector<bool> breakpoints;
+        std::size_t breakpointCount;
+        std::vector<Watchpoint> watchpoints;
+        // WatchAccess bits of every address
+        std::vector<u8> watchedAccesses;
+        DebugStop stop;
+        bool resumingFromBreakpoint;
+};
@@ -0,0 +1,101 @@
+#include <cstdio>
+
+#include "Disassembler.hpp"
+#include "OpcodeTraits.hpp"
+
+namespace
+{
+    const char* const REGISTERS[] = { "B", "C", "D", "E", "H", "L", "M", "A" };
+    const char* const REGISTER_PAIRS[] = { "B", "D", "H", "SP" };
+    const char* const STACK_REGISTER_PAIRS[] = { "B", "D", "H", "PSW" };
+    const char* const CONDITIONS[] = { "NZ", "Z", "NC", "C", "PO", "PE", "P", "M" };
+    const char* const ALU_OPERATIONS[] = { "ADD", "ADC", "SUB", "SBB", "ANA", "XRA", "ORA", "CMP" };
+    const char* const ALU_IMMEDATE_OPERATIONS[] = { "ADI", "ACI", "SUI", "SBI", "ANI", "XRI", "ORI", "CPI" };
+    const char* const ACCUMULATOR_OPERATIONS[] = { "RLC", "RRC", "RAL", "RAR", "DAA", "CMA", "STC", "CMC" };
+    const char* const STORES[] = { "STAX B", "STAX D", "SHLD", "STA" };
+    const char* const LOADS[] = { "LDAX B", "LDAX D", "LHLD", "LDA" };
+    const char* const MISC_OPERATIONS[] = { "JMP", "JMP", "OUT", "IN", "XTHL", "XCHG", "DI", "EI" };
+
+    // Hexadecimal number with H suffix, prefixed with 0 when it would start with a letter
+    std::string toIntelHex(unsigned value, unsigned digits)
+    {
+        char buffer[16];
+        std::snprintf(buffer, sizeof(buffer), "%0*XH", static_cast<int>(digits), value);
+        std::string result = buffer;
+        if (result[0] >= 'A' && result[0] <= 'F')
+        {
+            result.insert(result.begin(), '0');
+        }
+        return result;
+    }
+}
+
+std::string Disassembler::getMnemonic(u8 opcode)
+{
+    const auto x = OpcodeTraits::getX(opcode);
+    const auto y = OpcodeTraits::getY(opcode);
+    const auto z = OpcodeTraits::getZ(opcode);
+    const auto p = OpcodeTraits::getP(opcode);
+    const auto q = OpcodeTraits::getQ(opcode);
+
+    if (x == 0)
+    {
+        switch (z)
+        {
+            case 0: return "NOP";
+            case 1: return std::string(q == 0 ? "LXI " : "DAD ") + REGISTER_PAIRS[p];
+            case 2: return q == 0 ? STORES[p] : LOADS[p];
+            case 3: return std::string(q == 0 ? "INX " : "DCX ") + REGISTER_PAIRS[p];
+            case 4: return std::string("INR ") + REGISTERS[y];
+            case 5: return std::string("DCR ") + REGISTERS[y];
+            case 6: return std::string("MVI ") + REGISTERS[y];
+            default: return ACCUMULATOR_OPERATIONS[y];
+        }
+    }
+    if (x == 1)
+    {
+        if (y == 6 && z == 6)
+            return "HLT";
+        return std::string("MOV ") + REGISTERS[y] + "," + REGISTERS[z];
+    }
+    if (x == 2)
+    {
+        return std::string(ALU_OPERATIONS[y]) + " " + REGISTERS[z];
+    }
+
+    switch (z)
+    {
+        case 0: return std::string("R") + CONDITIONS[y];
+        case 1:
+            if (q == 0)
+                return std::string("POP ") + STACK_REGISTER_PAIRS[p];
+            return p < 2 ? "RET" : (p == 2 ? "PCHL" : "SPHL");
+        case 2: return std::string("J") + CONDITIONS[y];
+        case 3: return MISC_OPERATIONS[y];
+        case 4: return std::string("C") + CONDITIONS[y];
+        case 5:
+            if (q == 0)
+                return std::string("PUSH ") + STACK_REGISTER_PAIRS[p];
+            return "CALL";
+        case 6: return ALU_IMMEDATE_OPERATIONS[y];
+        default: return "RST " + std::to_string(y);
+    }
+}
+
+std::string Disassembler::disassemble(u8 opcode, u16 operand)
+{
+    const auto mnemonic = getMnemonic(opcode);
+    const auto length = OpcodeTraits::getLength(opcode);
+    if (length == 1)
+    {
+        return mnemonic;
+    }
+
+    // Instructions with register operand get immedate after comma
+    const auto separator = mnemonic.find(' ') == std::string::npos ? " " : ",";
+    if (length == 2)
+    {
+        return mnemonic + separator + toIntelHex(operand & 0xFF, 2);
+    }
+    return mnemonic + separator + toIntelHex(operand, 4);
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+#include <string>
+
+#include "Types.hpp"
+
+// Intel style 8080 mnemonics, used by diagnostic reports and tools
+class Disassembler
+{
+    public:
+        // Mnemonic with register operands, without immedate operand (e.g. "MVI B")
+        static std::string getMnemonic(u8 opcode);
+
+        // Whole instruction with immedate operand (e.g. "MVI B,40H", "JNZ 0105H").
+        // Operand is ignored for instructions without one.
+        static std::string disassemble(u8 opcode, u16 operand);
+};
@@ -0,0 +1,7 @@
+#pragma once
+
+enum class DispatchMode
+{
+    DECODER = 0, // Opcode split into bitfields and decoded on every instruction
+    TABLE = 1    // Opcode used as index into table of handlers specialized at compile time
+};
@@ -0,0 +1,103 @@
+#include "ExecutableMemory.hpp"
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <unistd.h>
+#endif
+
+ExecutableMemory::ExecutableMemory(std::size_t size)
+    : data(nullptr)
+    , size(0)
+    , pageSize(0)
+{
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    pageSize = info.dwPageSize;
+
+    void* allocated = VirtualAlloc(nullptr, size, MEM_COMMIT | MEM_RESERVE, PAGE_READWRITE);
+    if (allocated == nullptr)
+    {
+        return;
+    }
+#else
+    pageSize = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+
+    void* allocated = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if (allocated == MAP_FAILED)
+    {
+        return;
+    }
+#endif
+
+    data = static_cast<u8*>(allocated);
+    this->size = size;
+}
+
+ExecutableMemory::~ExecutableMemory()
+{
+    if (data == nullptr)
+    {
+        return;
+    }
+
+#ifdef _WIN32
+    VirtualFree(data, 0, MEM_RELEASE);
+#else
+    munmap(data, size);
+#endif
+}
+
+bool ExecutableMemory::isValid() const
+{
+    return data != nullptr;
+}
+
+u8* ExecutableMemory::getData() const
+{
+    return data;
+}
+
+std::size_t ExecutableMemory::getSize() const
+{
+    return size;
+}
+
+bool ExecutableMemory::makeWritable(std::size_t offset, std::size_t length)
+{
+    return protect(offset, length, false);
+}
+
+bool ExecutableMemory::makeExecutable(std::size_t offset, std::size_t length)
+{
+    if (!protect(offset, length, true))
+    {
+        return false;
+    }
+
+#ifdef _WIN32
+    FlushInstructionCache(GetCurrentProcess(), data + offset, length);
+#endif
+    return true;
+}
+
+bool ExecutableMemory::protect(std::size_t offset, std::size_t length, bool executable)
+{
+    if (data == nullptr || length == 0 || offset + length > size)
+    {
+        return false;
+    }
+
+    const auto first = offset / pageSize * pageSize;
+    const auto last = (offset + length + pageSize - 1) / pageSize * pageSize;
+    const auto protectedSize = (last < size ? last : size) - first;
+
+#ifdef _WIN32
+    DWORD previous;
+    return VirtualProtect(data + first, protectedSize, executable ? PAGE_EXECUTE_READ : PAGE_READWRITE, &previous) != 0;
+#else
+    return mprotect(data + first, protectedSize, executable ? PROT_READ | PROT_EXEC : PROT_READ | PROT_WRITE) == 0;
+#endif
+}
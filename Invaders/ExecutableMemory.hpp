@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Types.hpp"
+
+// Block of memory for code generated at runtime. Pages are never writable and
+// executable at the same time: memory starts writable, and ranges have to be
+// made executable after code is written into them and writable again before
+// it is overwritten. Allocation may fail, which is reported by isValid().
+class ExecutableMemory
+{
+    public:
+        ExecutableMemory(std::size_t size);
+
+        ~ExecutableMemory();
+
+        ExecutableMemory(const ExecutableMemory&) = delete;
+
+        ExecutableMemory& operator=(const ExecutableMemory&) = delete;
+
+        bool isValid() const;
+
+        u8* getData() const;
+
+        std::size_t getSize() const;
+
+        // Both change protection of whole pages covering given range,
+        // returning false when system refuses it
+        bool makeWritable(std::size_t offset, std::size_t length);
+        bool makeExecutable(std::size_t offset, std::size_t length);
+
+    private:
+        bool protect(std::size_t offset, std::size_t length, bool executable);
+
+        u8* data;
+        std::size_t size;
+        std::size_t pageSize;
+};
@@ -0,0 +1,107 @@
+#include "FlagTables.hpp"
+
+const FlagTables& FlagTables::getInstance()
+{
+    static const FlagTables instance;
+    return instance;
+}
+
+FlagTables::FlagTables()
+{
+    for (unsigned value = 0; value < 0x100; value++)
+    {
+        szpTable[value] = computeSzp(value);
+    }
+
+    for (unsigned carry = 0; carry < 2; carry++)
+    {
+        for (unsigned accumulator = 0; accumulator < 0x100; accumulator++)
+        {
+            for (unsigned value = 0; value < 0x100; value++)
+            {
+                const auto index = (carry << 16) | (accumulator << 8) | value;
+                addTable[index] = computeAdd(accumulator, value, carry);
+                subtractTable[index] = computeSubtract(accumulator, value, carry);
+            }
+        }
+    }
+
+    for (unsigned value = 0; value < 0x100; value++)
+    {
+        logicTable[value] = { static_cast<u8>(value), szpTable[value] };
+
+        u8 incremented = value + 1;
+        u8 incrementAuxCarry = (value & 0xF) == 0xF ? AUX_CARRY : 0;
+        incrementTable[value] = { incremented, static_cast<u8>(computeSzp(incremented) | incrementAuxCarry) };
+
+        u8 decremented = value - 1;
+        u8 decrementAuxCarry = (value & 0xF) == 0x0 ? AUX_CARRY : 0;
+        decrementTable[value] = { decremented, static_cast<u8>(computeSzp(decremented) | decrementAuxCarry) };
+    }
+
+    for (unsigned index = 0; index < 0x400; index++)
+    {
+        const u8 accumulator = index & 0xFF;
+        const u8 auxCarry = (index >> 8) & 0x1;
+        const u8 carry = (index >> 9) & 0x1;
+        decimalAdjustTable[index] = computeDecimalAdjust(accumulator, carry, auxCarry);
+    }
+}
+
+u8 FlagTables::computeSzp(u8 value)
+{
+    auto counter = 0;
+    for (auto bits = value; bits > 0; bits >>= 1)
+    {
+        counter += bits & 0x1;
+    }
+
+    u8 flags = 0;
+    flags |= (value & 0x80) ? SIGN : 0;
+    flags |= value == 0 ? ZERO : 0;
+    flags |= !(counter % 2) ? PARITY : 0;
+    return flags;
+}
+
+AluResult FlagTables::computeAdd(u8 accumulator, u8 value, u8 carry)
+{
+    u8 addend = value + carry;
+    unsigned result = accumulator + addend;
+
+    u8 flags = computeSzp(result & 0xFF);
+    flags |= (accumulator & 0xF) + (addend & 0xF) > 0xF ? AUX_CARRY : 0;
+    flags |= (result >> 8) & 0x1 ? CARRY : 0;
+    return { static_cast<u8>(result & 0xFF), flags };
+}
+
+AluResult FlagTables::computeSubtract(u8 accumulator, u8 value, u8 borrow)
+{
+    // Subtraction is performed as addition of two's complement,
+    // carry flag holds inverted carry out of that addition
+    u8 negated = ~(value + borrow) + 1;
+    unsigned result = accumulator + negated;
+
+    u8 flags = computeSzp(result & 0xFF);
+    flags |= (accumulator & 0xF) + (negated & 0xF) > 0xF ? AUX_CARRY : 0;
+    flags |= !((result >> 8) & 0x1) ? CARRY : 0;
+    return { static_cast<u8>(result & 0xFF), flags };
+}
+
+AluResult FlagTables::computeDecimalAdjust(u8 accumulator, u8 carry, u8 auxCarry)
+{
+    if ((accumulator & 0xF) > 0x9 || auxCarry)
+    {
+        auxCarry = (accumulator & 0xF) > 0x9;
+        accumulator += 0x6;
+    }
+    if (((accumulator >> 4) & 0xF) > 0x9 || carry)
+    {
+        carry = ((accumulator >> 4) & 0xF) > 0x9;
+        accumulator += (0x6 << 4);
+    }
+
+    u8 flags = computeSzp(accumulator);
+    flags |= auxCarry ? AUX_CARRY : 0;
+    flags |= carry ? CARRY : 0;
+    return { accumulator, flags };
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <array>
+
+#include "Types.hpp"
+
+// Result of 8 bit ALU operation together with flags it produces.
+// Flags are laid out the same way as in FlagRegister.
+struct AluResult
+{
+    u8 result;
+    u8 flags;
+};
+
+// Lookup tables replacing per-instruction flag computation.
+// Built once, on first use, by running reference ALU formulas
+// over every possible combination of operands.
+class FlagTables
+{
+    public:
+        static constexpr u8 CARRY = 0x01;
+        static constexpr u8 PARITY = 0x04;
+        static constexpr u8 AUX_CARRY = 0x10;
+        static constexpr u8 ZERO = 0x40;
+        static constexpr u8 SIGN = 0x80;
+
+        // Flags written by arithmetic and logical instructions
+        static constexpr u8 ALU_FLAGS = SIGN | ZERO | AUX_CARRY | PARITY | CARRY;
+        // Flags written by INR and DCR (carry is preserved)
+        static constexpr u8 INCREMENT_FLAGS = SIGN | ZERO | AUX_CARRY | PARITY;
+
+        static const FlagTables& getInstance();
+
+        // Sign, Zero and Parity flags of given value
+        u8 getSzp(u8 value) const
+        {
+            return szpTable[value];
+        }
+
+        // ADD/ADI (carry == 0) and ADC/ACI
+        const AluResult& getAdd(u8 accumulator, u8 value, u8 carry) const
+        {
+            return addTable[(carry << 16) | (accumulator << 8) | value];
+        }
+
+        // SUB/SUI/CMP/CPI (borrow == 0) and SBB/SBI
+        const AluResult& getSubtract(u8 accumulator, u8 value, u8 borrow) const
+        {
+            return subtractTable[(borrow << 16) | (accumulator << 8) | value];
+        }
+
+        // ANA/XRA/ORA and their immedate variants, indexed by result
+        const AluResult& getLogic(u8 result) const
+        {
+            return logicTable[result];
+        }
+
+        const AluResult& getIncrement(u8 value) const
+        {
+            return incrementTable[value];
+        }
+
+        const AluResult& getDecrement(u8 value) const
+        {
+            return decrementTable[value];
+        }
+
+        const AluResult& getDecimalAdjust(u8 accumulator, u8 carry, u8 auxCarry) const
+        {
+            return decimalAdjustTable[(carry << 9) | (auxCarry << 8) | accumulator];
+        }
+
+    private:
+        FlagTables();
+
+        static u8 computeSzp(u8 value);
+        static AluResult computeAdd(u8 accumulator, u8 value, u8 carry);
+        static AluResult computeSubtract(u8 accumulator, u8 value, u8 borrow);
+        static AluResult computeDecimalAdjust(u8 accumulator, u8 carry, u8 auxCarry);
+
+        std::array<u8, 0x100> szpTable;
+        std::array<AluResult, 0x20000> addTable;
+        std::array<AluResult, 0x20000> subtractTable;
+        std::array<AluResult, 0x100> logicTable;
+        std::array<AluResult, 0x100> incrementTable;
+        std::array<AluResult, 0x100> decrementTable;
+        std::array<AluResult, 0x400> decimalAdjustTable;
+};
@@ -0,0 +1,189 @@
+#include "GuestProfiler.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstdlib>
+#include <sstream>
+
+namespace
+{
+    std::string toHex(u16 value)
+    {
+        char buffer[8];
+        std::snprintf(buffer, sizeof(buffer), "%04X", value);
+        return buffer;
+    }
+}
+
+GuestProfiler::GuestProfiler(u32 sampleInterval)
+    : sampleInterval(std::max(sampleInterval, 1u))
+    , frames()
+    , symbols()
+    , samples()
+    , sampleCount(0)
+{
+    frames.reserve(MAX_DEPTH);
+}
+
+u32 GuestProfiler::getSampleInterval() const
+{
+    return sampleInterval;
+}
+
+bool GuestProfiler::loadSymbols(std::istream& in)
+{
+    std::string line;
+    while (std::getline(in, line))
+    {
+        std::istringstream fields(line);
+        std::string addrText;
+        std::string name;
+        if (!(fields >> addrText) || addrText[0] == ';' || addrText[0] == '#')
+        {
+            continue;
+        }
+
+        char* end = nullptr;
+        const auto addr = std::strtoul(addrText.c_str(), &end, 16);
+        if (*end != '\0' || addr > 0xFFFF || !(fields >> name))
+        {
+            return false;
+        }
+        addSymbol(static_cast<u16>(addr), name);
+    }
+    return true;
+}
+
+void GuestProfiler::addSymbol(u16 addr, const std::string& name)
+{
+    symbols[addr] = name;
+}
+
+std::size_t GuestProfiler::getSymbolCount() const
+{
+    return symbols.size();
+}
+
+std::string GuestProfiler::getSymbolName(u16 addr) const
+{
+    const auto symbol = findSymbol(addr);
+    return symbol != nullptr ? *symbol : toHex(addr);
+}
+
+void GuestProfiler::onCall(u16 target, u16 returnAddress, u16 sp)
+{
+    // Frames whose return address slot is reused were already left
+    unwindBelow(sp + 1u);
+    if (frames.size() == MAX_DEPTH)
+    {
+        frames.erase(frames.begin());
+    }
+    frames.push_back({ target, returnAddress, sp });
+}
+
+void GuestProfiler::onReturn(u16 sp)
+{
+    // Returning through frame leaves every frame called from it as well
+    unwindBelow(sp + 1u);
+}
+
+void GuestProfiler::onSample(u16 pc, u16 sp)
+{
+    unwindBelow(sp);
+
+    std::vector<u16> stack;
+    stack.reserve(frames.size() + 2);
+    stack.push_back(frames.empty() ? pc : frames.front().returnAddress);
+    for (const auto& frame : frames)
+    {
+        stack.push_back(frame.target);
+    }
+    stack.push_back(pc);
+
+    samples[stack]++;
+    sampleCount++;
+}
+
+u64 GuestProfiler::getSampleCount() const
+{
+    return sampleCount;
+}
+
+std::size_t GuestProfiler::getDepth() const
+{
+    return frames.size();
+}
+
+void GuestProfiler::reset()
+{
+    frames.clear();
+    samples.clear();
+    sampleCount = 0;
+}
+
+void GuestProfiler::writeFoldedStacks(std::ostream& out) const
+{
+    // Different addresses fall into the same routines, so stacks are merged by names
+    std::map<std::string, u64> folded;
+    for (const auto& sample : samples)
+    {
+        const auto& stack = sample.first;
+        std::vector<std::string> names;
+
+        const auto appendName = [&names](const std::string& name)
+        {
+            if (names.empty() || names.back() != name)
+            {
+                names.push_back(name);
+            }
+        };
+
+        if (const auto caller = findSymbol(stack.front()))
+        {
+            appendName(*caller);
+        }
+        for (std::size_t i = 1; i + 1 < stack.size(); i++)
+        {
+            appendName(getSymbolName(stack[i]));
+        }
+        if (const auto leaf = findSymbol(stack.back()))
+        {
+            appendName(*leaf);
+        }
+        if (names.empty())
+        {
+            // Code outside of any call without symbols is shown by address
+            names.push_back(toHex(stack.back()));
+        }
+
+        std::string line;
+        for (const auto& name : names)
+        {
+            line += (line.empty() ? "" : ";") + name;
+        }
+        folded[line] += sample.second;
+    }
+
+    for (const auto& line : folded)
+    {
+        out << line.first << " " << line.second << "\n";
+    }
+}
+
+void GuestProfiler::unwindBelow(u32 sp)
+{
+    while (!frames.empty() && frames.back().sp < sp)
+    {
+        frames.pop_back();
+    }
+}
+
+const std::string* GuestProfiler::findSymbol(u16 addr) const
+{
+    auto symbol = symbols.upper_bound(addr);
+    if (symbol == symbols.begin())
+    {
+        return nullptr;
+    }
+    return &(--symbol)->second;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <istream>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Types.hpp"
+
+// Statistical profiler of guest code. Cpu it is attached to samples PC every
+// given number of cycles, and reports CALL, RST (including taken interrupts)
+// and RET, from which shadow call stack is kept. Every sample is attributed to
+// the chain of routines it was taken in.
+//
+// Guest code does not always return the way it was called (return address is
+// popped and discarded, SP is reloaded), so frames are also dropped once stack
+// pointer moves above the slot of their return address.
+class GuestProfiler
+{
+    public:
+        static constexpr u32 DEFAULT_SAMPLE_INTERVAL = 1000;
+        // Deeper calls drop the outermost frame
+        static constexpr std::size_t MAX_DEPTH = 64;
+
+        explicit GuestProfiler(u32 sampleInterval = DEFAULT_SAMPLE_INTERVAL);
+
+        ~GuestProfiler() = default;
+
+        u32 getSampleInterval() const;
+
+        // Reads "<address> <name>" lines with hexadecimal address, like "01E4 BlockCopy".
+        // Empty lines and lines starting with ';' or '#' are skipped.
+        // Returns false on first line which cannot be parsed.
+        bool loadSymbols(std::istream& in);
+
+        void addSymbol(u16 addr, const std::string& name);
+
+        std::size_t getSymbolCount() const;
+
+        // Name of nearest symbol at or below address, or the address
+        // in hexadecimal when there is no such symbol
+        std::string getSymbolName(u16 addr) const;
+
+        // Called by cpu after return address was pushed, sp points at it
+        void onCall(u16 target, u16 returnAddress, u16 sp);
+
+        // Called by cpu before return address is popped, sp points at it
+        void onReturn(u16 sp);
+
+        void onSample(u16 pc, u16 sp);
+
+        u64 getSampleCount() const;
+
+        std::size_t getDepth() const;
+
+        // Clears samples and call stack, symbols are kept
+        void reset();
+
+        // One "outer;inner;leaf count" line per distinct stack, as consumed by
+        // flame graph tools. Stack starts with routine containing the outermost
+        // call and ends with routine containing sampled PC. Both are named only
+        // when symbols cover them, routines in between are named by call targets.
+        void writeFoldedStacks(std::ostream& out) const;
+
+    private:
+        struct Frame
+        {
+            u16 target;
+            u16 returnAddress;
+            u16 sp;
+        };
+
+        // Drops frames whose return address slot is below given stack pointer
+        void unwindBelow(u32 sp);
+
+        const std::string* findSymbol(u16 addr) const;
+
+        u32 sampleInterval;
+        std::vector<Frame> frames;
+        std::map<u16, std::string> symbols;
+        // Outermost caller, call targets and sampled PC
+        std::map<std::vector<u16>, u64> samples;
+        u64 sampleCount;
+};
@@ -0,0 +1,130 @@
+#include "HeatmapBus.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace
+{
+    const char MAGIC[8] = "I8080HM";
+    constexpr std::size_t ACCESS_COUNT = static_cast<std::size_t>(BusAccess::COUNT);
+
+    std::size_t getBucketSize(HeatmapGranularity granularity)
+    {
+        return granularity == HeatmapGranularity::PAGE ? HeatmapBus::PAGE_SIZE : 1;
+    }
+
+    void writeCounts(std::ostream& out, const std::vector<u64>& values)
+    {
+        out.write(reinterpret_cast<const char*>(values.data()), values.size() * sizeof(u64));
+    }
+}
+
+HeatmapBus::HeatmapBus(const std::shared_ptr<Bus>& busPtr)
+    : bus(busPtr)
+    , counts(ACCESS_COUNT * 0x10000, 0)
+    , portReads(256, 0)
+    , portWrites(256, 0)
+{
+}
+
+Bus& HeatmapBus::getBus()
+{
+    return *bus;
+}
+
+u64 HeatmapBus::getCount(BusAccess access, u16 addr) const
+{
+    return counts[static_cast<std::size_t>(access) * 0x10000 + addr];
+}
+
+u64 HeatmapBus::getPageCount(BusAccess access, u8 page) const
+{
+    u64 sum = 0;
+    for (std::size_t offset = 0; offset < PAGE_SIZE; offset++)
+    {
+        sum += getCount(access, static_cast<u16>(page * PAGE_SIZE + offset));
+    }
+    return sum;
+}
+
+u64 HeatmapBus::getPortReads(u8 port) const
+{
+    return portReads[port];
+}
+
+u64 HeatmapBus::getPortWrites(u8 port) const
+{
+    return portWrites[port];
+}
+
+void HeatmapBus::clear()
+{
+    std::fill(counts.begin(), counts.end(), 0);
+    std::fill(portReads.begin(), portReads.end(), 0);
+    std::fill(portWrites.begin(), portWrites.end(), 0);
+}
+
+void HeatmapBus::writeBinary(std::ostream& out, HeatmapGranularity granularity) const
+{
+    const auto bucketSize = getBucketSize(granularity);
+    HeatmapFileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FILE_VERSION;
+    header.granularity = static_cast<u32>(bucketSize);
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+
+    for (std::size_t access = 0; access < ACCESS_COUNT; access++)
+    {
+        writeCounts(out, getBuckets(static_cast<BusAccess>(access), bucketSize));
+    }
+    writeCounts(out, portReads);
+    writeCounts(out, portWrites);
+}
+
+void HeatmapBus::writeCsv(std::ostream& out, HeatmapGranularity granularity) const
+{
+    const auto bucketSize = getBucketSize(granularity);
+    std::vector<std::vector<u64>> buckets;
+    for (std::size_t access = 0; access < ACCESS_COUNT; access++)
+    {
+        buckets.push_back(getBuckets(static_cast<BusAccess>(access), bucketSize));
+    }
+
+    char hex[8];
+    out << "address,reads,writes,fetches,references\n";
+    for (std::size_t bucket = 0; bucket < buckets[0].size(); bucket++)
+    {
+        if (std::all_of(buckets.begin(), buckets.end(), [bucket](const std::vector<u64>& b) { return b[bucket] == 0; }))
+        {
+            continue;
+        }
+        std::snprintf(hex, sizeof(hex), "%04X", static_cast<unsigned>(bucket * bucketSize));
+        out << hex;
+        for (const auto& values : buckets)
+        {
+            out << "," << values[bucket];
+        }
+        out << "\n";
+    }
+
+    out << "port,reads,writes\n";
+    for (std::size_t port = 0; port < portReads.size(); port++)
+    {
+        if (portReads[port] != 0 || portWrites[port] != 0)
+        {
+            std::snprintf(hex, sizeof(hex), "%02X", static_cast<unsigned>(port));
+            out << hex << "," << portReads[port] << "," << portWrites[port] << "\n";
+        }
+    }
+}
+
+std::vector<u64> HeatmapBus::getBuckets(BusAccess access, std::size_t bucketSize) const
+{
+    std::vector<u64> buckets(0x10000 / bucketSize, 0);
+    for (std::size_t addr = 0; addr < 0x10000; addr++)
+    {
+        buckets[addr / bucketSize] += getCount(access, static_cast<u16>(addr));
+    }
+    return buckets;
+}
@@ -0,0 +1,185 @@
+#pragma once
+
+#include <memory>
+#include <ostream>
+#include <vector>
+
+#include "Bus.hpp"
+#include "OpcodeTraits.hpp"
+
+enum class BusAccess
+{
+    READ = 0,
+    WRITE = 1,
+    FETCH = 2,      // Opcodes and operands, including bytes fetched by decoders of caching backends
+    REFERENCE = 3,  // References handed out without direction, M operands count as reads and writes
+    COUNT = 4
+};
+
+enum class HeatmapGranularity
+{
+    ADDRESS = 0,  // Bucket per byte of memory
+    PAGE = 1      // Bucket per 256 byte page
+};
+
+// Heatmap file, little endian:
+//   char[8] magic "I8080HM" with terminating zero
+//   u32     version
+//   u32     granularity, bytes of memory per bucket (1 or PAGE_SIZE)
+//   u64[4][0x10000 / granularity]  memory accesses per bucket, BusAccess order
+//   u64[2][256]                    port reads, then port writes
+struct HeatmapFileHeader
+{
+    char magic[8];
+    u32 version;
+    u32 granularity;
+};
+
+// Bus decorator counting accesses to every memory address and I/O port. Word
+// accesses count as accesses to both bytes. Cpu has to be created over the
+// decorator to be counted, plain bus does not pay anything.
+class HeatmapBus final : public Bus
+{
+    public:
+        static constexpr std::size_t PAGE_SIZE = 0x100;
+        static constexpr u32 FILE_VERSION = 1;
+
+        HeatmapBus(const std::shared_ptr<Bus>& busPtr);
+
+        ~HeatmapBus() = default;
+
+        u8 readFromMemory(u16 addr) const override
+        {
+            count(BusAccess::READ, addr);
+            return bus->readFromMemory(addr);
+        }
+
+        void writeIntoMemory(u16 addr, u8 value) override
+        {
+            count(BusAccess::WRITE, addr);
+            bus->writeIntoMemory(addr, value);
+        }
+
+        u16 readWordFromMemory(u16 addr) const override
+        {
+            countWord(BusAccess::READ, addr);
+            return bus->readWordFromMemory(addr);
+        }
+
+        void writeWordIntoMemory(u16 addr, u16 value) override
+        {
+            countWord(BusAccess::WRITE, addr);
+            bus->writeWordIntoMemory(addr, value);
+        }
+
+        u8 fetchFromMemory(u16 addr) const override
+        {
+            count(BusAccess::FETCH, addr);
+            return bus->fetchFromMemory(addr);
+        }
+
+        u16 fetchWordFromMemory(u16 addr) const override
+        {
+            countWord(BusAccess::FETCH, addr);
+            return bus->fetchWordFromMemory(addr);
+        }
+
+        // Only bytes of the instruction are counted, not the whole window
+        u32 fetchInstructionWindow(u16 addr) const override
+        {
+            const u32 window = bus->fetchInstructionWindow(addr);
+            const auto length = OpcodeTraits::getLength(window & 0xFF);
+            for (unsigned i = 0; i < length; i++)
+            {
+                count(BusAccess::FETCH, static_cast<u16>(addr + i));
+            }
+            return window;
+        }
+
+        u8 peekMemory(u16 addr) const override
+        {
+            return bus->peekMemory(addr);
+        }
+
+        u32 peekInstructionWindow(u16 addr) const override
+        {
+            return bus->peekInstructionWindow(addr);
+        }
+
+        u8 readFromInputPort(u8 port) const override
+        {
+            portReads[port]++;
+            return bus->readFromInputPort(port);
+        }
+
+        void writeIntoOutputPort(u8 port, u8 value) override
+        {
+            portWrites[port]++;
+            bus->writeIntoOutputPort(port, value);
+        }
+
+        u16 getAddressMask() const override
+        {
+            return bus->getAddressMask();
+        }
+
+        u8& getMemoryLocationRef(u16 addr) override
+        {
+            count(BusAccess::REFERENCE, addr);
+            return bus->getMemoryLocationRef(addr);
+        }
+
+        u8& getOperandLocationRef(u16 addr, OperandAccess access) override
+        {
+            if (access != OperandAccess::WRITE)
+            {
+                count(BusAccess::READ, addr);
+            }
+            if (access != OperandAccess::READ)
+            {
+                count(BusAccess::WRITE, addr);
+            }
+            return bus->getOperandLocationRef(addr, access);
+        }
+
+        // Decorated bus, accessing it directly is not counted
+        Bus& getBus();
+
+        u64 getCount(BusAccess access, u16 addr) const;
+
+        // Sum of counts of all addresses in 256 byte page
+        u64 getPageCount(BusAccess access, u8 page) const;
+
+        u64 getPortReads(u8 port) const;
+
+        u64 getPortWrites(u8 port) const;
+
+        void clear();
+
+        void writeBinary(std::ostream& out, HeatmapGranularity granularity = HeatmapGranularity::ADDRESS) const;
+
+        // "address,reads,writes,fetches,references" rows of buckets which were accessed,
+        // then "port,reads,writes" rows of ports which were accessed
+        void writeCsv(std::ostream& out, HeatmapGranularity granularity = HeatmapGranularity::ADDRESS) const;
+
+    private:
+        void count(BusAccess access, u16 addr) const
+        {
+            counts[static_cast<std::size_t>(access) * 0x10000 + addr]++;
+        }
+
+        void countWord(BusAccess access, u16 addr) const
+        {
+            count(access, addr);
+            count(access, static_cast<u16>(addr + 1));
+        }
+
+        // Counts of given access summed into buckets of given size
+        std::vector<u64> getBuckets(BusAccess access, std::size_t bucketSize) const;
+
+        std::shared_ptr<Bus> bus;
+        // Counted from const accessors as well
+        mutable std::vector<u64> counts;
+        mutable std::vector<u64> portReads;
+        std::vector<u64> portWrites;
+};
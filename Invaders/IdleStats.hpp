@@ -0,0 +1,11 @@
+#pragma once
+
+#include "Types.hpp"
+
+// Time the cpu spent waiting for an interrupt, which was skipped instead of executed
+struct IdleStats
+{
+    u64 idleLoops;       // Times polling loop repeating without changing anything was fast-forwarded
+    u64 idleLoopCycles;  // Cycles of polling loop iterations which were skipped
+    u64 haltedCycles;    // Cycles which passed while cpu was halted
+};
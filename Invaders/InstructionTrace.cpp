@@ -0,0 +1,214 @@
+#include "InstructionTrace.hpp"
+
+#include <algorithm>
+#include <csignal>
+#include <cstring>
+
+#ifdef _WIN32
+#include <fcntl.h>
+#include <io.h>
+#include <sys/stat.h>
+#else
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+    const char MAGIC[8] = "I8080TR";
+    const int CRASH_SIGNALS[] = { SIGSEGV, SIGILL, SIGFPE, SIGABRT };
+
+    // Copied ahead, crash handler must not touch std::string
+    constexpr std::size_t CRASH_DUMP_PATH_SIZE = 4096;
+    char crashDumpPath[CRASH_DUMP_PATH_SIZE] = {};
+    const InstructionTrace* crashTrace = nullptr;
+
+    void dumpOnCrash(int signal)
+    {
+        if (crashTrace != nullptr)
+        {
+            crashTrace->writeToFile(crashDumpPath);
+        }
+        std::signal(signal, SIG_DFL);
+        std::raise(signal);
+    }
+
+    // Plain descriptors, as stdio may allocate or take locks
+    int openForWriting(const char* path)
+    {
+#ifdef _WIN32
+        return _open(path, _O_WRONLY | _O_CREAT | _O_TRUNC | _O_BINARY, _S_IREAD | _S_IWRITE);
+#else
+        return open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+#endif
+    }
+
+    bool writeAll(int file, const void* data, std::size_t length)
+    {
+        auto bytes = static_cast<const char*>(data);
+        while (length > 0)
+        {
+#ifdef _WIN32
+            const int written = _write(file, bytes, static_cast<unsigned>(std::min<std::size_t>(length, 0x40000000)));
+#else
+            const auto written = write(file, bytes, length);
+#endif
+            if (written <= 0)
+            {
+                return false;
+            }
+            bytes += written;
+            length -= static_cast<std::size_t>(written);
+        }
+        return true;
+    }
+
+    bool closeFile(int file)
+    {
+#ifdef _WIN32
+        return _close(file) == 0;
+#else
+        return close(file) == 0;
+#endif
+    }
+
+    std::size_t roundUpToPowerOfTwo(std::size_t value)
+    {
+        std::size_t result = 1;
+        while (result < value)
+        {
+            result <<= 1;
+        }
+        return result;
+    }
+}
+
+InstructionTrace::InstructionTrace(std::size_t capacity)
+    : records(roundUpToPowerOfTwo(capacity))
+    , mask(records.size() - 1)
+    , recordIndex(0)
+    , lastCycles(0)
+{
+}
+
+InstructionTrace::~InstructionTrace()
+{
+    if (crashTrace == this)
+    {
+        crashTrace = nullptr;
+    }
+}
+
+std::size_t InstructionTrace::getCapacity() const
+{
+    return records.size();
+}
+
+std::size_t InstructionTrace::getRecordCount() const
+{
+    return recordIndex < records.size() ? static_cast<std::size_t>(recordIndex) : records.size();
+}
+
+u64 InstructionTrace::getTotalRecordCount() const
+{
+    return recordIndex;
+}
+
+void InstructionTrace::clear()
+{
+    recordIndex = 0;
+    lastCycles = 0;
+}
+
+std::vector<TraceRecord> InstructionTrace::getRecords() const
+{
+    std::vector<TraceRecord> result;
+    result.reserve(getRecordCount());
+    for (u64 index = recordIndex - getRecordCount(); index < recordIndex; index++)
+    {
+        result.push_back(records[index & mask]);
+    }
+    return result;
+}
+
+void InstructionTrace::write(std::ostream& out) const
+{
+    const auto header = makeHeader();
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    for (u64 index = recordIndex - getRecordCount(); index < recordIndex; index++)
+    {
+        out.write(reinterpret_cast<const char*>(&records[index & mask]), sizeof(TraceRecord));
+    }
+}
+
+bool InstructionTrace::writeToFile(const char* path) const
+{
+    const int file = openForWriting(path);
+    if (file < 0)
+    {
+        return false;
+    }
+
+    // Kept records are at most two contiguous parts of the buffer
+    const auto header = makeHeader();
+    const std::size_t count = getRecordCount();
+    const std::size_t first = static_cast<std::size_t>((recordIndex - count) & mask);
+    const std::size_t firstPart = std::min(count, records.size() - first);
+
+    bool written = writeAll(file, &header, sizeof(header));
+    written = written && writeAll(file, &records[first], firstPart * sizeof(TraceRecord));
+    written = written && writeAll(file, records.data(), (count - firstPart) * sizeof(TraceRecord));
+    return closeFile(file) && written;
+}
+
+bool InstructionTrace::setCrashDumpPath(const std::string& path)
+{
+    // Handler is disarmed while path is replaced
+    crashTrace = nullptr;
+    if (path.size() >= CRASH_DUMP_PATH_SIZE)
+    {
+        crashDumpPath[0] = '\0';
+        return false;
+    }
+
+    std::memcpy(crashDumpPath, path.c_str(), path.size() + 1);
+    crashTrace = path.empty() ? nullptr : this;
+    for (auto signal : CRASH_SIGNALS)
+    {
+        std::signal(signal, path.empty() ? SIG_DFL : dumpOnCrash);
+    }
+    return true;
+}
+
+bool InstructionTrace::read(std::istream& in, TraceFileHeader& header, std::vector<TraceRecord>& records)
+{
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+        || header.version != FILE_VERSION
+        || header.recordSize != sizeof(TraceRecord))
+    {
+        return false;
+    }
+
+    records.resize(static_cast<std::size_t>(header.recordCount));
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(records.data()), records.size() * sizeof(TraceRecord)));
+}
+
+TraceFileHeader InstructionTrace::makeHeader() const
+{
+    TraceFileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FILE_VERSION;
+    header.recordSize = sizeof(TraceRecord);
+    header.recordCount = getRecordCount();
+
+    // Differences of low bits between consecutive records add up to distance
+    // between the first and the last one
+    u64 elapsed = 0;
+    for (u64 index = recordIndex - getRecordCount() + 1; index < recordIndex; index++)
+    {
+        elapsed += static_cast<u32>(records[index & mask].cycles - records[(index - 1) & mask].cycles);
+    }
+    header.firstCycles = lastCycles - elapsed;
+    return header;
+}
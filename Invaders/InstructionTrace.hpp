@@ -0,0 +1,104 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "Types.hpp"
+
+enum class TraceRecordKind : u8
+{
+    INSTRUCTION = 0,
+    // RST executed for taken interrupt, PC is address of interrupted code
+    INTERRUPT = 1
+};
+
+// State of cpu before instruction was executed. Written into trace files as it
+// is in memory, so files are read on machine of the same byte order (little endian).
+struct TraceRecord
+{
+    u32 cycles;            // Low 32 bits of cycle counter
+    u16 pc;
+    u16 sp;
+    u8 opcode;
+    u8 operand[2];         // Bytes following opcode, meaningful up to length of instruction
+    u8 a;
+    u8 flags;
+    TraceRecordKind kind;
+    u8 reserved[2];
+};
+
+static_assert(sizeof(TraceRecord) == 16, "Trace records are written into files as they are");
+
+struct TraceFileHeader
+{
+    char magic[8];         // "I8080TR" with terminating zero
+    u32 version;
+    u32 recordSize;
+    u64 recordCount;
+    u64 firstCycles;       // Whole cycle counter of the first record
+};
+
+// Ring buffer of last executed instructions, preallocated so recording is a store
+// and an increment. Capacity is rounded up to power of two. Records are kept
+// oldest first, consecutive records have to be less than 2^32 cycles apart
+// to restore whole cycle counters from their low bits.
+class InstructionTrace
+{
+    public:
+        static constexpr std::size_t DEFAULT_CAPACITY = 1 << 20;
+        static constexpr u32 FILE_VERSION = 1;
+
+        explicit InstructionTrace(std::size_t capacity = DEFAULT_CAPACITY);
+
+        ~InstructionTrace();
+
+        InstructionTrace(const InstructionTrace&) = delete;
+
+        InstructionTrace& operator=(const InstructionTrace&) = delete;
+
+        void record(const TraceRecord& record, u64 cycles)
+        {
+            records[recordIndex & mask] = record;
+            recordIndex++;
+            lastCycles = cycles;
+        }
+
+        std::size_t getCapacity() const;
+
+        // Records kept in buffer
+        std::size_t getRecordCount() const;
+
+        // Records written since trace was created or cleared, including overwritten ones
+        u64 getTotalRecordCount() const;
+
+        void clear();
+
+        // Kept records, oldest first
+        std::vector<TraceRecord> getRecords() const;
+
+        void write(std::ostream& out) const;
+
+        // Uses only open, write and close on a file descriptor, which are safe
+        // to call from signal handler, so it is used for crash dumps as well
+        bool writeToFile(const char* path) const;
+
+        // Writes trace into given file when process crashes (SIGSEGV, SIGILL, SIGFPE
+        // or SIGABRT). Only one trace can be dumped on crash, last one set wins.
+        // Empty path cancels the dump. Path is copied into static buffer, as handler
+        // can not use std::string; returns false when it is too long to fit.
+        bool setCrashDumpPath(const std::string& path);
+
+        // Reads trace written by write() or writeToFile()
+        static bool read(std::istream& in, TraceFileHeader& header, std::vector<TraceRecord>& records);
+
+    private:
+        TraceFileHeader makeHeader() const;
+
+        std::vector<TraceRecord> records;
+        std::size_t mask;
+        u64 recordIndex;
+        // Cycle counter of the last record
+        u64 lastCycles;
+};
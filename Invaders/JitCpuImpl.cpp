@@ -0,0 +1,742 @@
+#include <cstddef>
+#include <cstdint>
+#include <iterator>
+
+#include "JitCpuImpl.hpp"
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define JIT_HOST_X64
+#endif
+
+namespace
+{
+    // Guest state kept in callee-saved host registers while native code runs.
+    // A and F are zero extended bytes, register pairs zero extended words.
+    constexpr X64Register CONTEXT = X64Register::RBX;
+    constexpr X64Register FLAGS = X64Register::RBP;
+    constexpr X64Register ACCUMULATOR = X64Register::R12;
+    constexpr X64Register PAIRS[] = { X64Register::R13, X64Register::R14, X64Register::R15 };
+    constexpr X64Register PAIR_DE = X64Register::R14;
+    constexpr X64Register PAIR_HL = X64Register::R15;
+
+    constexpr X64Register SAVED_REGISTERS[] = {
+        X64Register::RBX, X64Register::RBP, X64Register::R12, X64Register::R13, X64Register::R14, X64Register::R15
+    };
+
+#ifdef _WIN32
+    constexpr X64Register ARGUMENT0 = X64Register::RCX;
+    constexpr X64Register ARGUMENT1 = X64Register::RDX;
+    // Shadow space for callees, also realigns stack to 16 bytes
+    constexpr u32 STACK_RESERVE = 40;
+#else
+    constexpr X64Register ARGUMENT0 = X64Register::RDI;
+    constexpr X64Register ARGUMENT1 = X64Register::RSI;
+    constexpr u32 STACK_RESERVE = 8;
+#endif
+
+    // Code memory left free before translating block, more than any block can take
+    constexpr std::size_t MAX_BLOCK_CODE_SIZE = 16 * 1024;
+    // Cycle cost of blocks which cannot be translated, never fits into budget
+    constexpr u64 UNTRANSLATED_BLOCK_CYCLES = u64(1) << 62;
+
+    // Flag register bits tested by conditions, indexed by condition
+    constexpr u32 CONDITION_FLAGS[] = {
+        FlagTables::ZERO, FlagTables::ZERO, FlagTables::CARRY, FlagTables::CARRY,
+        FlagTables::PARITY, FlagTables::PARITY, FlagTables::SIGN, FlagTables::SIGN
+    };
+
+    static_assert(sizeof(AluResult) == 2, "Native code indexes flag tables assuming 2 byte entries");
+}
+
+JitCpuImpl::JitCpuImpl(const std::shared_ptr<Bus>& busPtr)
+    : CpuImpl(busPtr, DispatchMode::TABLE)
+    , codeMemory(isJitSupported() ? CODE_MEMORY_SIZE : 0)
+    , codeStart(0)
+    , codeEnd(0)
+    , entry(nullptr)
+    , dispatchCode(nullptr)
+    , exitCode(nullptr)
+    , jitEnabled(false)
+    , codeUsable(false)
+    , blocks(busPtr->getAddressMask())
+    , stats()
+{
+    if (codeMemory.isValid())
+    {
+        generateStubs();
+        codeUsable = codeMemory.makeExecutable(0, codeStart);
+        jitEnabled = codeUsable;
+    }
+}
+
+void JitCpuImpl::executeInstruction(u8 opcode)
+{
+    // Instruction executed from outside may write into translated code as well
+    const auto write = OpcodeTraits::getMemoryWrite(opcode);
+    if (write == MemoryWrite::NONE)
+    {
+        CpuImpl::executeInstruction(opcode);
+        return;
+    }
+
+    u16 operand = 0;
+    if (write == MemoryWrite::IMMEDATE_BYTE || write == MemoryWrite::IMMEDATE_WORD)
+    {
+        const u16 pc = registers.getPc();
+        operand = bus->fetchWordFromMemory(pc);
+    }
+    const auto addr = resolveWriteAddress(write, operand);
+
+    CpuImpl::executeInstruction(opcode);
+    invalidateWrittenMemory(addr, write);
+}
+
+bool JitCpuImpl::isJitSupported()
+{
+#ifdef JIT_HOST_X64
+    return true;
+#else
+    return false;
+#endif
+}
+
+bool JitCpuImpl::isJitEnabled() const
+{
+    return jitEnabled;
+}
+
+void JitCpuImpl::setJitEnabled(bool enabled)
+{
+    if (enabled && !jitEnabled)
+    {
+        flushCode();
+    }
+    jitEnabled = enabled && codeUsable;
+}
+
+void JitCpuImpl::invalidateBlocks(u16 addr, u16 length)
+{
+    for (u16 offset = 0; offset < length; offset++)
+    {
+        const u16 invalidatedAddr = addr + offset;
+        if (blocks.mayContainCode(invalidatedAddr))
+        {
+            blocks.invalidate(invalidatedAddr, [this](std::unique_ptr<JitBlock>) { stats.invalidations++; });
+        }
+    }
+}
+
+void JitCpuImpl::invalidateAllBlocks()
+{
+    flushCode();
+}
+
+const JitStats& JitCpuImpl::getJitStats() const
+{
+    return stats;
+}
+
+void JitCpuImpl::resetJitStats()
+{
+    stats = JitStats();
+}
+
+std::size_t JitCpuImpl::getCachedBlockCount() const
+{
+    return blocks.getBlockCount();
+}
+
+void JitCpuImpl::runUntilTarget()
+{
+    if (!jitEnabled)
+    {
+        CpuImpl::runUntilTarget();
+        return;
+    }
+
+    while (cycles < cycleTarget)
+    {
+        const u16 pc = registers.getPc();
+        auto* block = blocks.find(pc);
+        if (block == nullptr)
+        {
+            block = &translateBlock(pc);
+            if (!jitEnabled)
+            {
+                CpuImpl::runUntilTarget();
+                return;
+            }
+        }
+
+        if (block->code != nullptr && cycles + block->maxCycles <= cycleTarget)
+        {
+            // Native code keeps flags up to date on its own
+            materializeFlags();
+            stats.nativeEntries++;
+            entry(this, block->code);
+        }
+        else
+        {
+            interpretInstruction();
+        }
+    }
+}
+
+void JitCpuImpl::generateStubs()
+{
+    X64Emitter emitter(codeMemory.getData(), codeMemory.getSize());
+
+    // void entry(JitCpuImpl* cpu, const u8* code)
+    // Loads guest registers and jumps into block
+    entry = reinterpret_cast<EntryFunction>(emitter.getCurrentAddress());
+    for (auto reg : SAVED_REGISTERS)
+    {
+        emitter.push(reg);
+    }
+    emitter.alu64Imm(X64AluOperation::SUB, X64Register::RSP, STACK_RESERVE);
+    emitter.mov64(CONTEXT, ARGUMENT0);
+    emitReload(emitter);
+    emitter.jmp(ARGUMENT1);
+
+    // Stores guest registers and returns from entry
+    exitCode = emitter.getCurrentAddress();
+    emitSpill(emitter);
+    emitter.alu64Imm(X64AluOperation::ADD, X64Register::RSP, STACK_RESERVE);
+    for (auto it = std::rbegin(SAVED_REGISTERS); it != std::rend(SAVED_REGISTERS); ++it)
+    {
+        emitter.pop(*it);
+    }
+    emitter.ret();
+
+    // Every block exits here with PC and cycle counter updated.
+    // Chains into block starting at PC if it is translated and fits into budget.
+    dispatchCode = emitter.getCurrentAddress();
+    emitter.movzx16Load(X64Register::RAX, CONTEXT, offsetOf(&registers.getPc()));
+    emitter.movImm64(X64Register::RCX, reinterpret_cast<std::uintptr_t>(blocks.getEntries()));
+    emitter.load64Indexed(X64Register::RAX, X64Register::RCX, X64Register::RAX);
+    emitter.test64(X64Register::RAX, X64Register::RAX);
+    emitter.jcc(X64Condition::ZERO, exitCode);
+    emitter.load64(X64Register::RCX, CONTEXT, offsetOf(&cycles));
+    emitter.add64Load(X64Register::RCX, X64Register::RAX, offsetof(JitBlock, maxCycles));
+    emitter.cmp64Load(X64Register::RCX, CONTEXT, offsetOf(&cycleTarget));
+    emitter.jcc(X64Condition::ABOVE, exitCode);
+    emitter.jmpLoad(X64Register::RAX, offsetof(JitBlock, code));
+
+    codeStart = emitter.getPosition();
+    codeEnd = codeStart;
+}
+
+JitCpuImpl::JitBlock& JitCpuImpl::translateBlock(u16 pc)
+{
+    if (codeMemory.getSize() - codeEnd < MAX_BLOCK_CODE_SIZE)
+    {
+        flushCode();
+    }
+
+    auto block = std::make_unique<JitBlock>();
+    block->startPc = pc;
+    block->length = 0;
+    block->maxCycles = 0;
+    block->code = nullptr;
+
+    // Code memory is made writable only while block is emitted into it
+    const auto blockStart = codeEnd;
+    if (codeMemory.makeWritable(blockStart, MAX_BLOCK_CODE_SIZE))
+    {
+        X64Emitter emitter(codeMemory.getData() + blockStart, MAX_BLOCK_CODE_SIZE);
+        if (emitBlock(emitter, *block) && !emitter.hasOverflowed())
+        {
+            block->code = codeMemory.getData() + blockStart;
+            codeEnd += emitter.getPosition();
+            stats.translatedBlocks++;
+        }
+
+        if (!codeMemory.makeExecutable(blockStart, MAX_BLOCK_CODE_SIZE))
+        {
+            // Code sharing pages with the block cannot run anymore
+            block->code = nullptr;
+            flushCode();
+            codeUsable = false;
+            jitEnabled = false;
+        }
+    }
+
+    if (block->code == nullptr)
+    {
+        // Instruction at PC is always left to interpreter
+        block->length = OpcodeTraits::getLength(bus->fetchFromMemory(pc));
+        block->maxCycles = UNTRANSLATED_BLOCK_CYCLES;
+    }
+
+    return blocks.insert(std::move(block));
+}
+
+bool JitCpuImpl::emitBlock(X64Emitter& emitter, JitBlock& block)
+{
+    u16 addr = block.startPc;
+    unsigned elapsedCycles = 0;
+    unsigned instructions = 0;
+    bool ended = false;
+
+    while (!ended && instructions < MAX_BLOCK_INSTRUCTIONS)
+    {
+        const u32 window = bus->fetchInstructionWindow(addr);
+        const u8 opcode = window & 0xFF;
+        const auto x = OpcodeTraits::getX(opcode);
+        const auto y = OpcodeTraits::getY(opcode);
+        const auto z = OpcodeTraits::getZ(opcode);
+
+        // OUT, IN
+        if (x == 3 && z == 3 && (y == 2 || y == 3))
+            break;
+
+        const auto length = OpcodeTraits::getLength(opcode);
+        u16 operand = 0;
+        if (length == 2)
+            operand = (window >> 8) & 0xFF;
+        else if (length == 3)
+            operand = window >> 8;
+        const u16 nextPc = addr + length;
+
+        elapsedCycles += cycleTable[opcode];
+        block.maxCycles += OpcodeTraits::getMaxCycles(opcode);
+        block.length += length;
+
+        ended = emitInstruction(emitter, opcode, operand, nextPc, elapsedCycles);
+        addr = nextPc;
+        instructions++;
+    }
+
+    if (instructions == 0)
+    {
+        return false;
+    }
+
+    if (!ended)
+    {
+        emitExit(emitter, elapsedCycles, addr);
+    }
+    return true;
+}
+
+bool JitCpuImpl::emitInstruction(X64Emitter& emitter, u8 opcode, u16 operand, u16 nextPc, unsigned elapsedCycles)
+{
+    // Returns whether instruction ends block
+
+    const auto x = OpcodeTraits::getX(opcode);
+    const auto y = OpcodeTraits::getY(opcode);
+    const auto z = OpcodeTraits::getZ(opcode);
+    const auto p = OpcodeTraits::getP(opcode);
+    const auto q = OpcodeTraits::getQ(opcode);
+
+    const u32 spOffset = offsetOf(&registers.getSp());
+
+    if (x == 0)
+    {
+        if (z == 0)
+        {
+            // NOP
+            return false;
+        }
+        if (z == 1 && q == 0)
+        {
+            // LXI
+            if (p < 3)
+                emitter.movImm32(PAIRS[p], operand);
+            else
+                emitter.store16Imm(CONTEXT, spOffset, operand);
+            return false;
+        }
+        if (z == 1)
+        {
+            // DAD
+            if (p < 3)
+                emitter.mov32(X64Register::RAX, PAIRS[p]);
+            else
+                emitter.movzx16Load(X64Register::RAX, CONTEXT, spOffset);
+            emitter.alu32(X64AluOperation::ADD, PAIR_HL, X64Register::RAX);
+            emitter.mov32(X64Register::RAX, PAIR_HL);
+            emitter.shift32Imm(X64ShiftOperation::SHR, X64Register::RAX, 16);
+            emitter.alu32Imm(X64AluOperation::AND, FLAGS, ~FlagTables::CARRY & 0xFF);
+            emitter.alu32(X64AluOperation::OR, FLAGS, X64Register::RAX);
+            emitter.alu32Imm(X64AluOperation::AND, PAIR_HL, 0xFFFF);
+            return false;
+        }
+        if (z == 3)
+        {
+            // INX, DCX
+            if (p < 3 && q == 0)
+                emitter.inc16(PAIRS[p]);
+            else if (p < 3)
+                emitter.dec16(PAIRS[p]);
+            else if (q == 0)
+                emitter.inc16Store(CONTEXT, spOffset);
+            else
+                emitter.dec16Store(CONTEXT, spOffset);
+            return false;
+        }
+        if ((z == 4 || z == 5) && y != 6)
+        {
+            // INR, DCR
+            const auto& table = z == 4 ? flagTables.getIncrement(0) : flagTables.getDecrement(0);
+            emitIncrement(emitter, y, &table);
+            return false;
+        }
+        if (z == 6 && y != 6)
+        {
+            // MVI
+            emitter.movImm32(X64Register::RAX, operand & 0xFF);
+            emitStoreRegister(emitter, y, X64Register::RAX);
+            return false;
+        }
+        if (z == 7 && y != 4)
+        {
+            // RLC, RRC, RAL, RAR, CMA, STC, CMC
+            const u32 keepFlags = ~FlagTables::CARRY & 0xFF;
+            switch (y)
+            {
+                case 0:
+                    emitter.mov32(X64Register::RAX, ACCUMULATOR);
+                    emitter.shift32Imm(X64ShiftOperation::SHR, X64Register::RAX, 7);
+                    emitter.alu32Imm(X64AluOperation::AND, FLAGS, keepFlags);
+                    emitter.alu32(X64AluOperation::OR, FLAGS, X64Register::RAX);
+                    emitter.shift32Imm(X64ShiftOperation::SHL, ACCUMULATOR, 1);
+                    emitter.alu32(X64AluOperation::OR, ACCUMULATOR, X64Register::RAX);
+                    emitter.alu32Imm(X64AluOperation::AND, ACCUMULATOR, 0xFF);
+                    break;
+                case 1:
+                    emitter.mov32(X64Register::RAX, ACCUMULATOR);
+                    emitter.alu32Imm(X64AluOperation::AND, X64Register::RAX, 1);
+                    emitter.alu32Imm(X64AluOperation::AND, FLAGS, keepFlags);
+                    emitter.alu32(X64AluOperation::OR, FLAGS, X64Register::RAX);
+                    emitter.shift32Imm(X64ShiftOperation::SHR, ACCUMULATOR, 1);
+                    emitter.shift32Imm(X64ShiftOperation::SHL, X64Register::RAX, 7);
+                    emitter.alu32(X64AluOperation::OR, ACCUMULATOR, X64Register::RAX);
+                    break;
+                case 2:
+                    emitter.mov32(X64Register::RDX, FLAGS);
+                    emitter.alu32Imm(X64AluOperation::AND, X64Register::RDX, FlagTables::CARRY);
+                    emitter.mov32(X64Register::RAX, ACCUMULATOR);
+                    emitter.shift32Imm(X64ShiftOperation::SHR, X64Register::RAX, 7);
+                    emitter.alu32Imm(X64AluOperation::AND, FLAGS, keepFlags);
+                    emitter.alu32(X64AluOperation::OR, FLAGS, X64Register::RAX);
+                    emitter.shift32Imm(X64ShiftOperation::SHL, ACCUMULATOR, 1);
+                    emitter.alu32(X64AluOperation::OR, ACCUMULATOR, X64Register::RDX);
+                    emitter.alu32Imm(X64AluOperation::AND, ACCUMULATOR, 0xFF);
+                    break;
+                case 3:
+                    emitter.mov32(X64Register::RDX, FLAGS);
+                    emitter.alu32Imm(X64AluOperation::AND, X64Register::RDX, FlagTables::CARRY);
+                    emitter.shift32Imm(X64ShiftOperation::SHL, X64Register::RDX, 7);
+                    emitter.mov32(X64Register::RAX, ACCUMULATOR);
+                    emitter.alu32Imm(X64AluOperation::AND, X64Register::RAX, 1);
+                    emitter.alu32Imm(X64AluOperation::AND, FLAGS, keepFlags);
+                    emitter.alu32(X64AluOperation::OR, FLAGS, X64Register::RAX);
+                    emitter.shift32Imm(X64ShiftOperation::SHR, ACCUMULATOR, 1);
+                    emitter.alu32(X64AluOperation::OR, ACCUMULATOR, X64Register::RDX);
+                    break;
+                case 5:
+                    emitter.alu32Imm(X64AluOperation::XOR, ACCUMULATOR, 0xFF);
+                    break;
+                case 6:
+                    emitter.alu32Imm(X64AluOperation::OR, FLAGS, FlagTables::CARRY);
+                    break;
+                default:
+                    emitter.alu32Imm(X64AluOperation::XOR, FLAGS, FlagTables::CARRY);
+                    break;
+            }
+            return false;
+        }
+    }
+    else if (x == 1)
+    {
+        if (y != 6 && z != 6)
+        {
+            // MOV
+            if (y != z)
+            {
+                emitLoadRegister(emitter, z, X64Register::RAX);
+                emitStoreRegister(emitter, y, X64Register::RAX);
+            }
+            return false;
+        }
+    }
+    else if (x == 2)
+    {
+        if (z != 6)
+        {
+            // ADD, ADC, SUB, SBB, ANA, XRA, ORA, CMP
+            emitLoadRegister(emitter, z, X64Register::RAX);
+            emitAlu(emitter, y);
+            return false;
+        }
+    }
+    else
+    {
+        if (z == 6)
+        {
+            // ALU immedate
+            emitter.movImm32(X64Register::RAX, operand & 0xFF);
+            emitAlu(emitter, y);
+            return false;
+        }
+        if (z == 2 || (z == 3 && y < 2))
+        {
+            // Jcc, JMP
+            if (z == 2)
+            {
+                const bool jumpsWhenSet = y % 2 == 1;
+                emitter.test32Imm(FLAGS, CONDITION_FLAGS[y]);
+                const auto notTaken = emitter.jccForward(jumpsWhenSet ? X64Condition::ZERO : X64Condition::NOT_ZERO);
+                emitExit(emitter, elapsedCycles, operand);
+                emitter.bind(notTaken);
+                emitExit(emitter, elapsedCycles, nextPc);
+            }
+            else
+            {
+                emitExit(emitter, elapsedCycles, operand);
+            }
+            return true;
+        }
+        if (z == 3 && y == 5)
+        {
+            // XCHG
+            emitter.mov32(X64Register::RAX, PAIR_DE);
+            emitter.mov32(PAIR_DE, PAIR_HL);
+            emitter.mov32(PAIR_HL, X64Register::RAX);
+            return false;
+        }
+        if (z == 1 && q == 1 && p == 2)
+        {
+            // PCHL
+            emitter.store16(CONTEXT, offsetOf(&registers.getPc()), PAIR_HL);
+            emitExit(emitter, elapsedCycles);
+            return true;
+        }
+        if (z == 1 && q == 1 && p == 3)
+        {
+            // SPHL
+            emitter.store16(CONTEXT, spOffset, PAIR_HL);
+            return false;
+        }
+    }
+
+    // Left to interpreter. EI ends block, so that dispatcher sees its effects.
+    const bool endsBlock = OpcodeTraits::endsBasicBlock(opcode) || (x == 3 && z == 3 && y == 7);
+    emitFallback(emitter, opcode, operand, nextPc, elapsedCycles, endsBlock);
+    return endsBlock;
+}
+
+void JitCpuImpl::emitFallback(X64Emitter& emitter, u8 opcode, u16 operand, u16 nextPc, unsigned elapsedCycles, bool endsBlock)
+{
+    const u64 instruction = opcode | (operand << 8) | (static_cast<u64>(nextPc) << 24);
+
+    emitSpill(emitter);
+    emitter.mov64(ARGUMENT0, CONTEXT);
+    emitter.movImm64(ARGUMENT1, instruction);
+    emitter.movImm64(X64Register::RAX, reinterpret_cast<std::uintptr_t>(&JitCpuImpl::executeFallback));
+    emitter.call(X64Register::RAX);
+    emitReload(emitter);
+
+    // PC is set by interpreter
+    if (endsBlock)
+    {
+        emitExit(emitter, elapsedCycles);
+        return;
+    }
+
+    emitter.test32Imm(X64Register::RAX, 1);
+    const auto resume = emitter.jccForward(X64Condition::ZERO);
+    emitExit(emitter, elapsedCycles);
+    emitter.bind(resume);
+}
+
+void JitCpuImpl::emitExit(X64Emitter& emitter, unsigned elapsedCycles, u16 pc)
+{
+    emitter.store16Imm(CONTEXT, offsetOf(&registers.getPc()), pc);
+    emitExit(emitter, elapsedCycles);
+}
+
+void JitCpuImpl::emitExit(X64Emitter& emitter, unsigned elapsedCycles)
+{
+    emitter.add64StoreImm(CONTEXT, offsetOf(&cycles), elapsedCycles);
+    emitter.jmp(dispatchCode);
+}
+
+void JitCpuImpl::emitSpill(X64Emitter& emitter)
+{
+    emitter.store8(CONTEXT, offsetOf(&registers.getAf().getHigh()), ACCUMULATOR);
+    emitter.store8(CONTEXT, offsetOf(&registers.getAf().getLow()), FLAGS);
+    emitter.store16(CONTEXT, offsetOf(&registers.getBc().getRaw()), PAIRS[0]);
+    emitter.store16(CONTEXT, offsetOf(&registers.getDe().getRaw()), PAIRS[1]);
+    emitter.store16(CONTEXT, offsetOf(&registers.getHl().getRaw()), PAIRS[2]);
+}
+
+void JitCpuImpl::emitReload(X64Emitter& emitter)
+{
+    emitter.movzx8Load(ACCUMULATOR, CONTEXT, offsetOf(&registers.getAf().getHigh()));
+    emitter.movzx8Load(FLAGS, CONTEXT, offsetOf(&registers.getAf().getLow()));
+    emitter.movzx16Load(PAIRS[0], CONTEXT, offsetOf(&registers.getBc().getRaw()));
+    emitter.movzx16Load(PAIRS[1], CONTEXT, offsetOf(&registers.getDe().getRaw()));
+    emitter.movzx16Load(PAIRS[2], CONTEXT, offsetOf(&registers.getHl().getRaw()));
+}
+
+void JitCpuImpl::emitLoadRegister(X64Emitter& emitter, unsigned index, X64Register dst)
+{
+    // Index as in opcode: B, C, D, E, H, L, (M), A
+    if (index == 7)
+    {
+        emitter.mov32(dst, ACCUMULATOR);
+        return;
+    }
+
+    const auto pair = PAIRS[index / 2];
+    if (index % 2 == 0)
+    {
+        emitter.mov32(dst, pair);
+        emitter.shift32Imm(X64ShiftOperation::SHR, dst, 8);
+    }
+    else
+    {
+        emitter.movzx8(dst, pair);
+    }
+}
+
+void JitCpuImpl::emitStoreRegister(X64Emitter& emitter, unsigned index, X64Register src)
+{
+    // Value in src has to be zero extended byte, src is clobbered
+    if (index == 7)
+    {
+        emitter.mov32(ACCUMULATOR, src);
+        return;
+    }
+
+    const auto pair = PAIRS[index / 2];
+    if (index % 2 == 0)
+    {
+        emitter.alu32Imm(X64AluOperation::AND, pair, 0xFF);
+        emitter.shift32Imm(X64ShiftOperation::SHL, src, 8);
+        emitter.alu32(X64AluOperation::OR, pair, src);
+    }
+    else
+    {
+        emitter.mov8(pair, src);
+    }
+}
+
+void JitCpuImpl::emitAlu(X64Emitter& emitter, unsigned operation)
+{
+    // Operand is in EAX, mirrors adi/aci/sui/sbi/ani/xri/ori/cpi
+
+    const u32 keepFlags = ~FlagTables::ALU_FLAGS & 0xFF;
+
+    if (operation >= 4 && operation <= 6)
+    {
+        const X64AluOperation logicOperations[] = { X64AluOperation::AND, X64AluOperation::XOR, X64AluOperation::OR };
+        emitter.alu32(logicOperations[operation - 4], X64Register::RAX, ACCUMULATOR);
+        emitter.mov32(ACCUMULATOR, X64Register::RAX);
+        emitter.movImm64(X64Register::RCX, reinterpret_cast<std::uintptr_t>(&flagTables.getLogic(0)));
+        emitter.movzx16LoadIndexed(X64Register::RAX, X64Register::RCX, X64Register::RAX);
+        emitter.shift32Imm(X64ShiftOperation::SHR, X64Register::RAX, 8);
+        emitter.alu32Imm(X64AluOperation::AND, FLAGS, keepFlags);
+        emitter.alu32(X64AluOperation::OR, FLAGS, X64Register::RAX);
+        return;
+    }
+
+    // Table index: (carry << 16) | (accumulator << 8) | operand
+    const bool withCarry = operation == 1 || operation == 3;
+    const auto& table = operation < 2 ? flagTables.getAdd(0, 0, 0) : flagTables.getSubtract(0, 0, 0);
+    if (withCarry)
+    {
+        emitter.mov32(X64Register::RDX, FLAGS);
+        emitter.alu32Imm(X64AluOperation::AND, X64Register::RDX, FlagTables::CARRY);
+        emitter.shift32Imm(X64ShiftOperation::SHL, X64Register::RDX, 8);
+        emitter.alu32(X64AluOperation::OR, X64Register::RDX, ACCUMULATOR);
+    }
+    else
+    {
+        emitter.mov32(X64Register::RDX, ACCUMULATOR);
+    }
+    emitter.shift32Imm(X64ShiftOperation::SHL, X64Register::RDX, 8);
+    emitter.alu32(X64AluOperation::OR, X64Register::RAX, X64Register::RDX);
+
+    emitter.movImm64(X64Register::RCX, reinterpret_cast<std::uintptr_t>(&table));
+    emitter.movzx16LoadIndexed(X64Register::RAX, X64Register::RCX, X64Register::RAX);
+    emitter.mov32(X64Register::RDX, X64Register::RAX);
+    emitter.shift32Imm(X64ShiftOperation::SHR, X64Register::RDX, 8);
+    emitter.alu32Imm(X64AluOperation::AND, FLAGS, keepFlags);
+    emitter.alu32(X64AluOperation::OR, FLAGS, X64Register::RDX);
+
+    // CMP keeps accumulator
+    if (operation != 7)
+    {
+        emitter.alu32Imm(X64AluOperation::AND, X64Register::RAX, 0xFF);
+        emitter.mov32(ACCUMULATOR, X64Register::RAX);
+    }
+}
+
+void JitCpuImpl::emitIncrement(X64Emitter& emitter, unsigned index, const AluResult* table)
+{
+    // Mirrors inr/dcr, carry is preserved
+    emitLoadRegister(emitter, index, X64Register::RAX);
+    emitter.movImm64(X64Register::RCX, reinterpret_cast<std::uintptr_t>(table));
+    emitter.movzx16LoadIndexed(X64Register::RAX, X64Register::RCX, X64Register::RAX);
+    emitter.mov32(X64Register::RDX, X64Register::RAX);
+    emitter.shift32Imm(X64ShiftOperation::SHR, X64Register::RDX, 8);
+    emitter.alu32Imm(X64AluOperation::AND, FLAGS, ~FlagTables::INCREMENT_FLAGS & 0xFF);
+    emitter.alu32(X64AluOperation::OR, FLAGS, X64Register::RDX);
+    emitter.alu32Imm(X64AluOperation::AND, X64Register::RAX, 0xFF);
+    emitStoreRegister(emitter, index, X64Register::RAX);
+}
+
+void JitCpuImpl::interpretInstruction()
+{
+    const u8 opcode = CpuImpl::fetchOpcode();
+    executeInstruction(opcode);
+    stats.interpretedInstructions++;
+}
+
+bool JitCpuImpl::executeFallbackInstruction(u8 opcode, u16 operand, u16 nextPc)
+{
+    // Returns whether native code has to exit after this instruction
+    registers.getPc() = nextPc;
+    const auto write = OpcodeTraits::getMemoryWrite(opcode);
+    const auto addr = resolveWriteAddress(write, operand);
+    const auto invalidationsBefore = stats.invalidations;
+
+    (this->*operandDispatchTable[opcode])(operand);
+    materializeFlags();
+    stats.fallbackInstructions++;
+
+    if (write != MemoryWrite::NONE)
+    {
+        invalidateWrittenMemory(addr, write);
+    }
+    return halted || stats.invalidations != invalidationsBefore;
+}
+
+u32 JitCpuImpl::executeFallback(JitCpuImpl* cpu, u64 instruction)
+{
+    const u8 opcode = instruction & 0xFF;
+    const u16 operand = (instruction >> 8) & 0xFFFF;
+    const u16 nextPc = (instruction >> 24) & 0xFFFF;
+    return cpu->executeFallbackInstruction(opcode, operand, nextPc) ? 1 : 0;
+}
+
+void JitCpuImpl::invalidateWrittenMemory(u16 addr, MemoryWrite write)
+{
+    const auto length = OpcodeTraits::getMemoryWriteLength(write);
+    invalidateBlocks(addr, length);
+}
+
+void JitCpuImpl::flushCode()
+{
+    blocks.clear([](std::unique_ptr<JitBlock>) {});
+    codeEnd = codeStart;
+    stats.flushes++;
+}
+
+u32 JitCpuImpl::offsetOf(const void* member) const
+{
+    return static_cast<u32>(static_cast<const u8*>(member) - reinterpret_cast<const u8*>(this));
+}
@@ -0,0 +1,123 @@
+#pragma once
+
+#include "CodeBlockMap.hpp"
+#include "CpuImpl.hpp"
+#include "ExecutableMemory.hpp"
+#include "X64Emitter.hpp"
+
+struct JitStats
+{
+    u64 translatedBlocks;         // Blocks translated into native code
+    u64 nativeEntries;            // Entries into native code from dispatcher
+    u64 interpretedInstructions;  // Instructions executed by interpreter outside native code
+    u64 fallbackInstructions;     // Instructions executed by interpreter called from native code
+    u64 invalidations;            // Blocks dropped because memory they were translated from was written
+    u64 flushes;                  // Times whole code memory was reclaimed
+};
+
+// Dynamic recompiler translating basic blocks of guest code into x86-64 code.
+//
+// Inside translated code A, F, BC, DE and HL live in host registers. Register and
+// ALU instructions, jumps, XCHG, PCHL and SPHL are translated into native code.
+// Every other instruction (including all memory accesses, so side effects of the bus
+// are kept) is executed by interpreter called from native code. IN and OUT are never
+// translated, dispatcher executes them with interpreter between blocks.
+//
+// Blocks are chained: when a block exits, next one is looked up and entered
+// without returning to dispatcher, as long as it fits into remaining cycle budget.
+// Blocks which would not fit are executed by interpreter, so batches end on exactly
+// the same instruction as in other execution modes.
+//
+// Writes made by the cpu invalidate translated blocks covering written memory.
+// Anything else writing into memory holding code has to call invalidateBlocks().
+//
+// On other hosts than x86-64, or when executable memory cannot be allocated,
+// JitCpuImpl works as plain interpreter.
+class JitCpuImpl final : public CpuImpl
+{
+    public:
+        // Maximal number of instructions translated into single block
+        static constexpr unsigned MAX_BLOCK_INSTRUCTIONS = 32;
+        static constexpr std::size_t CODE_MEMORY_SIZE = 4 * 1024 * 1024;
+
+        JitCpuImpl(const std::shared_ptr<Bus>& busPtr);
+
+        ~JitCpuImpl() = default;
+
+        void executeInstruction(u8 opcode) override;
+
+        // Whether native code can be generated for host platform
+        static bool isJitSupported();
+
+        // Kill switch: when disabled, only the interpreter is used.
+        // Enabled by default whenever native code can be run. It cannot be
+        // enabled again once code memory failed to change its protection.
+        // Writes made while disabled are not tracked, so enabling it drops
+        // all translated blocks.
+        bool isJitEnabled() const;
+
+        void setJitEnabled(bool enabled);
+
+        // Drops translated blocks containing any byte of given memory range
+        void invalidateBlocks(u16 addr, u16 length);
+
+        // Drops all translated blocks and reclaims code memory
+        void invalidateAllBlocks();
+
+        const JitStats& getJitStats() const;
+
+        void resetJitStats();
+
+        std::size_t getCachedBlockCount() const;
+
+    protected:
+        void runUntilTarget() override;
+
+    private:
+        struct JitBlock
+        {
+            u16 startPc;
+            u16 length;
+            // Upper bound of cycles taken by block, checked against remaining budget before entering it
+            u64 maxCycles;
+            // Native code, nullptr when block cannot be translated
+            const u8* code;
+        };
+
+        using EntryFunction = void (*)(JitCpuImpl* cpu, const u8* code);
+
+        void generateStubs();
+        JitBlock& translateBlock(u16 pc);
+        bool emitBlock(X64Emitter& emitter, JitBlock& block);
+        bool emitInstruction(X64Emitter& emitter, u8 opcode, u16 operand, u16 nextPc, unsigned elapsedCycles);
+        void emitFallback(X64Emitter& emitter, u8 opcode, u16 operand, u16 nextPc, unsigned elapsedCycles, bool endsBlock);
+        void emitExit(X64Emitter& emitter, unsigned elapsedCycles, u16 pc);
+        void emitExit(X64Emitter& emitter, unsigned elapsedCycles);
+        void emitSpill(X64Emitter& emitter);
+        void emitReload(X64Emitter& emitter);
+        void emitLoadRegister(X64Emitter& emitter, unsigned index, X64Register dst);
+        void emitStoreRegister(X64Emitter& emitter, unsigned index, X64Register src);
+        void emitAlu(X64Emitter& emitter, unsigned operation);
+        void emitIncrement(X64Emitter& emitter, unsigned index, const AluResult* table);
+
+        void interpretInstruction();
+        bool executeFallbackInstruction(u8 opcode, u16 operand, u16 nextPc);
+        static u32 executeFallback(JitCpuImpl* cpu, u64 instruction);
+
+        void invalidateWrittenMemory(u16 addr, MemoryWrite write);
+        void flushCode();
+
+        u32 offsetOf(const void* member) const;
+
+        ExecutableMemory codeMemory;
+        std::size_t codeStart;
+        std::size_t codeEnd;
+        EntryFunction entry;
+        const u8* dispatchCode;
+        const u8* exitCode;
+        bool jitEnabled;
+        // Cleared when code memory cannot be made executable
+        bool codeUsable;
+        CodeBlockMap<JitBlock> blocks;
+        JitStats stats;
+};
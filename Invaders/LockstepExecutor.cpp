@@ -0,0 +1,268 @@
+#include "LockstepExecutor.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+#include <vector>
+
+#include "Disassembler.hpp"
+
+namespace
+{
+    constexpr std::size_t MAX_REPORTED_LOCATIONS = 4;
+
+    std::string toHex(unsigned value, unsigned digits)
+    {
+        char buffer[16];
+        std::snprintf(buffer, sizeof(buffer), "%0*X", static_cast<int>(digits), value);
+        return buffer;
+    }
+
+    std::string flagsToString(u8 flags)
+    {
+        FlagRegister f;
+        f.raw = flags;
+        std::string names;
+        names += f.S ? "S" : "";
+        names += f.Z ? "Z" : "";
+        names += f.AC ? "A" : "";
+        names += f.P ? "P" : "";
+        names += f.C ? "C" : "";
+        return toHex(flags, 2) + " [" + names + "]";
+    }
+
+    std::string writeToString(const std::vector<BusWrite>& writes, std::size_t index)
+    {
+        if (index >= writes.size())
+        {
+            return "none";
+        }
+        const auto& write = writes[index];
+        if (write.port)
+        {
+            return "OUT " + toHex(write.addr, 2) + "=" + toHex(write.value, 2);
+        }
+        return toHex(write.addr, 4) + "=" + toHex(write.value, 2);
+    }
+
+    void compareValue(std::ostream& out, unsigned& differences, const char* name, unsigned reference, unsigned tested, unsigned digits)
+    {
+        if (reference != tested)
+        {
+            out << "  " << name << ": " << toHex(reference, digits) << " / " << toHex(tested, digits) << "\n";
+            differences++;
+        }
+    }
+}
+
+LockstepExecutor::LockstepExecutor(const std::shared_ptr<Bus>& referenceBus, const CpuFactory& referenceFactory,
+                                   const std::shared_ptr<Bus>& testedBus, const CpuFactory& testedFactory)
+    : referenceBus(std::make_shared<RecordingBus>(referenceBus))
+    , testedBus(std::make_shared<RecordingBus>(testedBus))
+    , referenceCpu(referenceFactory(this->referenceBus))
+    , testedCpu(testedFactory(this->testedBus))
+    , checkInterval(DEFAULT_CHECK_INTERVAL)
+    , instructionCount(0)
+    , comparisonCount(0)
+    , history()
+    , diverged(false)
+    , divergenceReport()
+{
+}
+
+Cpu& LockstepExecutor::getReferenceCpu()
+{
+    return *referenceCpu;
+}
+
+Cpu& LockstepExecutor::getTestedCpu()
+{
+    return *testedCpu;
+}
+
+unsigned LockstepExecutor::getCheckInterval() const
+{
+    return checkInterval;
+}
+
+void LockstepExecutor::setCheckInterval(unsigned instructions)
+{
+    checkInterval = std::max(instructions, 1u);
+}
+
+void LockstepExecutor::requestInterrupt(u8 rstVector)
+{
+    referenceCpu->requestInterrupt(rstVector);
+    testedCpu->requestInterrupt(rstVector);
+}
+
+bool LockstepExecutor::run(u32 cycles)
+{
+    u64 elapsed = 0;
+    while (!diverged && elapsed < cycles)
+    {
+        u32 batch = 0;
+        for (unsigned i = 0; i < checkInterval && elapsed + batch < cycles; i++)
+        {
+            batch += stepReference(static_cast<u32>(cycles - elapsed - batch));
+        }
+        elapsed += batch;
+
+        // Reference overrun is a part of the batch, so tested cpu has to end exactly on it
+        compare(testedCpu->run(batch));
+    }
+    return !diverged;
+}
+
+bool LockstepExecutor::hasDiverged() const
+{
+    return diverged;
+}
+
+u64 LockstepExecutor::getInstructionCount() const
+{
+    return instructionCount;
+}
+
+u64 LockstepExecutor::getComparisonCount() const
+{
+    return comparisonCount;
+}
+
+void LockstepExecutor::writeDivergenceReport(std::ostream& out) const
+{
+    out << divergenceReport;
+}
+
+u32 LockstepExecutor::stepReference(u32 remainingCycles)
+{
+    const u16 pc = referenceCpu->getRegisters().getPc();
+    history[instructionCount % HISTORY_LENGTH] = { pc, referenceBus->getBus().fetchInstructionWindow(pc) };
+    instructionCount++;
+
+    // Budget of one cycle runs single instruction (or takes pending interrupt)
+    u32 cycles = 1 + referenceCpu->run(1);
+
+    // Halted cpu only waits for interrupt, which can arrive only between runs
+    if (referenceCpu->isHalted() && remainingCycles > cycles)
+    {
+        cycles += (remainingCycles - cycles) + referenceCpu->run(remainingCycles - cycles);
+    }
+    return cycles;
+}
+
+bool LockstepExecutor::compare(u32 testedOverrun)
+{
+    std::ostringstream out;
+    unsigned differences = 0;
+
+    auto& reference = referenceCpu->getRegisters();
+    auto& tested = testedCpu->getRegisters();
+    compareValue(out, differences, "PC", reference.getPc(), tested.getPc(), 4);
+    compareValue(out, differences, "A", reference.getAf().getHigh(), tested.getAf().getHigh(), 2);
+    if (reference.getAf().getLow().raw != tested.getAf().getLow().raw)
+    {
+        out << "  F: " << flagsToString(reference.getAf().getLow().raw) << " / " << flagsToString(tested.getAf().getLow().raw) << "\n";
+        differences++;
+    }
+    compareValue(out, differences, "BC", reference.getBc().getRaw(), tested.getBc().getRaw(), 4);
+    compareValue(out, differences, "DE", reference.getDe().getRaw(), tested.getDe().getRaw(), 4);
+    compareValue(out, differences, "HL", reference.getHl().getRaw(), tested.getHl().getRaw(), 4);
+    compareValue(out, differences, "SP", reference.getSp(), tested.getSp(), 4);
+    compareValue(out, differences, "Halted", referenceCpu->isHalted(), testedCpu->isHalted(), 1);
+    compareValue(out, differences, "INTE", referenceCpu->interruptsEnabled(), testedCpu->interruptsEnabled(), 1);
+    if (testedOverrun != 0)
+    {
+        out << "  Cycles: tested cpu overran batch by " << testedOverrun << "\n";
+        differences++;
+    }
+    compareWrites(out, differences);
+    compareReferencedMemory(out, differences);
+
+    referenceBus->clear();
+    testedBus->clear();
+    comparisonCount++;
+
+    if (differences == 0)
+    {
+        return true;
+    }
+
+    std::ostringstream report;
+    report << "Cpus diverged after " << instructionCount << " instructions, comparison "
+           << comparisonCount << " (reference / tested):\n" << out.str();
+    writeHistory(report);
+    divergenceReport = report.str();
+    diverged = true;
+    return false;
+}
+
+void LockstepExecutor::compareWrites(std::ostream& out, unsigned& differences) const
+{
+    const auto& referenceWrites = referenceBus->getWrites();
+    const auto& testedWrites = testedBus->getWrites();
+    const auto mismatch = std::mismatch(referenceWrites.begin(), referenceWrites.end(), testedWrites.begin(), testedWrites.end(),
+        [](const BusWrite& lhs, const BusWrite& rhs)
+        {
+            return lhs.addr == rhs.addr && lhs.value == rhs.value && lhs.port == rhs.port;
+        });
+    if (mismatch.first == referenceWrites.end() && mismatch.second == testedWrites.end())
+    {
+        return;
+    }
+
+    // Only the first different write is reported, later ones usually follow from it
+    const auto index = static_cast<std::size_t>(mismatch.first - referenceWrites.begin());
+    out << "  Write " << index << " of " << referenceWrites.size() << " / " << testedWrites.size() << ": "
+        << writeToString(referenceWrites, index) << " / " << writeToString(testedWrites, index) << "\n";
+    differences++;
+}
+
+void LockstepExecutor::compareReferencedMemory(std::ostream& out, unsigned& differences) const
+{
+    auto& reference = referenceBus->getBus();
+    auto& tested = testedBus->getBus();
+    std::vector<u16> differentAddresses;
+    for (const auto* addresses : { &referenceBus->getReferencedAddresses(), &testedBus->getReferencedAddresses() })
+    {
+        for (auto addr : *addresses)
+        {
+            if (reference.readFromMemory(addr) != tested.readFromMemory(addr))
+            {
+                differentAddresses.push_back(addr);
+            }
+        }
+    }
+    if (differentAddresses.empty())
+    {
+        return;
+    }
+
+    std::sort(differentAddresses.begin(), differentAddresses.end());
+    differentAddresses.erase(std::unique(differentAddresses.begin(), differentAddresses.end()), differentAddresses.end());
+    const auto reported = std::min(differentAddresses.size(), MAX_REPORTED_LOCATIONS);
+    for (std::size_t i = 0; i < reported; i++)
+    {
+        const auto addr = differentAddresses[i];
+        out << "  Memory " << toHex(addr, 4) << ": " << toHex(reference.readFromMemory(addr), 2)
+            << " / " << toHex(tested.readFromMemory(addr), 2) << "\n";
+    }
+    if (differentAddresses.size() > reported)
+    {
+        out << "  ... " << differentAddresses.size() - reported << " more memory locations\n";
+    }
+    differences += static_cast<unsigned>(differentAddresses.size());
+}
+
+void LockstepExecutor::writeHistory(std::ostream& out) const
+{
+    const u64 count = std::min<u64>(instructionCount, HISTORY_LENGTH);
+    out << "Last " << count << " reference instructions:\n";
+    for (u64 index = instructionCount - count; index < instructionCount; index++)
+    {
+        const auto& instruction = history[index % HISTORY_LENGTH];
+        const u8 opcode = instruction.window & 0xFF;
+        const u16 operand = (instruction.window >> 8) & 0xFFFF;
+        out << "  " << index << "  " << toHex(instruction.pc, 4) << "  " << Disassembler::disassemble(opcode, operand) << "\n";
+    }
+}
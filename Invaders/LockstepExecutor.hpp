@@ -0,0 +1,94 @@
+#pragma once
+
+#include <array>
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <string>
+
+#include "Cpu.hpp"
+#include "RecordingBus.hpp"
+
+// Creates cpu under test over bus given by executor
+using CpuFactory = std::function<std::unique_ptr<Cpu>(const std::shared_ptr<Bus>&)>;
+
+// Runs two cpu implementations side by side, each on its own copy of the machine,
+// and compares them to find the first instruction on which they disagree.
+//
+// Reference cpu is stepped one instruction at a time, what it took is recorded
+// into instruction history. Tested cpu then runs the same number of cycles in
+// one batch, which ends on the same instruction in every implementation, so
+// fast backends run blocks the way they normally do. After every check interval
+// registers, flags, bus writes and memory accessed through references are compared.
+// Smaller interval points at diverging instruction more precisely, interval of 1
+// compares after every instruction.
+class LockstepExecutor
+{
+    public:
+        static constexpr unsigned DEFAULT_CHECK_INTERVAL = 64;
+        static constexpr std::size_t HISTORY_LENGTH = 16;
+
+        // Buses have to hold identical machines, e.g. BusImpl and its copy
+        LockstepExecutor(const std::shared_ptr<Bus>& referenceBus, const CpuFactory& referenceFactory,
+                         const std::shared_ptr<Bus>& testedBus, const CpuFactory& testedFactory);
+
+        ~LockstepExecutor() = default;
+
+        // Registers of both cpus have to be set to the same values before run
+        Cpu& getReferenceCpu();
+
+        Cpu& getTestedCpu();
+
+        unsigned getCheckInterval() const;
+
+        // Number of reference instructions executed between comparisons, at least 1
+        void setCheckInterval(unsigned instructions);
+
+        void requestInterrupt(u8 rstVector);
+
+        // Runs both cpus until given number of cycles elapses. Cpus are compared at
+        // every check interval and at the end. Returns false once cpus diverged,
+        // further runs do nothing then.
+        bool run(u32 cycles);
+
+        bool hasDiverged() const;
+
+        // Reference instructions executed so far (taken interrupts included)
+        u64 getInstructionCount() const;
+
+        u64 getComparisonCount() const;
+
+        // Differences found by failed comparison followed by instructions preceding it,
+        // empty when cpus did not diverge
+        void writeDivergenceReport(std::ostream& out) const;
+
+    private:
+        struct ExecutedInstruction
+        {
+            u16 pc;
+            u32 window;  // Opcode with operands
+        };
+
+        // Returns cycles taken by reference instruction. Halted cpu waits out the remaining cycles.
+        u32 stepReference(u32 remainingCycles);
+
+        // Returns whether both cpus are in the same state, builds report if not
+        bool compare(u32 testedOverrun);
+
+        void compareWrites(std::ostream& out, unsigned& differences) const;
+
+        void compareReferencedMemory(std::ostream& out, unsigned& differences) const;
+
+        void writeHistory(std::ostream& out) const;
+
+        std::shared_ptr<RecordingBus> referenceBus;
+        std::shared_ptr<RecordingBus> testedBus;
+        std::unique_ptr<Cpu> referenceCpu;
+        std::unique_ptr<Cpu> testedCpu;
+        unsigned checkInterval;
+        u64 instructionCount;
+        u64 comparisonCount;
+        std::array<ExecutedInstruction, HISTORY_LENGTH> history;
+        bool diverged;
+        std::string divergenceReport;
+};
@@ -0,0 +1,22 @@
+#pragma once
+
+// Expands F(opcode) for every one of 256 opcodes, in ascending order.
+// Used where handler labels or switch cases have to be spelled out
+// for each opcode separately.
+#define FOR_EACH_OPCODE(F) \
+    F(0x00) F(0x01) F(0x02) F(0x03) F(0x04) F(0x05) F(0x06) F(0x07) F(0x08) F(0x09) F(0x0A) F(0x0B) F(0x0C) F(0x0D) F(0x0E) F(0x0F) \
+    F(0x10) F(0x11) F(0x12) F(0x13) F(0x14) F(0x15) F(0x16) F(0x17) F(0x18) F(0x19) F(0x1A) F(0x1B) F(0x1C) F(0x1D) F(0x1E) F(0x1F) \
+    F(0x20) F(0x21) F(0x22) F(0x23) F(0x24) F(0x25) F(0x26) F(0x27) F(0x28) F(0x29) F(0x2A) F(0x2B) F(0x2C) F(0x2D) F(0x2E) F(0x2F) \
+    F(0x30) F(0x31) F(0x32) F(0x33) F(0x34) F(0x35) F(0x36) F(0x37) F(0x38) F(0x39) F(0x3A) F(0x3B) F(0x3C) F(0x3D) F(0x3E) F(0x3F) \
+    F(0x40) F(0x41) F(0x42) F(0x43) F(0x44) F(0x45) F(0x46) F(0x47) F(0x48) F(0x49) F(0x4A) F(0x4B) F(0x4C) F(0x4D) F(0x4E) F(0x4F) \
+    F(0x50) F(0x51) F(0x52) F(0x53) F(0x54) F(0x55) F(0x56) F(0x57) F(0x58) F(0x59) F(0x5A) F(0x5B) F(0x5C) F(0x5D) F(0x5E) F(0x5F) \
+    F(0x60) F(0x61) F(0x62) F(0x63) F(0x64) F(0x65) F(0x66) F(0x67) F(0x68) F(0x69) F(0x6A) F(0x6B) F(0x6C) F(0x6D) F(0x6E) F(0x6F) \
+    F(0x70) F(0x71) F(0x72) F(0x73) F(0x74) F(0x75) F(0x76) F(0x77) F(0x78) F(0x79) F(0x7A) F(0x7B) F(0x7C) F(0x7D) F(0x7E) F(0x7F) \
+    F(0x80) F(0x81) F(0x82) F(0x83) F(0x84) F(0x85) F(0x86) F(0x87) F(0x88) F(0x89) F(0x8A) F(0x8B) F(0x8C) F(0x8D) F(0x8E) F(0x8F) \
+    F(0x90) F(0x91) F(0x92) F(0x93) F(0x94) F(0x95) F(0x96) F(0x97) F(0x98) F(0x99) F(0x9A) F(0x9B) F(0x9C) F(0x9D) F(0x9E) F(0x9F) \
+    F(0xA0) F(0xA1) F(0xA2) F(0xA3) F(0xA4) F(0xA5) F(0xA6) F(0xA7) F(0xA8) F(0xA9) F(0xAA) F(0xAB) F(0xAC) F(0xAD) F(0xAE) F(0xAF) \
+    F(0xB0) F(0xB1) F(0xB2) F(0xB3) F(0xB4) F(0xB5) F(0xB6) F(0xB7) F(0xB8) F(0xB9) F(0xBA) F(0xBB) F(0xBC) F(0xBD) F(0xBE) F(0xBF) \
+    F(0xC0) F(0xC1) F(0xC2) F(0xC3) F(0xC4) F(0xC5) F(0xC6) F(0xC7) F(0xC8) F(0xC9) F(0xCA) F(0xCB) F(0xCC) F(0xCD) F(0xCE) F(0xCF) \
+    F(0xD0) F(0xD1) F(0xD2) F(0xD3) F(0xD4) F(0xD5) F(0xD6) F(0xD7) F(0xD8) F(0xD9) F(0xDA) F(0xDB) F(0xDC) F(0xDD) F(0xDE) F(0xDF) \
+    F(0xE0) F(0xE1) F(0xE2) F(0xE3) F(0xE4) F(0xE5) F(0xE6) F(0xE7) F(0xE8) F(0xE9) F(0xEA) F(0xEB) F(0xEC) F(0xED) F(0xEE) F(0xEF) \
+    F(0xF0) F(0xF1) F(0xF2) F(0xF3) F(0xF4) F(0xF5) F(0xF6) F(0xF7) F(0xF8) F(0xF9) F(0xFA) F(0xFB) F(0xFC) F(0xFD) F(0xFE) F(0xFF)
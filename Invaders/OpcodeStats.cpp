@@ -0,0 +1,132 @@
+#include "OpcodeStats.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <numeric>
+#include <string>
+
+#include "Disassembler.hpp"
+
+namespace
+{
+    const char* const GROUP_NAMES[] = {
+        "first (loads and stores, INR/DCR, 16 bit, rotations)",
+        "second (MOV, HLT)",
+        "third (ALU with register)",
+        "fourth (ALU with immedate, jumps, calls, stack, I/O)"
+    };
+
+    std::string toHex(unsigned value)
+    {
+        char buffer[4];
+        std::snprintf(buffer, sizeof(buffer), "%02X", value);
+        return buffer;
+    }
+
+    double toPercent(u64 value, u64 total)
+    {
+        return total != 0 ? 100.0 * value / total : 0.0;
+    }
+}
+
+OpcodeStats::OpcodeStats()
+    : executions()
+    , cycleCounts()
+{
+}
+
+u64 OpcodeStats::getExecutions(u8 opcode) const
+{
+    return executions[opcode];
+}
+
+u64 OpcodeStats::getCycles(u8 opcode) const
+{
+    return cycleCounts[opcode];
+}
+
+u64 OpcodeStats::getGroupExecutions(std::size_t group) const
+{
+    const auto first = executions.begin() + group * 0x40;
+    return std::accumulate(first, first + 0x40, u64(0));
+}
+
+u64 OpcodeStats::getGroupCycles(std::size_t group) const
+{
+    const auto first = cycleCounts.begin() + group * 0x40;
+    return std::accumulate(first, first + 0x40, u64(0));
+}
+
+u64 OpcodeStats::getTotalExecutions() const
+{
+    return std::accumulate(executions.begin(), executions.end(), u64(0));
+}
+
+void OpcodeStats::reset()
+{
+    executions.fill(0);
+    cycleCounts.fill(0);
+}
+
+void OpcodeStats::writeText(std::ostream& out, std::size_t count) const
+{
+    const auto totalExecutions = getTotalExecutions();
+    const auto totalCycles = std::accumulate(cycleCounts.begin(), cycleCounts.end(), u64(0));
+    out << "Executed instructions: " << totalExecutions << ", cycles: " << totalCycles << "\n";
+
+    for (std::size_t group = 0; group < GROUP_COUNT; group++)
+    {
+        out << "  " << GROUP_NAMES[group] << ": " << getGroupExecutions(group) << "  "
+            << toPercent(getGroupExecutions(group), totalExecutions) << "%, "
+            << getGroupCycles(group) << " cycles\n";
+    }
+
+    std::size_t executedCount = 0;
+    const auto opcodes = getSortedOpcodes(executedCount);
+    out << "Executed opcodes: " << executedCount << " of 256\n";
+    for (std::size_t i = 0; i < std::min(count, executedCount); i++)
+    {
+        const auto opcode = opcodes[i];
+        out << "  " << toHex(opcode) << "  " << Disassembler::getMnemonic(opcode) << ": " << executions[opcode] << "  "
+            << toPercent(executions[opcode], totalExecutions) << "%, " << cycleCounts[opcode] << " cycles\n";
+    }
+}
+
+void OpcodeStats::writeJson(std::ostream& out) const
+{
+    out << "{\n";
+    out << "  \"executions\": " << getTotalExecutions() << ",\n";
+    out << "  \"groups\": [";
+    for (std::size_t group = 0; group < GROUP_COUNT; group++)
+    {
+        out << (group != 0 ? ", " : "") << "{ \"executions\": " << getGroupExecutions(group) << ", \"cycles\": " << getGroupCycles(group) << " }";
+    }
+    out << "],\n";
+
+    std::size_t executedCount = 0;
+    const auto opcodes = getSortedOpcodes(executedCount);
+    out << "  \"opcodes\": [\n";
+    for (std::size_t i = 0; i < executedCount; i++)
+    {
+        const auto opcode = opcodes[i];
+        out << "    { \"opcode\": \"" << toHex(opcode) << "\", \"mnemonic\": \"" << Disassembler::getMnemonic(opcode)
+            << "\", \"executions\": " << executions[opcode] << ", \"cycles\": " << cycleCounts[opcode] << " }"
+            << (i + 1 < executedCount ? ",\n" : "\n");
+    }
+    out << "  ]\n";
+    out << "}\n";
+}
+
+std::array<u8, 256> OpcodeStats::getSortedOpcodes(std::size_t& executedCount) const
+{
+    std::array<u8, 256> opcodes;
+    for (std::size_t opcode = 0; opcode < opcodes.size(); opcode++)
+    {
+        opcodes[opcode] = static_cast<u8>(opcode);
+    }
+
+    // Stable, so opcodes executed equally often stay in numeric order
+    std::stable_sort(opcodes.begin(), opcodes.end(), [this](u8 lhs, u8 rhs) { return executions[lhs] > executions[rhs]; });
+    executedCount = static_cast<std::size_t>(std::count_if(executions.begin(), executions.end(), [](u64 count) { return count != 0; }));
+    return opcodes;
+}
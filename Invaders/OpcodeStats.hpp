@@ -0,0 +1,59 @@
+#pragma once
+
+#include <array>
+#include <ostream>
+
+#include "Types.hpp"
+
+// Instrumentation build option. When defined as 1 (e.g. in preprocessor definitions
+// of the project), interpreter counts executions and cycles of every opcode.
+// Otherwise counting compiles to nothing and statistics stay empty.
+#ifndef OPCODE_STATS_ENABLED
+#define OPCODE_STATS_ENABLED 0
+#endif
+
+// Executions and cycles of every opcode. Handler groups are the four
+// execute*GroupInstruction paths of the decoder, selected by the top two bits
+// of the opcode, and are counted in table dispatch mode as well.
+class OpcodeStats
+{
+    public:
+        static constexpr bool ENABLED = OPCODE_STATS_ENABLED != 0;
+        static constexpr std::size_t GROUP_COUNT = 4;
+
+        OpcodeStats();
+
+        ~OpcodeStats() = default;
+
+        void record(u8 opcode, u64 cycles)
+        {
+            executions[opcode]++;
+            cycleCounts[opcode] += cycles;
+        }
+
+        u64 getExecutions(u8 opcode) const;
+
+        // Includes extra cycles of taken conditional calls and returns
+        u64 getCycles(u8 opcode) const;
+
+        u64 getGroupExecutions(std::size_t group) const;
+
+        u64 getGroupCycles(std::size_t group) const;
+
+        u64 getTotalExecutions() const;
+
+        void reset();
+
+        // Totals, handler groups and given number of most executed opcodes
+        void writeText(std::ostream& out, std::size_t count = 256) const;
+
+        // All executed opcodes, most executed first
+        void writeJson(std::ostream& out) const;
+
+    private:
+        // Executed opcodes sorted by number of executions, descending
+        std::array<u8, 256> getSortedOpcodes(std::size_t& executedCount) const;
+
+        std::array<u64, 256> executions;
+        std::array<u64, 256> cycleCounts;
+};
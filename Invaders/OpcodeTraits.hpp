@@ -0,0 +1,265 @@
+#pragma once
+
+#include "Types.hpp"
+
+// Memory written by instruction, described by what its address is taken from
+enum class MemoryWrite
+{
+    NONE = 0,
+    HL = 1,                // Single byte at HL
+    BC = 2,                // Single byte at BC
+    DE = 3,                // Single byte at DE
+    IMMEDATE_BYTE = 4,     // Single byte at immedate address
+    IMMEDATE_WORD = 5,     // Two bytes at immedate address
+    STACK_PUSH = 6,        // Two bytes below SP
+    STACK_TOP = 7          // Two bytes at SP
+};
+
+class OpcodeTraits
+{
+    public:
+        // Additional cycles taken by conditional CALL and RET when condition is met
+        static constexpr unsigned CONDITION_MET_EXTRA_CYCLES = 6;
+
+        // Opcode bitfields in following format
+        //
+        // |xx|yy y|zzz|
+        // |  |pp|q|   |
+
+        static constexpr unsigned getX(u8 opcode)
+        {
+            return (opcode >> 6) & 3;
+        }
+
+        static constexpr unsigned getY(u8 opcode)
+        {
+            return (opcode >> 3) & 7;
+        }
+
+        static constexpr unsigned getZ(u8 opcode)
+        {
+            return opcode & 7;
+        }
+
+        static constexpr unsigned getP(u8 opcode)
+        {
+            return getY(opcode) >> 1;
+        }
+
+        static constexpr unsigned getQ(u8 opcode)
+        {
+            return getY(opcode) % 2;
+        }
+
+        // Length of instruction in bytes, including opcode
+        static constexpr unsigned getLength(u8 opcode)
+        {
+            const auto x = getX(opcode);
+            const auto y = getY(opcode);
+            const auto z = getZ(opcode);
+            const auto p = getP(opcode);
+            const auto q = getQ(opcode);
+
+            if (x == 0)
+            {
+                if (z == 1 && q == 0)
+                    return 3; // LXI
+                if (z == 2 && p >= 2)
+                    return 3; // SHLD, LHLD, STA, LDA
+                if (z == 6)
+                    return 2; // MVI
+            }
+            else if (x == 3)
+            {
+                if (z == 2 || z == 4)
+                    return 3; // Jcc, Ccc
+                if (z == 3 && y < 2)
+                    return 3; // JMP
+                if (z == 3 && y < 4)
+                    return 2; // OUT, IN
+                if (z == 5 && q == 1)
+                    return 3; // CALL
+                if (z == 6)
+                    return 2; // ALU immedate
+            }
+            return 1;
+        }
+
+        // Number of 2 MHz clock cycles taken by instruction.
+        // For conditional CALL and RET it is number of cycles when condition is not met.
+        static constexpr unsigned getCycles(u8 opcode)
+        {
+            const auto x = getX(opcode);
+            const auto y = getY(opcode);
+            const auto z = getZ(opcode);
+            const auto p = getP(opcode);
+            const auto q = getQ(opcode);
+
+            if (x == 0)
+            {
+                constexpr unsigned loadStoreCycles[] = { 7, 7, 16, 13 };
+                switch (z)
+                {
+                    case 0: return 4;                              // NOP
+                    case 1: return 10;                             // LXI, DAD
+                    case 2: return loadStoreCycles[p];             // STAX, LDAX, SHLD, LHLD, STA, LDA
+                    case 3: return 5;                              // INX, DCX
+                    case 4:
+                    case 5: return y == 6 ? 10 : 5;                // INR, DCR
+                    case 6: return y == 6 ? 10 : 7;                // MVI
+                    default: return 4;                             // Rotations, DAA, CMA, STC, CMC
+                }
+            }
+            if (x == 1)
+            {
+                if (y == 6 && z == 6)
+                    return 7;                                      // HLT
+                return (y == 6 || z == 6) ? 7 : 5;                 // MOV
+            }
+            if (x == 2)
+            {
+                return z == 6 ? 7 : 4;                             // ALU register
+            }
+
+            constexpr unsigned miscCycles[] = { 10, 10, 10, 10, 18, 4, 4, 4 };
+            switch (z)
+            {
+                case 0: return 5;                                  // Rcc
+                case 1: return (q == 0 || p < 2) ? 10 : 5;         // POP, RET, PCHL, SPHL
+                case 2: return 10;                                 // Jcc
+                case 3: return miscCycles[y];                      // JMP, OUT, IN, XTHL, XCHG, DI, EI
+                case 4: return 11;                                 // Ccc
+                case 5: return q == 0 ? 11 : 17;                   // PUSH, CALL
+                case 6: return 7;                                  // ALU immedate
+                default: return 11;                                // RST
+            }
+        }
+
+        // Cycles taken by instruction when condition of conditional CALL or RET is met
+        static constexpr unsigned getMaxCycles(u8 opcode)
+        {
+            const auto x = getX(opcode);
+            const auto z = getZ(opcode);
+            const bool conditionalCallOrReturn = x == 3 && (z == 0 || z == 4);
+            return getCycles(opcode) + (conditionalCallOrReturn ? CONDITION_MET_EXTRA_CYCLES : 0);
+        }
+
+        // Whether instruction may transfer control somewhere else than next instruction
+        // (jumps, calls, returns, restarts and HLT)
+        static constexpr bool endsBasicBlock(u8 opcode)
+        {
+            const auto x = getX(opcode);
+            const auto y = getY(opcode);
+            const auto z = getZ(opcode);
+            const auto p = getP(opcode);
+            const auto q = getQ(opcode);
+
+            if (x == 1)
+                return y == 6 && z == 6;                           // HLT
+            if (x != 3)
+                return false;
+
+            switch (z)
+            {
+                case 0: return true;                               // Rcc
+                case 1: return q == 1 && p < 3;                    // RET, PCHL
+                case 2: return true;                               // Jcc
+                case 3: return y < 2;                              // JMP
+                case 4: return true;                               // Ccc
+                case 5: return q == 1;                             // CALL
+                case 6: return false;                              // ALU immedate
+                default: return true;                              // RST
+            }
+        }
+
+        // Memory which may be written by instruction
+        static constexpr MemoryWrite getMemoryWrite(u8 opcode)
+        {
+            const auto x = getX(opcode);
+            const auto y = getY(opcode);
+            const auto z = getZ(opcode);
+            const auto p = getP(opcode);
+            const auto q = getQ(opcode);
+
+            if (x == 0)
+            {
+                if (z == 2 && q == 0)
+                {
+                    constexpr MemoryWrite stores[] = {
+                        MemoryWrite::BC, MemoryWrite::DE, MemoryWrite::IMMEDATE_WORD, MemoryWrite::IMMEDATE_BYTE
+                    };
+                    return stores[p];                              // STAX, SHLD, STA
+                }
+                if (z >= 4 && z <= 6 && y == 6)
+                    return MemoryWrite::HL;                        // INR M, DCR M, MVI M
+            }
+            else if (x == 1)
+            {
+                if (y == 6 && z != 6)
+                    return MemoryWrite::HL;                        // MOV M,r
+            }
+            else if (x == 3)
+            {
+                if (z == 4 || z == 5 || z == 7)
+                    return MemoryWrite::STACK_PUSH;                // Ccc, PUSH, CALL, RST
+                if (z == 3 && y == 4)
+                    return MemoryWrite::STACK_TOP;                 // XTHL
+            }
+            return MemoryWrite::NONE;
+        }
+
+        // Memory which may be read by instruction as data, described the same way as
+        // written memory (STACK_TOP for pops). Instruction fetches are not included.
+        static constexpr MemoryWrite getMemoryRead(u8 opcode)
+        {
+            const auto x = getX(opcode);
+            const auto y = getY(opcode);
+            const auto z = getZ(opcode);
+            const auto p = getP(opcode);
+            const auto q = getQ(opcode);
+
+            if (x == 0)
+            {
+                if (z == 2 && q == 1)
+                {
+                    constexpr MemoryWrite loads[] = {
+                        MemoryWrite::BC, MemoryWrite::DE, MemoryWrite::IMMEDATE_WORD, MemoryWrite::IMMEDATE_BYTE
+                    };
+                    return loads[p];                               // LDAX, LHLD, LDA
+                }
+                if ((z == 4 || z == 5) && y == 6)
+                    return MemoryWrite::HL;                        // INR M, DCR M
+            }
+            else if (x == 1)
+            {
+                if (z == 6 && y != 6)
+                    return MemoryWrite::HL;                        // MOV r,M
+            }
+            else if (x == 2)
+            {
+                if (z == 6)
+                    return MemoryWrite::HL;                        // ALU M
+            }
+            else
+            {
+                if (z == 0 || (z == 1 && (q == 0 || p <= 1)))
+                    return MemoryWrite::STACK_TOP;                 // Rcc, POP, RET and its alias
+                if (z == 3 && y == 4)
+                    return MemoryWrite::STACK_TOP;                 // XTHL
+            }
+            return MemoryWrite::NONE;
+        }
+
+        // Number of bytes written by instruction
+        static constexpr unsigned getMemoryWriteLength(MemoryWrite write)
+        {
+            switch (write)
+            {
+                case MemoryWrite::NONE: return 0;
+                case MemoryWrite::IMMEDATE_WORD:
+                case MemoryWrite::STACK_PUSH:
+                case MemoryWrite::STACK_TOP: return 2;
+                default: return 1;
+            }
+        }
+};
@@ -0,0 +1,112 @@
+#include "ReachableCodeMap.hpp"
+
+#include <cstring>
+
+#include "RecompiledCpuImpl.hpp"
+
+namespace
+{
+    const char MAGIC[8] = "I8080CM";
+
+    void writeAddresses(std::ostream& out, const std::vector<u16>& addresses)
+    {
+        out.write(reinterpret_cast<const char*>(addresses.data()), addresses.size() * sizeof(u16));
+    }
+
+    bool readAddresses(std::istream& in, u32 count, std::vector<u16>& addresses)
+    {
+        addresses.resize(count);
+        return static_cast<bool>(in.read(reinterpret_cast<char*>(addresses.data()), addresses.size() * sizeof(u16)));
+    }
+}
+
+ReachableCodeMap::ReachableCodeMap()
+    : origin(0)
+    , length(0)
+    , checksum(RecompiledCpuImpl::computeChecksum(nullptr, 0))
+    , blocks()
+    , routines()
+{
+}
+
+ReachableCodeMap::ReachableCodeMap(u16 origin, const std::vector<u8>& image, const std::vector<u16>& blocks, const std::vector<u16>& routines)
+    : origin(origin)
+    , length(static_cast<u32>(image.size()))
+    , checksum(RecompiledCpuImpl::computeChecksum(image.data(), image.size()))
+    , blocks(blocks)
+    , routines(routines)
+{
+}
+
+u16 ReachableCodeMap::getOrigin() const
+{
+    return origin;
+}
+
+u32 ReachableCodeMap::getLength() const
+{
+    return length;
+}
+
+const std::vector<u16>& ReachableCodeMap::getBlocks() const
+{
+    return blocks;
+}
+
+const std::vector<u16>& ReachableCodeMap::getRoutines() const
+{
+    return routines;
+}
+
+bool ReachableCodeMap::matches(u16 imageOrigin, const std::vector<u8>& image) const
+{
+    return imageOrigin == origin
+        && image.size() == length
+        && RecompiledCpuImpl::computeChecksum(image.data(), image.size()) == checksum;
+}
+
+bool ReachableCodeMap::matchesMemory(const Bus& bus) const
+{
+    std::vector<u8> memory(length);
+    for (u32 i = 0; i < length; i++)
+    {
+        memory[i] = bus.readFromMemory(static_cast<u16>(origin + i));
+    }
+    return matches(origin, memory);
+}
+
+void ReachableCodeMap::write(std::ostream& out) const
+{
+    CodeMapFileHeader header;
+    std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+    header.version = FILE_VERSION;
+    header.origin = origin;
+    header.length = length;
+    header.checksum = checksum;
+    header.blockCount = static_cast<u32>(blocks.size());
+    header.routineCount = static_cast<u32>(routines.size());
+
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    writeAddresses(out, blocks);
+    writeAddresses(out, routines);
+}
+
+bool ReachableCodeMap::read(std::istream& in, ReachableCodeMap& map)
+{
+    CodeMapFileHeader header;
+    if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))
+        || std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0
+        || header.version != FILE_VERSION
+        || header.origin > 0xFFFF
+        || header.origin + header.length > 0x10000
+        || header.blockCount > 0x10000
+        || header.routineCount > 0x10000)
+    {
+        return false;
+    }
+
+    map.origin = static_cast<u16>(header.origin);
+    map.length = header.length;
+    map.checksum = header.checksum;
+    return readAddresses(in, header.blockCount, map.blocks) && readAddresses(in, header.routineCount, map.routines);
+}
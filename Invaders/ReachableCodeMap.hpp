@@ -0,0 +1,65 @@
+#pragma once
+
+#include <istream>
+#include <ostream>
+#include <vector>
+
+#include "Bus.hpp"
+
+// Code map file, little endian:
+//   CodeMapFileHeader
+//   u16[blockCount]    start addresses of basic blocks
+//   u16[routineCount]  start addresses of routines
+struct CodeMapFileHeader
+{
+    char magic[8];      // "I8080CM" with terminating zero
+    u32 version;
+    u32 origin;
+    u32 length;         // Bytes of analyzed image
+    u32 checksum;       // Checksum of analyzed image, see RecompiledCpuImpl::computeChecksum()
+    u32 blockCount;
+    u32 routineCount;
+};
+
+// Reachable code of ROM image found by ControlFlowAnalyzer, loaded at startup by
+// BlockCacheCpuImpl::predecodeBlocks() or passed to StaticRecompiler as entry points.
+// Map is valid only for the image it was made from, which is checked by matches().
+class ReachableCodeMap
+{
+    public:
+        static constexpr u32 FILE_VERSION = 1;
+
+        ReachableCodeMap();
+
+        ReachableCodeMap(u16 origin, const std::vector<u8>& image, const std::vector<u16>& blocks, const std::vector<u16>& routines);
+
+        ~ReachableCodeMap() = default;
+
+        u16 getOrigin() const;
+
+        u32 getLength() const;
+
+        // Start addresses of basic blocks, sorted
+        const std::vector<u16>& getBlocks() const;
+
+        // Entry points, targets of calls and restarts and targets of resolved
+        // jump tables, which control may reach from outside of their routine. Sorted.
+        const std::vector<u16>& getRoutines() const;
+
+        // Whether image is the one map was made from
+        bool matches(u16 imageOrigin, const std::vector<u8>& image) const;
+
+        // Whether memory seen through bus holds the image map was made from
+        bool matchesMemory(const Bus& bus) const;
+
+        void write(std::ostream& out) const;
+
+        static bool read(std::istream& in, ReachableCodeMap& map);
+
+    private:
+        u16 origin;
+        u32 length;
+        u32 checksum;
+        std::vector<u16> blocks;
+        std::vector<u16> routines;
+};
@@ -0,0 +1,107 @@
+#include "RecompiledCpuImpl.hpp"
+
+RecompiledCpuImpl::RecompiledCpuImpl(const std::shared_ptr<Bus>& busPtr, const RecompiledProgram& program)
+    : CpuImpl(busPtr, DispatchMode::TABLE)
+    , program(program)
+    , routines(0x10000, nullptr)
+    , recompiledCodeEnabled(true)
+    , memoryChecked(false)
+    , stats()
+{
+    // Earlier entries win, so blocks are entered through routines starting at them when possible
+    for (std::size_t i = 0; i < program.entryCount; i++)
+    {
+        const auto& entry = program.entries[i];
+        if (routines[entry.addr] == nullptr)
+        {
+            routines[entry.addr] = entry.routine;
+        }
+    }
+}
+
+bool RecompiledCpuImpl::matchesMemory() const
+{
+    std::vector<u8> memory(program.length);
+    for (u32 i = 0; i < program.length; i++)
+    {
+        memory[i] = bus->readFromMemory(static_cast<u16>(program.origin + i));
+    }
+    return computeChecksum(memory.data(), memory.size()) == program.checksum;
+}
+
+bool RecompiledCpuImpl::isRecompiledCodeEnabled() const
+{
+    return recompiledCodeEnabled;
+}
+
+void RecompiledCpuImpl::setRecompiledCodeEnabled(bool enabled)
+{
+    recompiledCodeEnabled = enabled;
+}
+
+const RecompiledStats& RecompiledCpuImpl::getRecompiledStats() const
+{
+    return stats;
+}
+
+void RecompiledCpuImpl::resetRecompiledStats()
+{
+    stats = RecompiledStats();
+}
+
+u32 RecompiledCpuImpl::computeChecksum(const u8* data, std::size_t length)
+{
+    u32 hash = 0x811C9DC5;
+    for (std::size_t i = 0; i < length; i++)
+    {
+        hash ^= data[i];
+        hash *= 0x01000193;
+    }
+    return hash;
+}
+
+void RecompiledCpuImpl::runUntilTarget()
+{
+    // Memory is usually loaded after cpu is created, so it is checked here
+    if (!memoryChecked)
+    {
+        memoryChecked = true;
+        if (!matchesMemory())
+        {
+            setRecompiledCodeEnabled(false);
+        }
+    }
+
+    if (!recompiledCodeEnabled)
+    {
+        CpuImpl::runUntilTarget();
+        return;
+    }
+
+    while (cycles < cycleTarget)
+    {
+        const auto routine = routines[registers.getPc()];
+        const auto cyclesBefore = cycles;
+        if (routine != nullptr)
+        {
+            routine(*this);
+        }
+
+        // Routine returns without executing anything when first block does not fit into budget
+        if (cycles != cyclesBefore)
+        {
+            stats.routineEntries++;
+        }
+        else
+        {
+            interpretInstruction();
+        }
+    }
+}
+
+void RecompiledCpuImpl::interpretInstruction()
+{
+    const u8 opcode = CpuImpl::fetchOpcode();
+    executeInstruction(opcode);
+    stats.interpretedInstructions++;
+}
@@ -0,0 +1,107 @@
+#pragma once
+
+#include <vector>
+
+#include "CpuImpl.hpp"
+
+class RecompiledCpuImpl;
+
+// Routine produced by Recompiler tool. Executes translated blocks starting
+// from current PC, and returns when control leaves the routine or when next
+// block does not fit into cycle budget.
+using RecompiledRoutine = void (*)(RecompiledCpuImpl& cpu);
+
+struct RecompiledEntry
+{
+    u16 addr;                   // Start of translated block
+    RecompiledRoutine routine;  // Routine which can be entered at that block
+};
+
+// Program produced by Recompiler tool
+struct RecompiledProgram
+{
+    u16 origin;                      // Start of translated memory
+    u32 length;                      // Length of translated memory
+    u32 checksum;                    // Checksum of translated memory, see computeChecksum()
+    const RecompiledEntry* entries;  // Routine entry points first, then other blocks
+    std::size_t entryCount;
+};
+
+struct RecompiledStats
+{
+    u64 routineEntries;           // Calls into translated routines which executed anything
+    u64 interpretedInstructions;  // Instructions executed by interpreter
+};
+
+// Cpu running guest code translated ahead of time into C++ by Recompiler tool.
+// Addresses which have no translated block (code in RAM, targets of PCHL not
+// known during translation) are executed by interpreter, and translated
+// code is entered again as soon as PC reaches start of translated block.
+//
+// Translated memory is assumed to never change (it is ROM). matchesMemory()
+// tells whether memory holds the same code program was translated from. It is
+// checked on the first run, and translated code is disabled when it does not
+// match, so program made from different ROM falls back to the interpreter.
+class RecompiledCpuImpl final : public CpuImpl
+{
+    public:
+        RecompiledCpuImpl(const std::shared_ptr<Bus>& busPtr, const RecompiledProgram& program);
+
+        ~RecompiledCpuImpl() = default;
+
+        bool matchesMemory() const;
+
+        // Kill switch: when disabled, only the interpreter is used
+        bool isRecompiledCodeEnabled() const;
+
+        void setRecompiledCodeEnabled(bool enabled);
+
+        const RecompiledStats& getRecompiledStats() const;
+
+        void resetRecompiledStats();
+
+        // FNV-1a hash of given memory
+        static u32 computeChecksum(const u8* data, std::size_t length);
+
+        // Interface of generated code
+
+        u16 getPc();
+
+        // Whether block taking up to given number of cycles fits into budget
+        bool enterBlock(u32 maxCycles) const;
+
+        // Executes instruction whose operand was already decoded
+        template <u8 opcode>
+        void step(u16 nextPc, u16 operand);
+
+    protected:
+        void runUntilTarget() override;
+
+    private:
+        void interpretInstruction();
+
+        const RecompiledProgram& program;
+        // Routine which can be entered at given address, indexed by address
+        std::vector<RecompiledRoutine> routines;
+        bool recompiledCodeEnabled;
+        bool memoryChecked;
+        RecompiledStats stats;
+};
+
+inline u16 RecompiledCpuImpl::getPc()
+{
+    return registers.getPc();
+}
+
+inline bool RecompiledCpuImpl::enterBlock(u32 maxCycles) const
+{
+    return cycles + maxCycles <= cycleTarget;
+}
+
+template <u8 opcode>
+inline void RecompiledCpuImpl::step(u16 nextPc, u16 operand)
+{
+    registers.getPc() = nextPc;
+    executeOpcodeWithOperand<opcode>(operand);
+    cycles += OpcodeTraits::getCycles(opcode);
+}
@@ -0,0 +1,30 @@
+#include "RecordingBus.hpp"
+
+RecordingBus::RecordingBus(const std::shared_ptr<Bus>& busPtr)
+    : bus(busPtr)
+    , writes()
+    , referencedAddresses()
+{
+}
+
+Bus& RecordingBus::getBus()
+{
+    return *bus;
+}
+
+const std::vector<BusWrite>& RecordingBus::getWrites() const
+{
+    return writes;
+}
+
+const std::vector<u16>& RecordingBus::getReferencedAddresses() const
+{
+    return referencedAddresses;
+}
+
+void RecordingBus::clear()
+{
+    // Capacity is kept, so recording does not allocate once it warms up
+    writes.clear();
+    referencedAddresses.clear();
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+#include "Bus.hpp"
+
+struct BusWrite
+{
+    u16 addr;    // Memory address, or port number of output port write
+    u8 value;
+    bool port;
+};
+
+// Bus decorator remembering what cpu wrote since it was last cleared.
+// Word writes are recorded as two byte writes, so cpus using different
+// accessors for the same instruction produce the same record.
+//
+// Writes through getMemoryLocationRef cannot be seen, so address of every
+// handed out reference is remembered instead and the location has to be
+// read back afterwards.
+class RecordingBus final : public Bus
+{
+    public:
+        RecordingBus(const std::shared_ptr<Bus>& busPtr);
+
+        ~RecordingBus() = default;
+
+        u8 readFromMemory(u16 addr) const override
+        {
+            return bus->readFromMemory(addr);
+        }
+
+        void writeIntoMemory(u16 addr, u8 value) override
+        {
+            writes.push_back({ addr, value, false });
+            bus->writeIntoMemory(addr, value);
+        }
+
+        u16 readWordFromMemory(u16 addr) const override
+        {
+            return bus->readWordFromMemory(addr);
+        }
+
+        void writeWordIntoMemory(u16 addr, u16 value) override
+        {
+            writes.push_back({ addr, static_cast<u8>(value & 0xFF), false });
+            writes.push_back({ static_cast<u16>(addr + 1), static_cast<u8>(value >> 8), false });
+            bus->writeWordIntoMemory(addr, value);
+        }
+
+        u8 fetchFromMemory(u16 addr) const override
+        {
+            return bus->fetchFromMemory(addr);
+        }
+
+        u16 fetchWordFromMemory(u16 addr) const override
+        {
+            return bus->fetchWordFromMemory(addr);
+        }
+
+        u32 fetchInstructionWindow(u16 addr) const override
+        {
+            return bus->fetchInstructionWindow(addr);
+        }
+
+        u8 readFromInputPort(u8 port) const override
+        {
+            return bus->readFromInputPort(port);
+        }
+
+        void writeIntoOutputPort(u8 port, u8 value) override
+        {
+            writes.push_back({ port, value, true });
+            bus->writeIntoOutputPort(port, value);
+        }
+
+        u16 getAddressMask() const override
+        {
+            return bus->getAddressMask();
+        }
+
+        u8& getMemoryLocationRef(u16 addr) override
+        {
+            referencedAddresses.push_back(addr);
+            return bus->getMemoryLocationRef(addr);
+        }
+
+        // Decorated bus, accessing it directly is not recorded
+        Bus& getBus();
+
+        const std::vector<BusWrite>& getWrites() const;
+
+        const std::vector<u16>& getReferencedAddresses() const;
+
+        void clear();
+
+    private:
+        std::shared_ptr<Bus> bus;
+        std::vector<BusWrite> writes;
+        std::vector<u16> referencedAddresses;
+};
@@ -0,0 +1,82 @@
+#pragma once
+
+#include <array>
+
+#include "RegisterPair.hpp"
+#include "FlagRegister.hpp"
+
+// Storage of all cpu registers in one flat block, which can be indexed
+// directly by register fields of an opcode.
+//
+// Register pairs are stored as consecutive 16 bit words (BC, DE, HL, SP, AF),
+// so pair field of an opcode is index of the word. Bytes of 8 bit registers
+// are found through table mapping register field to offset inside the block,
+// which takes byte order of the host into account.
+class RegisterFile
+{
+    public:
+        // Indexes of words holding register pairs
+        static constexpr unsigned BC = 0;
+        static constexpr unsigned DE = 1;
+        static constexpr unsigned HL = 2;
+        static constexpr unsigned SP = 3;
+        static constexpr unsigned AF = 4;
+        static constexpr unsigned WORD_COUNT = 5;
+
+        // Register field of an opcode selecting (HL) memory operand instead of register
+        static constexpr unsigned MEMORY_OPERAND = 6;
+
+        RegisterFile() = default;
+
+        ~RegisterFile() = default;
+
+        // Register table: B, C, D, E, H, L, -, A.
+        // Index 6 is memory operand, which has to be resolved by the caller.
+        u8& getRegister(unsigned index);
+
+        // Register pair table 1: BC, DE, HL, SP
+        u16& getRegisterPair(unsigned index);
+
+        // Register pair table 2: BC, DE, HL, AF
+        u16& getStackRegisterPair(unsigned index);
+
+        RegisterPair<u16, u8, FlagRegister>& getAf();
+
+        RegisterPair<u16, u8, u8>& getBc();
+
+        RegisterPair<u16, u8, u8>& getDe();
+
+        RegisterPair<u16, u8, u8>& getHl();
+
+        u16& getSp();
+
+    private:
+        // Offsets of bytes inside word
+        static constexpr unsigned HIGH = HOST_BIG_ENDIAN ? 0 : 1;
+        static constexpr unsigned LOW = HOST_BIG_ENDIAN ? 1 : 0;
+
+        // Offsets of registers from register table inside the block,
+        // entry of memory operand is never used
+        static constexpr std::array<u8, 8> REGISTER_OFFSETS = { {
+            BC * 2 + HIGH, BC * 2 + LOW, DE * 2 + HIGH, DE * 2 + LOW,
+            HL * 2 + HIGH, HL * 2 + LOW, SP * 2 + LOW, AF * 2 + HIGH
+        } };
+        // Words of register pairs from register pair table 2
+        static constexpr std::array<u8, 4> STACK_PAIR_WORDS = { { BC, DE, HL, AF } };
+
+        union
+        {
+            struct
+            {
+                RegisterPair<u16, u8, u8> bc;
+                RegisterPair<u16, u8, u8> de;
+                RegisterPair<u16, u8, u8> hl;
+                u16 sp;
+                RegisterPair<u16, u8, FlagRegister> af;
+            };
+            u16 words[WORD_COUNT];
+            u8 bytes[WORD_COUNT * 2];
+        };
+};
+
+#include "RegisterFile.inl"
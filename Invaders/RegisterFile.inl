@@ -0,0 +1,39 @@
+inline u8& RegisterFile::getRegister(unsigned index)
+{
+    return bytes[REGISTER_OFFSETS[index]];
+}
+
+inline u16& RegisterFile::getRegisterPair(unsigned index)
+{
+    return words[index];
+}
+
+inline u16& RegisterFile::getStackRegisterPair(unsigned index)
+{
+    return words[STACK_PAIR_WORDS[index]];
+}
+
+inline RegisterPair<u16, u8, FlagRegister>& RegisterFile::getAf()
+{
+    return af;
+}
+
+inline RegisterPair<u16, u8, u8>& RegisterFile::getBc()
+{
+    return bc;
+}
+
+inline RegisterPair<u16, u8, u8>& RegisterFile::getDe()
+{
+    return de;
+}
+
+inline RegisterPair<u16, u8, u8>& RegisterFile::getHl()
+{
+    return hl;
+}
+
+inline u16& RegisterFile::getSp()
+{
+    return sp;
+}
@@ -1,5 +1,7 @@
 #pragma once
 
+#include "Types.hpp"
+
 template <typename TRaw, typename THigh, typename TLow>
 class RegisterPair
 {
@@ -7,8 +9,13 @@ class RegisterPair
     {
         struct
         {
+#if HOST_BIG_ENDIAN
+            THigh high;
+            TLow low;
+#else
             TLow low;
             THigh high;
+#endif
         };
         TRaw raw;
     };
@@ -1,16 +1,13 @@
 #pragma once
 
-#include "RegisterPair.hpp"
-#include "FlagRegister.hpp"
+#include "RegisterFile.hpp"
 
+// Named view of cpu registers, kept in flat RegisterFile which
+// instruction handlers index by register fields of an opcode
 class Registers
 {
-    RegisterPair<u16, u8, FlagRegister> af;
-    RegisterPair<u16, u8, u8> bc;
-    RegisterPair<u16, u8, u8> de;
-    RegisterPair<u16, u8, u8> hl;
+    RegisterFile file;
 
-    u16 sp;
     u16 pc;
 
     public:
@@ -29,4 +26,8 @@ class Registers
         u16& getPc();
 
         u16& getSp();
-};
\ No newline at end of file
+
+        RegisterFile& getFile();
+};
+
+#include "Registers.inl"
@@ -0,0 +1,34 @@
+inline RegisterPair<u16, u8, FlagRegister>& Registers::getAf()
+{
+    return file.getAf();
+}
+
+inline RegisterPair<u16, u8, u8>& Registers::getBc()
+{
+    return file.getBc();
+}
+
+inline RegisterPair<u16, u8, u8>& Registers::getDe()
+{
+    return file.getDe();
+}
+
+inline RegisterPair<u16, u8, u8>& Registers::getHl()
+{
+    return file.getHl();
+}
+
+inline u16& Registers::getPc()
+{
+    return pc;
+}
+
+inline u16& Registers::getSp()
+{
+    return file.getSp();
+}
+
+inline RegisterFile& Registers::getFile()
+{
+    return file;
+}
@@ -0,0 +1,335 @@
+#include <cstdio>
+
+#include "OpcodeTraits.hpp"
+#include "RecompiledCpuImpl.hpp"
+#include "StaticRecompiler.hpp"
+
+namespace
+{
+    constexpr u8 EI_OPCODE = 0xFB;
+
+    std::string toHex(unsigned value, unsigned digits)
+    {
+        char buffer[16];
+        std::snprintf(buffer, sizeof(buffer), "0x%0*X", static_cast<int>(digits), value);
+        return buffer;
+    }
+
+    std::string toLabel(u16 addr)
+    {
+        char buffer[16];
+        std::snprintf(buffer, sizeof(buffer), "block_%04X", addr);
+        return buffer;
+    }
+
+    std::string toRoutineName(u16 addr)
+    {
+        char buffer[16];
+        std::snprintf(buffer, sizeof(buffer), "routine_%04X", addr);
+        return buffer;
+    }
+}
+
+StaticRecompiler::StaticRecompiler(u16 origin, const std::vector<u8>& image)
+    : origin(origin)
+    , image(image)
+    , entryPoints()
+    , routines()
+{
+}
+
+void StaticRecompiler::addEntryPoint(u16 addr)
+{
+    entryPoints.push_back(addr);
+}
+
+void StaticRecompiler::analyze()
+{
+    routines.clear();
+
+    std::vector<u16> routineQueue(entryPoints.rbegin(), entryPoints.rend());
+    while (!routineQueue.empty())
+    {
+        const u16 entry = routineQueue.back();
+        routineQueue.pop_back();
+        if (contains(entry, 1) && routines.find(entry) == routines.end())
+        {
+            analyzeRoutine(entry, routineQueue);
+        }
+    }
+}
+
+std::vector<u16> StaticRecompiler::getRoutines() const
+{
+    std::vector<u16> result;
+    for (const auto& routine : routines)
+    {
+        result.push_back(routine.first);
+    }
+    return result;
+}
+
+const std::set<u16>& StaticRecompiler::getBlocks(u16 routine) const
+{
+    return routines.at(routine);
+}
+
+void StaticRecompiler::generate(std::ostream& out, const std::string& programName, const std::string& includePath) const
+{
+    const auto checksum = RecompiledCpuImpl::computeChecksum(image.data(), image.size());
+    const auto last = origin + static_cast<unsigned>(image.size()) - 1;
+
+    out << "// Generated by Recompiler from " << toHex(origin, 4) << "-" << toHex(last, 4) << ", do not edit.\n";
+    out << "// Declare with: extern const RecompiledProgram " << programName << ";\n";
+    out << "\n";
+    out << "#include \"" << includePath << "\"\n";
+    out << "\n";
+    out << "namespace\n";
+    out << "{\n";
+
+    for (const auto& routine : routines)
+    {
+        generateRoutine(out, routine.first);
+        out << "\n";
+    }
+
+    // Routine entry points go first, so they take precedence over
+    // the same blocks reachable in the middle of other routines
+    std::size_t entryCount = 0;
+    out << "    const RecompiledEntry entries[] = {\n";
+    for (const auto& routine : routines)
+    {
+        out << "        { " << toHex(routine.first, 4) << ", " << toRoutineName(routine.first) << " },\n";
+        entryCount++;
+    }
+    for (const auto& routine : routines)
+    {
+        for (auto block : routine.second)
+        {
+            if (block != routine.first)
+            {
+                out << "        { " << toHex(block, 4) << ", " << toRoutineName(routine.first) << " },\n";
+                entryCount++;
+            }
+        }
+    }
+    out << "    };\n";
+    out << "}\n";
+    out << "\n";
+    out << "extern const RecompiledProgram " << programName << " = {\n";
+    out << "    " << toHex(origin, 4) << ", " << image.size() << ", " << toHex(checksum, 8) << ", entries, " << entryCount << "\n";
+    out << "};\n";
+}
+
+bool StaticRecompiler::contains(u16 addr, unsigned length) const
+{
+    return addr >= origin && static_cast<std::size_t>(addr - origin) + length <= image.size();
+}
+
+u8 StaticRecompiler::readByte(u16 addr) const
+{
+    return image[addr - origin];
+}
+
+u16 StaticRecompiler::readOperand(u16 addr, unsigned length) const
+{
+    if (length == 2)
+        return readByte(addr + 1);
+    if (length == 3)
+        return readByte(addr + 1) | (readByte(addr + 2) << 8);
+    return 0;
+}
+
+void StaticRecompiler::analyzeRoutine(u16 entry, std::vector<u16>& routineQueue)
+{
+    auto& blocks = routines[entry];
+    std::vector<u16> leaders = { entry };
+
+    while (!leaders.empty())
+    {
+        u16 addr = leaders.back();
+        leaders.pop_back();
+        if (!contains(addr, 1) || blocks.count(addr) != 0)
+        {
+            continue;
+        }
+        blocks.insert(addr);
+
+        for (unsigned instructions = 1; ; instructions++)
+        {
+            const u8 opcode = readByte(addr);
+            const auto length = OpcodeTraits::getLength(opcode);
+            if (!contains(addr, length))
+            {
+                break;
+            }
+
+            const u16 operand = readOperand(addr, length);
+            const u16 next = addr + length;
+            if (OpcodeTraits::endsBasicBlock(opcode))
+            {
+                const auto y = OpcodeTraits::getY(opcode);
+                const auto z = OpcodeTraits::getZ(opcode);
+                const auto q = OpcodeTraits::getQ(opcode);
+
+                if (OpcodeTraits::getX(opcode) == 1)
+                {
+                    leaders.push_back(next);              // HLT, interrupt handler returns after it
+                }
+                else if (z == 2 || (z == 3 && y < 2))
+                {
+                    leaders.push_back(operand);           // Jcc, JMP
+                    if (z == 2)
+                        leaders.push_back(next);
+                }
+                else if (z == 4 || (z == 5 && q == 1))
+                {
+                    routineQueue.push_back(operand);      // Ccc, CALL
+                    leaders.push_back(next);
+                }
+                else if (z == 7)
+                {
+                    routineQueue.push_back(y * 8);        // RST
+                    leaders.push_back(next);
+                }
+                else if (z == 0)
+                {
+                    leaders.push_back(next);              // Rcc
+                }
+                break;
+            }
+
+            // EI lowers budget when interrupt is pending, instruction after it
+            // starts new block, so budget is checked again
+            if (instructions == MAX_BLOCK_INSTRUCTIONS || opcode == EI_OPCODE)
+            {
+                leaders.push_back(next);
+                break;
+            }
+            addr = next;
+        }
+    }
+}
+
+void StaticRecompiler::generateRoutine(std::ostream& out, u16 entry) const
+{
+    const auto& blocks = routines.at(entry);
+
+    out << "    void " << toRoutineName(entry) << "(RecompiledCpuImpl& cpu)\n";
+    out << "    {\n";
+    out << "        switch (cpu.getPc())\n";
+    out << "        {\n";
+    for (auto block : blocks)
+    {
+        out << "            case " << toHex(block, 4) << ": goto " << toLabel(block) << ";\n";
+    }
+    out << "            default: return;\n";
+    out << "        }\n";
+
+    for (auto block : blocks)
+    {
+        // Instructions are collected first, as budget check needs their cycles
+        std::vector<u16> instructions;
+        unsigned maxCycles = 0;
+        u16 addr = block;
+        bool ended = false;
+        bool truncated = false;
+
+        while (true)
+        {
+            const u8 opcode = readByte(addr);
+            const auto length = OpcodeTraits::getLength(opcode);
+            if (!contains(addr, length))
+            {
+                truncated = true;
+                break;
+            }
+
+            instructions.push_back(addr);
+            maxCycles += OpcodeTraits::getMaxCycles(opcode);
+            addr += length;
+
+            if (OpcodeTraits::endsBasicBlock(opcode))
+            {
+                ended = true;
+                break;
+            }
+            if (instructions.size() == MAX_BLOCK_INSTRUCTIONS || blocks.count(addr) != 0)
+            {
+                break;
+            }
+        }
+
+        out << "\n";
+        out << "    " << toLabel(block) << ":\n";
+        if (instructions.empty())
+        {
+            out << "        return;\n";
+            continue;
+        }
+
+        out << "        if (!cpu.enterBlock(" << maxCycles << ")) return;\n";
+        for (auto instruction : instructions)
+        {
+            const u8 opcode = readByte(instruction);
+            const auto length = OpcodeTraits::getLength(opcode);
+            out << "        cpu.step<" << toHex(opcode, 2) << ">("
+                << toHex(static_cast<u16>(instruction + length), 4) << ", "
+                << toHex(readOperand(instruction, length), 4) << ");\n";
+        }
+
+        const u16 last = instructions.back();
+        const u8 opcode = readByte(last);
+        const u16 next = addr;
+        const auto y = OpcodeTraits::getY(opcode);
+        const auto z = OpcodeTraits::getZ(opcode);
+        const bool jump = OpcodeTraits::getX(opcode) == 3 && (z == 2 || (z == 3 && y < 2));
+        const bool conditionalCallOrReturn = OpcodeTraits::getX(opcode) == 3 && (z == 0 || z == 4);
+
+        if (truncated)
+        {
+            out << "        return;\n";
+        }
+        else if (!ended)
+        {
+            generateTransfer(out, blocks, next);
+        }
+        else if (jump)
+        {
+            const u16 target = readOperand(last, 3);
+            if (z == 2)
+            {
+                out << "        if (cpu.getPc() == " << toHex(target, 4) << ")\n    ";
+                generateTransfer(out, blocks, target);
+                generateTransfer(out, blocks, next);
+            }
+            else
+            {
+                generateTransfer(out, blocks, target);
+            }
+        }
+        else if (conditionalCallOrReturn && blocks.count(next) != 0)
+        {
+            out << "        if (cpu.getPc() == " << toHex(next, 4) << ")\n    ";
+            generateTransfer(out, blocks, next);
+            out << "        return;\n";
+        }
+        else
+        {
+            out << "        return;\n";
+        }
+    }
+    out << "    }\n";
+}
+
+void StaticRecompiler::generateTransfer(std::ostream& out, const std::set<u16>& blocks, u16 target) const
+{
+    if (blocks.count(target) != 0)
+    {
+        out << "        goto " << toLabel(target) << ";\n";
+    }
+    else
+    {
+        out << "        return;\n";
+    }
+}
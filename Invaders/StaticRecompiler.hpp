@@ -0,0 +1,61 @@
+#pragma once
+
+#include <map>
+#include <ostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "Types.hpp"
+
+// Translates 8080 code into C++ source run by RecompiledCpuImpl.
+//
+// Code is discovered by following control flow from entry points. Every entry
+// point and target of CALL or RST starts a routine, which gets all blocks reachable
+// from it through jumps, and addresses following calls (where calls return).
+// Blocks are emitted as labels of one function per routine, jumps between them
+// are gotos. Anything leaving the routine (calls, returns, PCHL, jumps to other
+// routines) returns to dispatcher of RecompiledCpuImpl.
+//
+// Every instruction is executed by the same handler as in CpuImpl, so behaviour
+// (flags, cycles, bus accesses) is identical.
+class StaticRecompiler
+{
+    public:
+        // Maximal number of instructions translated into single block
+        static constexpr unsigned MAX_BLOCK_INSTRUCTIONS = 32;
+
+        StaticRecompiler(u16 origin, const std::vector<u8>& image);
+
+        ~StaticRecompiler() = default;
+
+        // Address where execution may start (reset vector, interrupt handlers)
+        void addEntryPoint(u16 addr);
+
+        // Discovers routines reachable from entry points
+        void analyze();
+
+        // Start addresses of discovered routines
+        std::vector<u16> getRoutines() const;
+
+        // Start addresses of blocks belonging to given routine
+        const std::set<u16>& getBlocks(u16 routine) const;
+
+        // Writes C++ source defining RecompiledProgram with given name.
+        // Generated file includes RecompiledCpuImpl.hpp through given path.
+        void generate(std::ostream& out, const std::string& programName, const std::string& includePath) const;
+
+    private:
+        bool contains(u16 addr, unsigned length) const;
+        u8 readByte(u16 addr) const;
+        u16 readOperand(u16 addr, unsigned length) const;
+
+        void analyzeRoutine(u16 entry, std::vector<u16>& routineQueue);
+        void generateRoutine(std::ostream& out, u16 entry) const;
+        void generateTransfer(std::ostream& out, const std::set<u16>& blocks, u16 target) const;
+
+        u16 origin;
+        std::vector<u8> image;
+        std::vector<u16> entryPoints;
+        std::map<u16, std::set<u16>> routines;
+};
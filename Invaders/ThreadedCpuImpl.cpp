@@ -0,0 +1,101 @@
+#include "ThreadedCpuImpl.hpp"
+#include "OpcodeList.hpp"
+
+#if defined(__GNUC__) || defined(__clang__)
+#define THREADED_DISPATCH_COMPUTED_GOTO
+#endif
+
+namespace
+{
+    constexpr u8 HALT_OPCODE = 0x76;
+}
+
+ThreadedCpuImpl::ThreadedCpuImpl(const std::shared_ptr<Bus>& busPtr)
+    : CpuImpl(busPtr, DispatchMode::TABLE)
+{
+}
+
+unsigned long ThreadedCpuImpl::executeInstructions(unsigned long count)
+{
+    if (count == 0 || halted)
+    {
+        return 0;
+    }
+
+    return dispatch<true>(count);
+}
+
+void ThreadedCpuImpl::runUntilTarget()
+{
+    if (cycles < cycleTarget)
+    {
+        dispatch<false>(0);
+    }
+}
+
+template <bool countInstructions>
+unsigned long ThreadedCpuImpl::dispatch(unsigned long count)
+{
+    // Either given number of instructions is executed (stopping on HLT),
+    // or instructions are executed until cycle counter reaches cycleTarget
+    // (HLT lowers cycleTarget on its own)
+
+    unsigned long remaining = count;
+
+#ifdef THREADED_DISPATCH_COMPUTED_GOTO
+
+    #define LABEL_ADDRESS(opcode) &&opcode_##opcode,
+    static void* const labels[256] = { FOR_EACH_OPCODE(LABEL_ADDRESS) };
+    #undef LABEL_ADDRESS
+
+    goto *labels[CpuImpl::fetchOpcode()];
+
+    #define OPCODE_HANDLER(opcode)                                          \
+        opcode_##opcode:                                                    \
+            executeOpcode<opcode>();                                        \
+            cycles += OpcodeTraits::getCycles(opcode);                      \
+            if constexpr (countInstructions)                                \
+            {                                                               \
+                if (--remaining == 0 || opcode == HALT_OPCODE)              \
+                    goto done;                                              \
+            }                                                               \
+            else if (cycles >= cycleTarget)                                 \
+            {                                                               \
+                goto done;                                                  \
+            }                                                               \
+            goto *labels[CpuImpl::fetchOpcode()];
+    FOR_EACH_OPCODE(OPCODE_HANDLER)
+    #undef OPCODE_HANDLER
+
+done:
+
+#else
+
+    while (true)
+    {
+        switch (CpuImpl::fetchOpcode())
+        {
+            #define OPCODE_HANDLER(opcode)                              \
+                case opcode:                                            \
+                    executeOpcode<opcode>();                            \
+                    cycles += OpcodeTraits::getCycles(opcode);          \
+                    break;
+            FOR_EACH_OPCODE(OPCODE_HANDLER)
+            #undef OPCODE_HANDLER
+        }
+
+        if constexpr (countInstructions)
+        {
+            if (--remaining == 0 || halted)
+                break;
+        }
+        else if (cycles >= cycleTarget)
+        {
+            break;
+        }
+    }
+
+#endif
+
+    return count - remaining;
+}
@@ -0,0 +1,26 @@
+#pragma once
+
+#include "CpuImpl.hpp"
+
+// Interpreter running direct-threaded dispatch loop: every opcode handler
+// fetches next opcode and jumps straight to its handler, without returning
+// into central loop. Uses computed goto on GCC/Clang and falls back to
+// switch inside loop on other compilers.
+class ThreadedCpuImpl final : public CpuImpl
+{
+    public:
+        ThreadedCpuImpl(const std::shared_ptr<Bus>& busPtr);
+
+        ~ThreadedCpuImpl() = default;
+
+        // Executes up to given number of instructions, stopping early when cpu halts.
+        // Returns number of instructions executed.
+        unsigned long executeInstructions(unsigned long count);
+
+    protected:
+        void runUntilTarget() override;
+
+    private:
+        template <bool countInstructions>
+        unsigned long dispatch(unsigned long count);
+};
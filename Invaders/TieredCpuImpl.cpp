@@ -0,0 +1,107 @@
+#include "TieredCpuImpl.hpp"
+
+namespace
+{
+    const char* const TIER_NAMES[] = { "interpreter", "block cache" };
+}
+
+TieredCpuImpl::TieredCpuImpl(const std::shared_ptr<Bus>& busPtr)
+    : BlockCacheCpuImpl(busPtr)
+    , hotness(0x10000, 0)
+    , promotionThreshold(DEFAULT_PROMOTION_THRESHOLD)
+    , tierStats()
+{
+}
+
+u32 TieredCpuImpl::getPromotionThreshold() const
+{
+    return promotionThreshold;
+}
+
+void TieredCpuImpl::setPromotionThreshold(u32 threshold)
+{
+    promotionThreshold = threshold;
+}
+
+u32 TieredCpuImpl::getHotness(u16 pc) const
+{
+    return hotness[pc];
+}
+
+const TierStats& TieredCpuImpl::getTierStats() const
+{
+    return tierStats;
+}
+
+void TieredCpuImpl::resetTierStats()
+{
+    tierStats = TierStats();
+}
+
+void TieredCpuImpl::writeTierReport(std::ostream& out) const
+{
+    u64 totalCycles = 0;
+    for (auto tierCycles : tierStats.cycles)
+    {
+        totalCycles += tierCycles;
+    }
+
+    out << "Promotions: " << tierStats.promotions << ", demotions: " << tierStats.demotions << "\n";
+    for (std::size_t tier = 0; tier < tierStats.cycles.size(); tier++)
+    {
+        const auto share = totalCycles != 0 ? 100.0 * tierStats.cycles[tier] / totalCycles : 0.0;
+        out << "  " << TIER_NAMES[tier] << ": " << tierStats.blockEntries[tier] << " blocks, "
+            << tierStats.cycles[tier] << " cycles  " << share << "%\n";
+    }
+}
+
+void TieredCpuImpl::runUntilTarget()
+{
+    while (cycles < cycleTarget)
+    {
+        const u16 pc = registers.getPc();
+        const u64 cyclesBefore = cycles;
+
+        if (!isBlockCached(pc))
+        {
+            if (hotness[pc] < promotionThreshold)
+            {
+                hotness[pc]++;
+                interpretBlock();
+                addTierTime(ExecutionTier::INTERPRETER, cyclesBefore);
+                continue;
+            }
+            tierStats.promotions++;
+        }
+
+        executeBlockAt(pc);
+        addTierTime(ExecutionTier::BLOCK_CACHE, cyclesBefore);
+    }
+}
+
+void TieredCpuImpl::onBlockInvalidated(u16 startPc)
+{
+    hotness[startPc] = 0;
+    tierStats.demotions++;
+}
+
+void TieredCpuImpl::interpretBlock()
+{
+    // Block cache version of executeInstruction invalidates promoted blocks written by instruction
+    unsigned instructions = 0;
+    u8 opcode;
+    do
+    {
+        opcode = CpuImpl::fetchOpcode();
+        BlockCacheCpuImpl::executeInstruction(opcode);
+        instructions++;
+    }
+    while (!OpcodeTraits::endsBasicBlock(opcode) && instructions < MAX_BLOCK_INSTRUCTIONS && cycles < cycleTarget);
+}
+
+void TieredCpuImpl::addTierTime(ExecutionTier tier, u64 cyclesBefore)
+{
+    const auto index = static_cast<std::size_t>(tier);
+    tierStats.blockEntries[index]++;
+    tierStats.cycles[index] += cycles - cyclesBefore;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <array>
+#include <ostream>
+#include <vector>
+
+#include "BlockCacheCpuImpl.hpp"
+
+enum class ExecutionTier
+{
+    INTERPRETER = 0,  // Instructions fetched and decoded one by one
+    BLOCK_CACHE = 1,  // Predecoded and fused blocks
+    COUNT = 2
+};
+
+struct TierStats
+{
+    u64 promotions;  // Blocks which crossed hotness threshold and were decoded
+    u64 demotions;   // Promoted blocks dropped because memory they were decoded from was written
+    // Indexed by ExecutionTier
+    std::array<u64, static_cast<std::size_t>(ExecutionTier::COUNT)> blockEntries;
+    std::array<u64, static_cast<std::size_t>(ExecutionTier::COUNT)> cycles;
+};
+
+// Cpu counting how many times every block of guest code was entered. Cold blocks
+// are interpreted instruction by instruction, so code which runs only a few times
+// (like startup) does not pay for decoding. Block entered more times than hotness
+// threshold is promoted into block cache. When memory it was decoded from is written,
+// block is demoted back to interpreter and has to become hot again.
+//
+// Both tiers check cycle target after every instruction, so batches end at exactly
+// the same instruction as in other execution modes.
+class TieredCpuImpl final : public BlockCacheCpuImpl
+{
+    public:
+        static constexpr u32 DEFAULT_PROMOTION_THRESHOLD = 16;
+
+        TieredCpuImpl(const std::shared_ptr<Bus>& busPtr);
+
+        ~TieredCpuImpl() = default;
+
+        u32 getPromotionThreshold() const;
+
+        // Number of entries after which block is promoted, 0 promotes every block
+        // on first entry. Does not affect blocks which are already promoted.
+        void setPromotionThreshold(u32 threshold);
+
+        // Number of times block starting at given address was entered in interpreter
+        // since it was last demoted
+        u32 getHotness(u16 pc) const;
+
+        const TierStats& getTierStats() const;
+
+        void resetTierStats();
+
+        // Writes block entries and cycles spent in every tier, with promotions and demotions
+        void writeTierReport(std::ostream& out) const;
+
+    protected:
+        void runUntilTarget() override;
+
+        void onBlockInvalidated(u16 startPc) override;
+
+    private:
+        // Runs instructions up to the end of basic block, the same one which would be decoded
+        void interpretBlock();
+
+        void addTierTime(ExecutionTier tier, u64 cyclesBefore);
+
+        std::vector<u32> hotness;
+        u32 promotionThreshold;
+        TierStats tierStats;
+};
@@ -0,0 +1,118 @@
+#include "ToolSupport.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <iterator>
+
+#include "BlockCacheCpuImpl.hpp"
+#include "JitCpuImpl.hpp"
+#include "ThreadedCpuImpl.hpp"
+#include "TieredCpuImpl.hpp"
+
+namespace
+{
+    template <typename TCpu>
+    std::unique_ptr<CpuImpl> createCpu(const std::shared_ptr<Bus>& bus)
+    {
+        return std::make_unique<TCpu>(bus);
+    }
+
+    std::unique_ptr<CpuImpl> createDecoderCpu(const std::shared_ptr<Bus>& bus)
+    {
+        auto cpu = std::make_unique<CpuImpl>(bus);
+        cpu->setDispatchMode(DispatchMode::DECODER);
+        return cpu;
+    }
+}
+
+const std::vector<CpuBackend>& ToolSupport::getBackends()
+{
+    static const std::vector<CpuBackend> backends = {
+        { "decoder", createDecoderCpu },
+        { "table", createCpu<CpuImpl> },
+        { "threaded", createCpu<ThreadedCpuImpl> },
+        { "block", createCpu<BlockCacheCpuImpl> },
+        { "tiered", createCpu<TieredCpuImpl> },
+        { "jit", createCpu<JitCpuImpl> }
+    };
+    return backends;
+}
+
+const CpuBackend* ToolSupport::findBackend(const std::string& name)
+{
+    const auto& backends = getBackends();
+    const auto backend = std::find_if(backends.begin(), backends.end(), [&](const CpuBackend& b) { return name == b.name; });
+    return backend == backends.end() ? nullptr : &*backend;
+}
+
+std::string ToolSupport::getBackendNames()
+{
+    std::string names;
+    for (const auto& backend : getBackends())
+    {
+        names += (names.empty() ? "" : "|") + std::string(backend.name);
+    }
+    return names;
+}
+
+bool ToolSupport::parseNumber(const std::string& text, unsigned& value)
+{
+    char* end = nullptr;
+    value = std::strtoul(text.c_str(), &end, 0);
+    return !text.empty() && *end == '\0';
+}
+
+bool ToolSupport::parseAddress(const std::string& text, u16& addr)
+{
+    unsigned value = 0;
+    if (!parseNumber(text, value) || value > 0xFFFF)
+    {
+        return false;
+    }
+    addr = static_cast<u16>(value);
+    return true;
+}
+
+bool ToolSupport::loadRomFile(const std::string& argument, RomFile& rom, std::string& error)
+{
+    const auto separator = argument.find(':');
+    if (separator == std::string::npos || !parseAddress(argument.substr(0, separator), rom.addr))
+    {
+        error = "Expected <address>:<file>, got " + argument;
+        return false;
+    }
+
+    const auto path = argument.substr(separator + 1);
+    std::ifstream file(path, std::ios::binary);
+    if (!file)
+    {
+        error = "Cannot open " + path;
+        return false;
+    }
+    rom.data.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    return true;
+}
+
+bool ToolSupport::buildImage(const std::vector<RomFile>& roms, u16& origin, std::vector<u8>& image)
+{
+    unsigned start = 0xFFFF;
+    unsigned end = 0;
+    for (const auto& rom : roms)
+    {
+        start = std::min<unsigned>(start, rom.addr);
+        end = std::max<unsigned>(end, rom.addr + static_cast<unsigned>(rom.data.size()));
+    }
+    if (end > 0x10000 || end <= start)
+    {
+        return false;
+    }
+
+    origin = static_cast<u16>(start);
+    image.assign(end - start, 0);
+    for (const auto& rom : roms)
+    {
+        std::copy(rom.data.begin(), rom.data.end(), image.begin() + (rom.addr - start));
+    }
+    return true;
+}
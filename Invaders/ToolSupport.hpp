@@ -0,0 +1,49 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Bus.hpp"
+#include "CpuImpl.hpp"
+
+struct RomFile
+{
+    u16 addr;
+    std::vector<u8> data;
+};
+
+struct CpuBackend
+{
+    const char* name;
+    std::unique_ptr<CpuImpl> (*create)(const std::shared_ptr<Bus>& bus);
+};
+
+// Command line handling shared by tools
+class ToolSupport
+{
+    public:
+        // 2 MHz cpu, 60 frames per second. RST 1 is requested in the middle of frame, RST 2 at vertical blank.
+        static constexpr u32 CYCLES_PER_HALF_FRAME = 2000000 / 60 / 2;
+
+        // decoder, table, threaded, block, tiered and jit, in this order
+        static const std::vector<CpuBackend>& getBackends();
+
+        // nullptr when there is no backend of given name
+        static const CpuBackend* findBackend(const std::string& name);
+
+        // "decoder|table|threaded|block|tiered|jit", for usage messages
+        static std::string getBackendNames();
+
+        // Decimal, or hexadecimal with 0x prefix. Whole text has to be the number.
+        static bool parseNumber(const std::string& text, unsigned& value);
+
+        static bool parseAddress(const std::string& text, u16& addr);
+
+        // Reads file given as "<address>:<file>" argument, error tells what went wrong
+        static bool loadRomFile(const std::string& argument, RomFile& rom, std::string& error);
+
+        // Places ROM files into single image starting at the lowest of their addresses,
+        // gaps between them are zero filled. Fails when they do not fit into address space.
+        static bool buildImage(const std::vector<RomFile>& roms, u16& origin, std::vector<u8>& image);
+};
@@ -3,4 +3,13 @@
 #include <cstdint>
 
 using u8 = std::uint_least8_t;
-using u16 = std::uint_least16_t;
\ No newline at end of file
+using u16 = std::uint_least16_t;
+using u32 = std::uint_least32_t;
+using u64 = std::uint_least64_t;
+
+// Byte order of the host, in which register pairs are stored
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+#define HOST_BIG_ENDIAN 1
+#else
+#define HOST_BIG_ENDIAN 0
+#endif
@@ -0,0 +1,383 @@
+#include "X64Emitter.hpp"
+
+X64Emitter::X64Emitter(u8* buffer, std::size_t capacity)
+    : buffer(buffer)
+    , capacity(capacity)
+    , position(0)
+    , overflowed(false)
+{
+}
+
+std::size_t X64Emitter::getPosition() const
+{
+    return position;
+}
+
+u8* X64Emitter::getCurrentAddress() const
+{
+    return buffer + position;
+}
+
+bool X64Emitter::hasOverflowed() const
+{
+    return overflowed;
+}
+
+void X64Emitter::movImm32(X64Register dst, u32 immedate)
+{
+    emitRex(false, 0, 0, code(dst), false);
+    emitByte(0xB8 + (code(dst) & 7));
+    emitDword(immedate);
+}
+
+void X64Emitter::movImm64(X64Register dst, u64 immedate)
+{
+    emitRex(true, 0, 0, code(dst), false);
+    emitByte(0xB8 + (code(dst) & 7));
+    emitQword(immedate);
+}
+
+void X64Emitter::mov32(X64Register dst, X64Register src)
+{
+    emitRex(false, code(src), 0, code(dst), false);
+    emitByte(0x89);
+    emitModRm(3, code(src), code(dst));
+}
+
+void X64Emitter::mov64(X64Register dst, X64Register src)
+{
+    emitRex(true, code(src), 0, code(dst), false);
+    emitByte(0x89);
+    emitModRm(3, code(src), code(dst));
+}
+
+void X64Emitter::mov8(X64Register dst, X64Register src)
+{
+    emitRex(false, code(src), 0, code(dst), needsRexForByte(src) || needsRexForByte(dst));
+    emitByte(0x88);
+    emitModRm(3, code(src), code(dst));
+}
+
+void X64Emitter::alu32(X64AluOperation operation, X64Register dst, X64Register src)
+{
+    emitRex(false, code(src), 0, code(dst), false);
+    emitByte((static_cast<unsigned>(operation) << 3) | 0x01);
+    emitModRm(3, code(src), code(dst));
+}
+
+void X64Emitter::alu32Imm(X64AluOperation operation, X64Register dst, u32 immedate)
+{
+    emitRex(false, 0, 0, code(dst), false);
+    emitByte(0x81);
+    emitModRm(3, static_cast<unsigned>(operation), code(dst));
+    emitDword(immedate);
+}
+
+void X64Emitter::alu64Imm(X64AluOperation operation, X64Register dst, u32 immedate)
+{
+    emitRex(true, 0, 0, code(dst), false);
+    emitByte(0x81);
+    emitModRm(3, static_cast<unsigned>(operation), code(dst));
+    emitDword(immedate);
+}
+
+void X64Emitter::shift32Imm(X64ShiftOperation operation, X64Register dst, u8 count)
+{
+    emitRex(false, 0, 0, code(dst), false);
+    emitByte(0xC1);
+    emitModRm(3, static_cast<unsigned>(operation), code(dst));
+    emitByte(count);
+}
+
+void X64Emitter::test32Imm(X64Register reg, u32 immedate)
+{
+    emitRex(false, 0, 0, code(reg), false);
+    emitByte(0xF7);
+    emitModRm(3, 0, code(reg));
+    emitDword(immedate);
+}
+
+void X64Emitter::test64(X64Register first, X64Register second)
+{
+    emitRex(true, code(second), 0, code(first), false);
+    emitByte(0x85);
+    emitModRm(3, code(second), code(first));
+}
+
+void X64Emitter::movzx8(X64Register dst, X64Register src)
+{
+    emitRex(false, code(dst), 0, code(src), needsRexForByte(src));
+    emitByte(0x0F);
+    emitByte(0xB6);
+    emitModRm(3, code(dst), code(src));
+}
+
+void X64Emitter::movzx8Load(X64Register dst, X64Register base, u32 disp)
+{
+    emitRex(false, code(dst), 0, code(base), false);
+    emitByte(0x0F);
+    emitByte(0xB6);
+    emitMemoryOperand(code(dst), base, disp);
+}
+
+void X64Emitter::movzx16Load(X64Register dst, X64Register base, u32 disp)
+{
+    emitRex(false, code(dst), 0, code(base), false);
+    emitByte(0x0F);
+    emitByte(0xB7);
+    emitMemoryOperand(code(dst), base, disp);
+}
+
+void X64Emitter::movzx16LoadIndexed(X64Register dst, X64Register base, X64Register index)
+{
+    emitRex(false, code(dst), code(index), code(base), false);
+    emitByte(0x0F);
+    emitByte(0xB7);
+    emitIndexedOperand(code(dst), base, index, 1);
+}
+
+void X64Emitter::load64Indexed(X64Register dst, X64Register base, X64Register index)
+{
+    emitRex(true, code(dst), code(index), code(base), false);
+    emitByte(0x8B);
+    emitIndexedOperand(code(dst), base, index, 3);
+}
+
+void X64Emitter::load64(X64Register dst, X64Register base, u32 disp)
+{
+    emitRex(true, code(dst), 0, code(base), false);
+    emitByte(0x8B);
+    emitMemoryOperand(code(dst), base, disp);
+}
+
+void X64Emitter::add64Load(X64Register dst, X64Register base, u32 disp)
+{
+    emitRex(true, code(dst), 0, code(base), false);
+    emitByte(0x03);
+    emitMemoryOperand(code(dst), base, disp);
+}
+
+void X64Emitter::cmp64Load(X64Register dst, X64Register base, u32 disp)
+{
+    emitRex(true, code(dst), 0, code(base), false);
+    emitByte(0x3B);
+    emitMemoryOperand(code(dst), base, disp);
+}
+
+void X64Emitter::add64StoreImm(X64Register base, u32 disp, u32 immedate)
+{
+    emitRex(true, 0, 0, code(base), false);
+    emitByte(0x81);
+    emitMemoryOperand(0, base, disp);
+    emitDword(immedate);
+}
+
+void X64Emitter::store8(X64Register base, u32 disp, X64Register src)
+{
+    emitRex(false, code(src), 0, code(base), needsRexForByte(src));
+    emitByte(0x88);
+    emitMemoryOperand(code(src), base, disp);
+}
+
+void X64Emitter::store16(X64Register base, u32 disp, X64Register src)
+{
+    emitByte(0x66);
+    emitRex(false, code(src), 0, code(base), false);
+    emitByte(0x89);
+    emitMemoryOperand(code(src), base, disp);
+}
+
+void X64Emitter::store16Imm(X64Register base, u32 disp, u16 immedate)
+{
+    emitByte(0x66);
+    emitRex(false, 0, 0, code(base), false);
+    emitByte(0xC7);
+    emitMemoryOperand(0, base, disp);
+    emitWord(immedate);
+}
+
+void X64Emitter::inc16(X64Register reg)
+{
+    emitByte(0x66);
+    emitRex(false, 0, 0, code(reg), false);
+    emitByte(0xFF);
+    emitModRm(3, 0, code(reg));
+}
+
+void X64Emitter::dec16(X64Register reg)
+{
+    emitByte(0x66);
+    emitRex(false, 0, 0, code(reg), false);
+    emitByte(0xFF);
+    emitModRm(3, 1, code(reg));
+}
+
+void X64Emitter::inc16Store(X64Register base, u32 disp)
+{
+    emitByte(0x66);
+    emitRex(false, 0, 0, code(base), false);
+    emitByte(0xFF);
+    emitMemoryOperand(0, base, disp);
+}
+
+void X64Emitter::dec16Store(X64Register base, u32 disp)
+{
+    emitByte(0x66);
+    emitRex(false, 0, 0, code(base), false);
+    emitByte(0xFF);
+    emitMemoryOperand(1, base, disp);
+}
+
+void X64Emitter::push(X64Register reg)
+{
+    emitRex(false, 0, 0, code(reg), false);
+    emitByte(0x50 + (code(reg) & 7));
+}
+
+void X64Emitter::pop(X64Register reg)
+{
+    emitRex(false, 0, 0, code(reg), false);
+    emitByte(0x58 + (code(reg) & 7));
+}
+
+void X64Emitter::ret()
+{
+    emitByte(0xC3);
+}
+
+void X64Emitter::call(X64Register target)
+{
+    emitRex(false, 0, 0, code(target), false);
+    emitByte(0xFF);
+    emitModRm(3, 2, code(target));
+}
+
+void X64Emitter::jmp(X64Register target)
+{
+    emitRex(false, 0, 0, code(target), false);
+    emitByte(0xFF);
+    emitModRm(3, 4, code(target));
+}
+
+void X64Emitter::jmpLoad(X64Register base, u32 disp)
+{
+    emitRex(false, 0, 0, code(base), false);
+    emitByte(0xFF);
+    emitMemoryOperand(4, base, disp);
+}
+
+void X64Emitter::jmp(const u8* target)
+{
+    emitByte(0xE9);
+    const auto next = reinterpret_cast<std::ptrdiff_t>(buffer + position + 4);
+    emitDword(static_cast<u32>(reinterpret_cast<std::ptrdiff_t>(target) - next));
+}
+
+void X64Emitter::jcc(X64Condition condition, const u8* target)
+{
+    emitByte(0x0F);
+    emitByte(0x80 | static_cast<unsigned>(condition));
+    const auto next = reinterpret_cast<std::ptrdiff_t>(buffer + position + 4);
+    emitDword(static_cast<u32>(reinterpret_cast<std::ptrdiff_t>(target) - next));
+}
+
+std::size_t X64Emitter::jmpForward()
+{
+    emitByte(0xE9);
+    const auto displacementPosition = position;
+    emitDword(0);
+    return displacementPosition;
+}
+
+std::size_t X64Emitter::jccForward(X64Condition condition)
+{
+    emitByte(0x0F);
+    emitByte(0x80 | static_cast<unsigned>(condition));
+    const auto displacementPosition = position;
+    emitDword(0);
+    return displacementPosition;
+}
+
+void X64Emitter::bind(std::size_t displacementPosition)
+{
+    if (overflowed)
+    {
+        return;
+    }
+
+    const u32 displacement = static_cast<u32>(position - (displacementPosition + 4));
+    for (unsigned i = 0; i < 4; i++)
+    {
+        buffer[displacementPosition + i] = (displacement >> (i * 8)) & 0xFF;
+    }
+}
+
+void X64Emitter::emitByte(u8 value)
+{
+    if (position >= capacity)
+    {
+        overflowed = true;
+        return;
+    }
+    buffer[position++] = value;
+}
+
+void X64Emitter::emitWord(u16 value)
+{
+    emitByte(value & 0xFF);
+    emitByte(value >> 8);
+}
+
+void X64Emitter::emitDword(u32 value)
+{
+    emitWord(value & 0xFFFF);
+    emitWord(value >> 16);
+}
+
+void X64Emitter::emitQword(u64 value)
+{
+    emitDword(value & 0xFFFFFFFF);
+    emitDword(value >> 32);
+}
+
+void X64Emitter::emitRex(bool wide, unsigned reg, unsigned index, unsigned base, bool force)
+{
+    const u8 rex = (wide ? 0x8 : 0) | ((reg >> 3) << 2) | ((index >> 3) << 1) | (base >> 3);
+    if (rex != 0 || force)
+    {
+        emitByte(0x40 | rex);
+    }
+}
+
+void X64Emitter::emitModRm(unsigned mod, unsigned reg, unsigned rm)
+{
+    emitByte((mod << 6) | ((reg & 7) << 3) | (rm & 7));
+}
+
+void X64Emitter::emitMemoryOperand(unsigned reg, X64Register base, u32 disp)
+{
+    // RSP and R12 as base can only be encoded with SIB byte
+    emitModRm(2, reg, code(base));
+    if ((code(base) & 7) == 4)
+    {
+        emitByte(0x24);
+    }
+    emitDword(disp);
+}
+
+void X64Emitter::emitIndexedOperand(unsigned reg, X64Register base, X64Register index, unsigned scaleLog)
+{
+    // RBP and R13 as base would require displacement, they are not used here
+    emitModRm(0, reg, 4);
+    emitByte((scaleLog << 6) | ((code(index) & 7) << 3) | (code(base) & 7));
+}
+
+unsigned X64Emitter::code(X64Register reg)
+{
+    return static_cast<unsigned>(reg);
+}
+
+bool X64Emitter::needsRexForByte(X64Register reg)
+{
+    return reg >= X64Register::RSP && reg <= X64Register::RDI;
+}
@@ -0,0 +1,164 @@
+#pragma once
+
+#include <cstddef>
+
+#include "Types.hpp"
+
+enum class X64Register
+{
+    RAX = 0,
+    RCX = 1,
+    RDX = 2,
+    RBX = 3,
+    RSP = 4,
+    RBP = 5,
+    RSI = 6,
+    RDI = 7,
+    R8 = 8,
+    R9 = 9,
+    R10 = 10,
+    R11 = 11,
+    R12 = 12,
+    R13 = 13,
+    R14 = 14,
+    R15 = 15
+};
+
+// Condition codes of Jcc instruction
+enum class X64Condition
+{
+    ZERO = 0x4,
+    NOT_ZERO = 0x5,
+    BELOW_OR_EQUAL = 0x6,
+    ABOVE = 0x7
+};
+
+enum class X64AluOperation
+{
+    ADD = 0,
+    OR = 1,
+    AND = 4,
+    SUB = 5,
+    XOR = 6,
+    CMP = 7
+};
+
+enum class X64ShiftOperation
+{
+    ROL = 0,
+    ROR = 1,
+    SHL = 4,
+    SHR = 5
+};
+
+// Writes x86-64 machine code into given buffer. Provides only instructions
+// needed by JitCpuImpl. Memory operands are [base + disp32] unless stated otherwise.
+// Emitting past the end of buffer does not write anything and sets overflow flag.
+class X64Emitter
+{
+    public:
+        X64Emitter(u8* buffer, std::size_t capacity);
+
+        ~X64Emitter() = default;
+
+        std::size_t getPosition() const;
+
+        u8* getCurrentAddress() const;
+
+        bool hasOverflowed() const;
+
+        // mov r32, imm32 (clears upper half of register)
+        void movImm32(X64Register dst, u32 immedate);
+        // mov r64, imm64
+        void movImm64(X64Register dst, u64 immedate);
+        // mov r32, r32
+        void mov32(X64Register dst, X64Register src);
+        // mov r64, r64
+        void mov64(X64Register dst, X64Register src);
+        // mov r8, r8 (low bytes of both registers)
+        void mov8(X64Register dst, X64Register src);
+        // op r32, r32
+        void alu32(X64AluOperation operation, X64Register dst, X64Register src);
+        // op r32, imm32
+        void alu32Imm(X64AluOperation operation, X64Register dst, u32 immedate);
+        // op r64, imm32 (sign extended)
+        void alu64Imm(X64AluOperation operation, X64Register dst, u32 immedate);
+        // op r32, imm8
+        void shift32Imm(X64ShiftOperation operation, X64Register dst, u8 count);
+        // test r32, imm32
+        void test32Imm(X64Register reg, u32 immedate);
+        // test r64, r64
+        void test64(X64Register first, X64Register second);
+        // movzx r32, r8
+        void movzx8(X64Register dst, X64Register src);
+        // movzx r32, byte [base + disp]
+        void movzx8Load(X64Register dst, X64Register base, u32 disp);
+        // movzx r32, word [base + disp]
+        void movzx16Load(X64Register dst, X64Register base, u32 disp);
+        // movzx r32, word [base + index * 2]
+        void movzx16LoadIndexed(X64Register dst, X64Register base, X64Register index);
+        // mov r64, [base + index * 8]
+        void load64Indexed(X64Register dst, X64Register base, X64Register index);
+        // mov r64, [base + disp]
+        void load64(X64Register dst, X64Register base, u32 disp);
+        // add r64, [base + disp]
+        void add64Load(X64Register dst, X64Register base, u32 disp);
+        // cmp r64, [base + disp]
+        void cmp64Load(X64Register dst, X64Register base, u32 disp);
+        // add qword [base + disp], imm32
+        void add64StoreImm(X64Register base, u32 disp, u32 immedate);
+        // mov byte [base + disp], r8
+        void store8(X64Register base, u32 disp, X64Register src);
+        // mov word [base + disp], r16
+        void store16(X64Register base, u32 disp, X64Register src);
+        // mov word [base + disp], imm16
+        void store16Imm(X64Register base, u32 disp, u16 immedate);
+        // inc r16 / dec r16
+        void inc16(X64Register reg);
+        void dec16(X64Register reg);
+        // inc word [base + disp] / dec word [base + disp]
+        void inc16Store(X64Register base, u32 disp);
+        void dec16Store(X64Register base, u32 disp);
+        void push(X64Register reg);
+        void pop(X64Register reg);
+        void ret();
+        // call r64
+        void call(X64Register target);
+        // jmp r64
+        void jmp(X64Register target);
+        // jmp qword [base + disp]
+        void jmpLoad(X64Register base, u32 disp);
+        // jmp rel32 / jcc rel32 to given address
+        void jmp(const u8* target);
+        void jcc(X64Condition condition, const u8* target);
+
+        // Jumps with rel32 displacement to be filled by bind().
+        // Return position of displacement.
+        std::size_t jmpForward();
+        std::size_t jccForward(X64Condition condition);
+
+        // Points forward jump at current position
+        void bind(std::size_t displacementPosition);
+
+    private:
+        void emitByte(u8 value);
+        void emitWord(u16 value);
+        void emitDword(u32 value);
+        void emitQword(u64 value);
+        // REX prefix, emitted when any extension bit is set or when forced
+        // (8 bit access to SPL, BPL, SIL and DIL)
+        void emitRex(bool wide, unsigned reg, unsigned index, unsigned base, bool force);
+        void emitModRm(unsigned mod, unsigned reg, unsigned rm);
+        // ModRM (and SIB if needed) of [base + disp32]
+        void emitMemoryOperand(unsigned reg, X64Register base, u32 disp);
+        // ModRM and SIB of [base + index * scale]
+        void emitIndexedOperand(unsigned reg, X64Register base, X64Register index, unsigned scaleLog);
+
+        static unsigned code(X64Register reg);
+        static bool needsRexForByte(X64Register reg);
+
+        u8* buffer;
+        std::size_t capacity;
+        std::size_t position;
+        bool overflowed;
+};
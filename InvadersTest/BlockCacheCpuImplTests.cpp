@@ -0,0 +1,303 @@
+#include <sstream>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "mocks/MemoryBusTest.hpp"
+
+#include "..//Invaders/BlockCacheCpuImpl.hpp"
+#include "..//Invaders/BusImpl.hpp"
+#include "..//Invaders/CpuImpl.hpp"
+
+class BlockCacheCpuImplTests : public MemoryBusTest
+{
+    protected:
+        void SetUp() override
+        {
+            MemoryBusTest::SetUp();
+            testedCpu = std::make_unique<BlockCacheCpuImpl>(bus);
+
+            testedCpu->getRegisters().getSp() = 0x2400;
+        }
+
+        std::unique_ptr<BlockCacheCpuImpl> testedCpu;
+};
+
+TEST_F(BlockCacheCpuImplTests, testLoopIsDecodedOnce)
+{
+    // MVI B,10; loop: DCR B; JNZ loop; HLT
+    loadProgram(0x0000, { 0x06, 0x10, 0x05, 0xC2, 0x02, 0x00, 0x76 });
+
+    testedCpu->run(1000);
+
+    const auto& stats = testedCpu->getBlockCacheStats();
+    EXPECT_TRUE(testedCpu->isHalted());
+    EXPECT_EQ(0x0007, testedCpu->getRegisters().getPc());
+    EXPECT_EQ(3, stats.misses);
+    EXPECT_EQ(14, stats.hits);
+    EXPECT_EQ(0, stats.invalidations);
+    EXPECT_EQ(3, testedCpu->getCachedBlockCount());
+}
+
+TEST_F(BlockCacheCpuImplTests, testRunMatchesInterpreter)
+{
+    // LXI H,2000; MVI B,20; loop: MOV A,B; ADD M; MOV M,A; INX H; PUSH PSW; XRA A; POP PSW; DCR B; JNZ loop; JMP 0000
+    loadProgram(0x0000, { 0x21, 0x00, 0x20, 0x06, 0x20, 0x78, 0x86, 0x77, 0x23, 0xF5, 0xAF, 0xF1, 0x05, 0xC2, 0x05, 0x00, 0xC3, 0x00, 0x00 });
+
+    std::array<u8, 0x10000> interpreterMemory = memory;
+    auto interpreterBus = makeMemoryBus(interpreterMemory);
+    CpuImpl interpreterCpu(interpreterBus);
+    interpreterCpu.getRegisters().getSp() = 0x2400;
+
+    for (auto budget : { 1000u, 33333u, 7u, 16666u })
+    {
+        EXPECT_EQ(interpreterCpu.run(budget), testedCpu->run(budget));
+        EXPECT_EQ(interpreterCpu.getCycles(), testedCpu->getCycles());
+        EXPECT_EQ(interpreterCpu.getRegisters().getPc(), testedCpu->getRegisters().getPc());
+        EXPECT_EQ(interpreterCpu.getRegisters().getAf().getRaw(), testedCpu->getRegisters().getAf().getRaw());
+        EXPECT_EQ(interpreterCpu.getRegisters().getHl().getRaw(), testedCpu->getRegisters().getHl().getRaw());
+    }
+    EXPECT_EQ(interpreterMemory, memory);
+    EXPECT_GT(testedCpu->getBlockCacheStats().hits, 0);
+}
+
+TEST_F(BlockCacheCpuImplTests, testWriteIntoExecutedBlockTakesEffect)
+{
+    // 2000: LXI H,2007; MVI M,3C; MVI A,00; (replaced by INR A) HLT
+    loadProgram(0x2000, { 0x21, 0x07, 0x20, 0x36, 0x3C, 0x3E, 0x00, 0x00, 0x76 });
+    testedCpu->getRegisters().getPc() = 0x2000;
+
+    testedCpu->run(100);
+
+    EXPECT_TRUE(testedCpu->isHalted());
+    EXPECT_EQ(0x01, testedCpu->getRegisters().getAf().getHigh());
+    EXPECT_EQ(1, testedCpu->getBlockCacheStats().invalidations);
+}
+
+TEST_F(BlockCacheCpuImplTests, testWriteIntoCachedBlockInvalidatesIt)
+{
+    // 0000: JMP 2000
+    // 0003: INR A; STA 2001; MVI B,FF; JMP 2000
+    // 2000: MVI A,01; INR B; JNZ 0003; HLT
+    loadProgram(0x0000, { 0xC3, 0x00, 0x20, 0x3C, 0x32, 0x01, 0x20, 0x06, 0xFF, 0xC3, 0x00, 0x20 });
+    loadProgram(0x2000, { 0x3E, 0x01, 0x04, 0xC2, 0x03, 0x00, 0x76 });
+
+    testedCpu->run(200);
+
+    // First pass sets A to 1, INR A makes it 2 and it is stored as new immedate
+    EXPECT_TRUE(testedCpu->isHalted());
+    EXPECT_EQ(0x02, testedCpu->getRegisters().getAf().getHigh());
+    EXPECT_EQ(1, testedCpu->getBlockCacheStats().invalidations);
+    EXPECT_EQ(4, testedCpu->getCachedBlockCount());
+}
+
+TEST_F(BlockCacheCpuImplTests, testWriteThroughMirrorInvalidatesBlock)
+{
+    // 0000: JMP 6000
+    // 0003: INR A; STA 2001; MVI B,FF; JMP 6000
+    // 2000: MVI A,01; INR B; JNZ 0003; HLT
+    // Block is decoded at mirror 6000 of RAM written at 2001
+    auto bus = std::make_shared<BusImpl>();
+    bus->loadIntoMemory(0x0000, { 0xC3, 0x00, 0x60, 0x3C, 0x32, 0x01, 0x20, 0x06, 0xFF, 0xC3, 0x00, 0x60 });
+    bus->loadIntoMemory(0x2000, { 0x3E, 0x01, 0x04, 0xC2, 0x03, 0x00, 0x76 });
+    BlockCacheCpuImpl cpu(bus);
+
+    cpu.run(200);
+
+    EXPECT_TRUE(cpu.isHalted());
+    EXPECT_EQ(0x02, cpu.getRegisters().getAf().getHigh());
+    EXPECT_EQ(1, cpu.getBlockCacheStats().invalidations);
+
+    cpu.invalidateBlocks(0xA004, 1);
+    EXPECT_EQ(2, cpu.getBlockCacheStats().invalidations);
+}
+
+TEST_F(BlockCacheCpuImplTests, testStackWritesInvalidateBlocks)
+{
+    // 0000: JMP 2000
+    // 0003: LXI SP,2002; LXI B,053E; PUSH B; MVI B,FF; JMP 2000
+    // 2000: MVI A,01; INR B; JNZ 0003; HLT
+    // PUSH replaces MVI A,01 with MVI A,05
+    loadProgram(0x0000, { 0xC3, 0x00, 0x20, 0x31, 0x02, 0x20, 0x01, 0x3E, 0x05, 0xC5, 0x06, 0xFF, 0xC3, 0x00, 0x20 });
+    loadProgram(0x2000, { 0x3E, 0x01, 0x04, 0xC2, 0x03, 0x00, 0x76 });
+
+    testedCpu->run(200);
+
+    EXPECT_TRUE(testedCpu->isHalted());
+    EXPECT_EQ(0x05, testedCpu->getRegisters().getAf().getHigh());
+    EXPECT_EQ(1, testedCpu->getBlockCacheStats().invalidations);
+    EXPECT_EQ(4, testedCpu->getCachedBlockCount());
+}
+
+TEST_F(BlockCacheCpuImplTests, testInvalidateBlocksDropsOverlappingBlocks)
+{
+    // NOP; NOP; JMP 0000
+    loadProgram(0x0000, { 0x00, 0x00, 0xC3, 0x00, 0x00 });
+
+    testedCpu->run(100);
+    EXPECT_EQ(1, testedCpu->getCachedBlockCount());
+
+    testedCpu->invalidateBlocks(0x0010, 0x10);
+    EXPECT_EQ(1, testedCpu->getCachedBlockCount());
+
+    testedCpu->invalidateBlocks(0x0004, 1);
+    EXPECT_EQ(0, testedCpu->getCachedBlockCount());
+    EXPECT_EQ(1, testedCpu->getBlockCacheStats().invalidations);
+
+    testedCpu->resetBlockCacheStats();
+    testedCpu->run(100);
+    EXPECT_EQ(1, testedCpu->getBlockCacheStats().misses);
+}
+
+TEST_F(BlockCacheCpuImplTests, testFusedSequencesMatchInterpreter)
+{
+    // 0000: LXI H,3000; LXI D,2000; MVI B,10
+    // 0008: LDAX D; MOV M,A; INX H; INX D; DCR B; JNZ 0008
+    // 0010: MVI C,08
+    // 0012: INX H; DCR C; JNZ 0012
+    // 0017: MOV A,M; ANI 01; JZ 0000; INR A; HLT
+    loadProgram(0x0000, { 0x21, 0x00, 0x30, 0x11, 0x00, 0x20, 0x06, 0x10, 0x1A, 0x77, 0x23, 0x13, 0x05, 0xC2, 0x08, 0x00,
+                          0x0E, 0x08, 0x23, 0x0D, 0xC2, 0x12, 0x00, 0x7E, 0xE6, 0x01, 0xCA, 0x00, 0x00, 0x3C, 0x76 });
+    for (unsigned i = 0; i < 0x10; i++)
+        memory[0x2000 + i] = static_cast<u8>(i * 3 + 1);
+
+    std::array<u8, 0x10000> interpreterMemory = memory;
+    auto interpreterBus = makeMemoryBus(interpreterMemory);
+    CpuImpl interpreterCpu(interpreterBus);
+    interpreterCpu.getRegisters().getSp() = 0x2400;
+
+    // Odd budgets end batches in the middle of fused sequences
+    for (auto budget : { 1000u, 7u, 23u, 33333u, 1u, 16666u })
+    {
+        EXPECT_EQ(interpreterCpu.run(budget), testedCpu->run(budget));
+        EXPECT_EQ(interpreterCpu.getCycles(), testedCpu->getCycles());
+        EXPECT_EQ(interpreterCpu.getRegisters().getPc(), testedCpu->getRegisters().getPc());
+        EXPECT_EQ(interpreterCpu.getRegisters().getAf().getRaw(), testedCpu->getRegisters().getAf().getRaw());
+        EXPECT_EQ(interpreterCpu.getRegisters().getBc().getRaw(), testedCpu->getRegisters().getBc().getRaw());
+        EXPECT_EQ(interpreterCpu.getRegisters().getDe().getRaw(), testedCpu->getRegisters().getDe().getRaw());
+        EXPECT_EQ(interpreterCpu.getRegisters().getHl().getRaw(), testedCpu->getRegisters().getHl().getRaw());
+    }
+    EXPECT_EQ(interpreterMemory, memory);
+
+    const auto& fused = testedCpu->getBlockCacheStats().fusedSequences;
+    EXPECT_GT(fused[static_cast<std::size_t>(FusedSequence::DECREMENT_JUMP)], 0);
+    EXPECT_GT(fused[static_cast<std::size_t>(FusedSequence::INCREMENT_DECREMENT_JUMP)], 0);
+    EXPECT_GT(fused[static_cast<std::size_t>(FusedSequence::COPY_BYTE)], 0);
+    EXPECT_GT(fused[static_cast<std::size_t>(FusedSequence::TEST_MEMORY_JUMP)], 0);
+}
+
+TEST_F(BlockCacheCpuImplTests, testFusedCopyIntoCodeIsExecutedUnfused)
+{
+    // 0000: JMP 0020
+    // 0003: LXI H,0020; LXI D,2000; MVI B,03
+    // 000B: LDAX D; MOV M,A; INX H; INX D; DCR B; JNZ 000B; JMP 0020
+    // 0020: MVI A,11; JMP 0003     (replaced by MVI A,55; HLT)
+    loadProgram(0x0000, { 0xC3, 0x20, 0x00, 0x21, 0x20, 0x00, 0x11, 0x00, 0x20, 0x06, 0x03,
+                          0x1A, 0x77, 0x23, 0x13, 0x05, 0xC2, 0x0B, 0x00, 0xC3, 0x20, 0x00 });
+    loadProgram(0x0020, { 0x3E, 0x11, 0xC3, 0x03, 0x00 });
+    loadProgram(0x2000, { 0x3E, 0x55, 0x76 });
+
+    testedCpu->run(1000);
+
+    const auto& stats = testedCpu->getBlockCacheStats();
+    EXPECT_TRUE(testedCpu->isHalted());
+    EXPECT_EQ(0x55, testedCpu->getRegisters().getAf().getHigh());
+    EXPECT_EQ(0, stats.fusedSequences[static_cast<std::size_t>(FusedSequence::COPY_BYTE)]);
+    EXPECT_GT(stats.invalidations, 0);
+}
+
+TEST_F(BlockCacheCpuImplTests, testFusionCanBeDisabled)
+{
+    // MVI B,10; loop: DCR B; JNZ loop; HLT
+    loadProgram(0x0000, { 0x06, 0x10, 0x05, 0xC2, 0x02, 0x00, 0x76 });
+    testedCpu->setFusionEnabled(false);
+
+    testedCpu->run(1000);
+
+    EXPECT_FALSE(testedCpu->isFusionEnabled());
+    EXPECT_TRUE(testedCpu->isHalted());
+    EXPECT_EQ(0x00, testedCpu->getRegisters().getBc().getHigh());
+    EXPECT_EQ(0, testedCpu->getBlockCacheStats().fusedSequences[static_cast<std::size_t>(FusedSequence::DECREMENT_JUMP)]);
+}
+
+TEST_F(BlockCacheCpuImplTests, testSequenceProfile)
+{
+    // MVI B,10; loop: DCR B; JNZ loop; HLT
+    loadProgram(0x0000, { 0x06, 0x10, 0x05, 0xC2, 0x02, 0x00, 0x76 });
+
+    testedCpu->run(1000);
+
+    const auto profile = testedCpu->getSequenceProfile(2);
+    // First block runs MVI B; DCR B; JNZ once, second DCR B; JNZ 15 times
+    ASSERT_EQ(2, profile.size());
+    EXPECT_EQ(std::vector<u8>({ 0x05, 0xC2 }), profile[0].opcodes);
+    EXPECT_EQ(16, profile[0].executions);
+    EXPECT_EQ(std::vector<u8>({ 0x06, 0x05 }), profile[1].opcodes);
+    EXPECT_EQ(1, profile[1].executions);
+
+    std::ostringstream report;
+    testedCpu->writeSequenceReport(report, 10);
+    EXPECT_NE(std::string::npos, report.str().find("DCR B; JNZ  (fused)"));
+}
+
+TEST_F(BlockCacheCpuImplTests, testPollingLoopIsFastForwarded)
+{
+    // 0000: LXI H,2000
+    // 0003: MOV A,M; ORA A; JZ 0003; HLT
+    loadProgram(0x0000, { 0x21, 0x00, 0x20, 0x7E, 0xB7, 0xCA, 0x03, 0x00, 0x76 });
+
+    auto interpreterBus = makeMemoryBus(memory);
+    CpuImpl interpreterCpu(interpreterBus);
+    interpreterCpu.getRegisters().getSp() = 0x2400;
+
+    for (auto budget : { 33333u, 7u, 1000u, 16666u })
+    {
+        EXPECT_EQ(interpreterCpu.run(budget), testedCpu->run(budget));
+        EXPECT_EQ(interpreterCpu.getCycles(), testedCpu->getCycles());
+        EXPECT_EQ(interpreterCpu.getRegisters().getPc(), testedCpu->getRegisters().getPc());
+        EXPECT_EQ(interpreterCpu.getRegisters().getAf().getRaw(), testedCpu->getRegisters().getAf().getRaw());
+    }
+
+    const auto& idleStats = testedCpu->getIdleStats();
+    EXPECT_GT(idleStats.idleLoops, 0);
+    EXPECT_GT(idleStats.idleLoopCycles, 40000);
+    EXPECT_LT(testedCpu->getBlockCacheStats().hits, 100);
+
+    // Interrupt handler would change the flag
+    memory[0x2000] = 0x01;
+    testedCpu->run(1000);
+    EXPECT_TRUE(testedCpu->isHalted());
+}
+
+TEST_F(BlockCacheCpuImplTests, testLoopChangingRegistersIsNotIdle)
+{
+    // loop: INR A; JMP loop
+    loadProgram(0x0000, { 0x3C, 0xC3, 0x00, 0x00 });
+
+    testedCpu->run(10000);
+
+    EXPECT_EQ(0, testedCpu->getIdleStats().idleLoops);
+}
+
+TEST_F(BlockCacheCpuImplTests, testLoopWritingMemoryIsNotIdle)
+{
+    // loop: STA 2000; JMP loop
+    loadProgram(0x0000, { 0x32, 0x00, 0x20, 0xC3, 0x00, 0x00 });
+
+    testedCpu->run(10000);
+
+    EXPECT_EQ(0, testedCpu->getIdleStats().idleLoops);
+}
+
+TEST_F(BlockCacheCpuImplTests, testIdleLoopDetectionCanBeDisabled)
+{
+    // loop: NOP; JMP loop
+    loadProgram(0x0000, { 0x00, 0xC3, 0x00, 0x00 });
+    testedCpu->setIdleLoopDetectionEnabled(false);
+
+    testedCpu->run(10000);
+
+    EXPECT_FALSE(testedCpu->isIdleLoopDetectionEnabled());
+    EXPECT_EQ(0, testedCpu->getIdleStats().idleLoops);
+    EXPECT_EQ(10000 / 14 + 1, testedCpu->getBlockCacheStats().hits + testedCpu->getBlockCacheStats().misses);
+}
@@ -0,0 +1,95 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "..//Invaders/BusImpl.hpp"
+#include "..//Invaders/CpuImpl.hpp"
+
+class BusImplTests : public testing::Test
+{
+    protected:
+        void SetUp() override
+        {
+            bus = std::make_shared<BusImpl>();
+        }
+
+        std::shared_ptr<BusImpl> bus;
+};
+
+TEST_F(BusImplTests, testRomIsWriteProtected)
+{
+    bus->loadIntoMemory(0x1000, { 0x12, 0x34 });
+
+    bus->writeIntoMemory(0x1000, 0xFF);
+    bus->getMemoryLocationRef(0x1001) = 0xFF;
+
+    EXPECT_EQ(0x12, bus->readFromMemory(0x1000));
+    EXPECT_EQ(0x34, bus->readFromMemory(0x1001));
+}
+
+TEST_F(BusImplTests, testRamIsWritable)
+{
+    bus->writeIntoMemory(0x2000, 0x12);
+    bus->getMemoryLocationRef(0x3FFF) = 0x34;
+
+    EXPECT_EQ(0x12, bus->readFromMemory(0x2000));
+    EXPECT_EQ(0x34, bus->readFromMemory(0x3FFF));
+}
+
+TEST_F(BusImplTests, testMemoryIsMirroredAbove16K)
+{
+    bus->writeIntoMemory(0x6010, 0x56);
+
+    EXPECT_EQ(0x56, bus->readFromMemory(0x2010));
+    EXPECT_EQ(0x56, bus->readFromMemory(0xE010));
+}
+
+TEST_F(BusImplTests, testWordAccessIsLittleEndian)
+{
+    bus->writeWordIntoMemory(0x2000, 0x1234);
+
+    EXPECT_EQ(0x34, bus->readFromMemory(0x2000));
+    EXPECT_EQ(0x12, bus->readFromMemory(0x2001));
+    EXPECT_EQ(0x1234, bus->readWordFromMemory(0x2000));
+}
+
+TEST_F(BusImplTests, testWordAccessWrapsAroundAddressSpace)
+{
+    bus->loadIntoMemory(0x0000, { 0x12, 0x34 });
+    bus->writeIntoMemory(0x3FFF, 0x56);
+
+    // 0xFFFF mirrors 0x3FFF, next byte is at 0x0000
+    EXPECT_EQ(0x1256, bus->readWordFromMemory(0xFFFF));
+    EXPECT_EQ(0x341256u, bus->fetchInstructionWindow(0xFFFF));
+    EXPECT_EQ(0x125600u, bus->fetchInstructionWindow(0xFFFE));
+}
+
+TEST_F(BusImplTests, testWordWriteIsWriteProtectedByteByByte)
+{
+    bus->loadIntoMemory(0x1FFF, { 0x12 });
+
+    bus->writeWordIntoMemory(0x1FFF, 0xABCD);
+
+    EXPECT_EQ(0x12, bus->readFromMemory(0x1FFF));
+    EXPECT_EQ(0xAB, bus->readFromMemory(0x2000));
+}
+
+TEST_F(BusImplTests, testStaticallyDispatchedCpuMatchesVirtualCpu)
+{
+    // LXI H,2400; MVI B,10; loop: MOV M,B; INX H; DCR B; JNZ loop; HLT
+    std::vector<u8> program = { 0x21, 0x00, 0x24, 0x06, 0x10, 0x70, 0x23, 0x05, 0xC2, 0x05, 0x00, 0x76 };
+    auto otherBus = std::make_shared<BusImpl>();
+    bus->loadIntoMemory(0x0000, program);
+    otherBus->loadIntoMemory(0x0000, program);
+
+    CpuCore<BusImpl> staticCpu(bus);
+    CpuImpl virtualCpu(otherBus);
+
+    EXPECT_EQ(virtualCpu.run(1000), staticCpu.run(1000));
+    EXPECT_TRUE(staticCpu.isHalted());
+    EXPECT_EQ(virtualCpu.getRegisters().getHl().getRaw(), staticCpu.getRegisters().getHl().getRaw());
+    for (u16 addr = 0x2400; addr < 0x2410; addr++)
+    {
+        EXPECT_EQ(0x10 - (addr - 0x2400), bus->readFromMemory(addr));
+        EXPECT_EQ(otherBus->readFromMemory(addr), bus->readFromMemory(addr));
+    }
+}
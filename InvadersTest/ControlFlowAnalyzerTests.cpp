@@ -0,0 +1,154 @@
+#include <sstream>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "..//Invaders/BlockCacheCpuImpl.hpp"
+#include "..//Invaders/BusImpl.hpp"
+#include "..//Invaders/ControlFlowAnalyzer.hpp"
+
+class ControlFlowAnalyzerTests : public testing::Test
+{
+    protected:
+        void loadProgram(u16 addr, std::initializer_list<u8> bytes)
+        {
+            if (image.size() < addr + bytes.size())
+                image.resize(addr + bytes.size(), 0);
+            for (auto byte : bytes)
+                image[addr++] = byte;
+        }
+
+        void loadRoutines()
+        {
+            loadProgram(0x0000, { 0xC3, 0x40, 0x00 });   // JMP 0040H
+            loadProgram(0x0040, { 0xCD, 0x50, 0x00,      // CALL 0050H
+                                  0xC2, 0x40, 0x00,      // JNZ 0040H
+                                  0x76,                  // HLT
+                                  0xC3, 0x40, 0x00 });   // JMP 0040H
+            loadProgram(0x0050, { 0x3E, 0x01,            // MVI A,01H
+                                  0xC9 });               // RET
+        }
+
+        std::vector<u8> image;
+};
+
+TEST_F(ControlFlowAnalyzerTests, testBlocksAreBuiltFromEntryPoint)
+{
+    loadRoutines();
+    ControlFlowAnalyzer analyzer(0x0000, image);
+    analyzer.addEntryPoint(0x0000);
+    analyzer.analyze();
+
+    const auto& blocks = analyzer.getBlocks();
+    ASSERT_EQ(6, blocks.size());
+    EXPECT_EQ(BlockExit::JUMP, blocks.at(0x0000).exit);
+    EXPECT_EQ(std::vector<u16>({ 0x0040 }), blocks.at(0x0000).successors);
+    EXPECT_EQ(BlockExit::CALL, blocks.at(0x0040).exit);
+    EXPECT_EQ(std::vector<u16>({ 0x0043 }), blocks.at(0x0040).successors);
+    EXPECT_EQ(BlockExit::CONDITIONAL_JUMP, blocks.at(0x0043).exit);
+    EXPECT_EQ(std::vector<u16>({ 0x0040, 0x0046 }), blocks.at(0x0043).successors);
+    EXPECT_EQ(BlockExit::HALT, blocks.at(0x0046).exit);
+    EXPECT_EQ(BlockExit::RETURN, blocks.at(0x0050).exit);
+    EXPECT_EQ(2, blocks.at(0x0050).instructionCount);
+    EXPECT_EQ(3, blocks.at(0x0050).length);
+    EXPECT_TRUE(blocks.at(0x0050).successors.empty());
+
+    EXPECT_EQ(std::set<u16>({ 0x0000, 0x0050 }), analyzer.getRoutines());
+    EXPECT_EQ(ByteClass::OPCODE, analyzer.getByteClass(0x0040));
+    EXPECT_EQ(ByteClass::OPERAND, analyzer.getByteClass(0x0041));
+    EXPECT_EQ(ByteClass::UNKNOWN, analyzer.getByteClass(0x0003));
+    EXPECT_EQ(ByteClass::UNKNOWN, analyzer.getByteClass(0x1000));
+}
+
+TEST_F(ControlFlowAnalyzerTests, testJumpTableIsResolved)
+{
+    loadProgram(0x0000, { 0x21, 0x0A, 0x00,      // LXI H,000AH
+                          0x19,                  // DAD D
+                          0x5E,                  // MOV E,M
+                          0x23,                  // INX H
+                          0x56,                  // MOV D,M
+                          0xEB,                  // XCHG
+                          0xE9 });               // PCHL
+    loadProgram(0x000A, { 0x11, 0x00,            // Jump table
+                          0x12, 0x00 });
+    loadProgram(0x000E, { 0x01, 0x00, 0x00,      // LXI B,0000H
+                          0x76,                  // HLT
+                          0xC9 });               // RET
+
+    ControlFlowAnalyzer analyzer(0x0000, image);
+    analyzer.addEntryPoint(0x0000);
+    analyzer.addEntryPoint(0x000E);
+    analyzer.analyze();
+
+    // Table ends where code starts, although LXI B,0000H looks like address in image
+    ASSERT_EQ(1, analyzer.getJumpTables().size());
+    const auto& table = analyzer.getJumpTables().front();
+    EXPECT_EQ(0x0008, table.jumpAddr);
+    EXPECT_EQ(0x000A, table.tableAddr);
+    EXPECT_EQ(std::vector<u16>({ 0x0011, 0x0012 }), table.targets);
+    EXPECT_TRUE(analyzer.getUnresolvedJumps().empty());
+
+    EXPECT_EQ(BlockExit::INDIRECT, analyzer.getBlocks().at(0x0000).exit);
+    EXPECT_EQ(std::vector<u16>({ 0x0011, 0x0012 }), analyzer.getBlocks().at(0x0000).successors);
+    EXPECT_EQ(1, analyzer.getRoutines().count(0x0012));
+    EXPECT_EQ(ByteClass::UNKNOWN, analyzer.getByteClass(0x0009));
+    EXPECT_EQ(4, analyzer.getByteCount(ByteClass::DATA));
+    EXPECT_EQ(ByteClass::DATA, analyzer.getByteClass(0x000D));
+}
+
+TEST_F(ControlFlowAnalyzerTests, testDataReferencesAndUnresolvedJumps)
+{
+    loadProgram(0x0000, { 0x2A, 0x05, 0x00,      // LHLD 0005H
+                          0xE9,                  // PCHL
+                          0x00,
+                          0x34, 0x12,
+                          0x00 });
+
+    // Only reset vector is inside image
+    ControlFlowAnalyzer analyzer(0x0000, image);
+    analyzer.addRestartVectors();
+    analyzer.analyze();
+    EXPECT_EQ(std::set<u16>({ 0x0000 }), analyzer.getRoutines());
+
+    EXPECT_EQ(std::vector<u16>({ 0x0003 }), analyzer.getUnresolvedJumps());
+    EXPECT_EQ(BlockExit::INDIRECT, analyzer.getBlocks().at(0x0000).exit);
+    EXPECT_TRUE(analyzer.getBlocks().at(0x0000).successors.empty());
+
+    EXPECT_EQ(ByteClass::UNKNOWN, analyzer.getByteClass(0x0004));
+    EXPECT_EQ(ByteClass::DATA, analyzer.getByteClass(0x0005));
+    EXPECT_EQ(ByteClass::DATA, analyzer.getByteClass(0x0006));
+    EXPECT_EQ(ByteClass::UNKNOWN, analyzer.getByteClass(0x0007));
+    EXPECT_EQ(4, analyzer.getByteCount(ByteClass::OPCODE) + analyzer.getByteCount(ByteClass::OPERAND));
+}
+
+TEST_F(ControlFlowAnalyzerTests, testCodeMapIsPredecoded)
+{
+    loadRoutines();
+    ControlFlowAnalyzer analyzer(0x0000, image);
+    analyzer.addEntryPoint(0x0000);
+    analyzer.analyze();
+
+    std::stringstream stream;
+    analyzer.getCodeMap().write(stream);
+    ReachableCodeMap map;
+    ASSERT_TRUE(ReachableCodeMap::read(stream, map));
+    EXPECT_EQ(std::vector<u16>({ 0x0000, 0x0040, 0x0043, 0x0046, 0x0047, 0x0050 }), map.getBlocks());
+    EXPECT_EQ(std::vector<u16>({ 0x0000, 0x0050 }), map.getRoutines());
+    EXPECT_TRUE(map.matches(0x0000, image));
+
+    auto bus = std::make_shared<BusImpl>();
+    bus->loadIntoMemory(0x0000, image);
+    BlockCacheCpuImpl cpu(bus);
+    ASSERT_TRUE(cpu.predecodeBlocks(map));
+    EXPECT_EQ(6, cpu.getCachedBlockCount());
+
+    cpu.run(200);
+    EXPECT_EQ(0, cpu.getBlockCacheStats().misses);
+    EXPECT_LT(0, cpu.getBlockCacheStats().hits);
+
+    // Map of different image is not loaded
+    bus->loadIntoMemory(0x0051, { 0x02 });
+    BlockCacheCpuImpl otherCpu(bus);
+    EXPECT_FALSE(otherCpu.predecodeBlocks(map));
+    EXPECT_EQ(0, otherCpu.getCachedBlockCount());
+}
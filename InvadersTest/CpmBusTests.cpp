@@ -0,0 +1,62 @@
+#include <sstream>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "..//Invaders/CpmBus.hpp"
+#include "..//Invaders/CpuImpl.hpp"
+
+class CpmBusTests : public testing::Test
+{
+    protected:
+        void SetUp() override
+        {
+            bus = std::make_shared<CpmBus>();
+            cpu = std::make_unique<CpuImpl>(bus);
+            cpu->getRegisters().getPc() = CpmBus::TPA_START;
+            cpu->getRegisters().getSp() = CpmBus::BDOS_STUB;
+        }
+
+        std::shared_ptr<CpmBus> bus;
+        std::unique_ptr<CpuImpl> cpu;
+};
+
+TEST_F(CpmBusTests, testMemoryIsFlatAndWritable)
+{
+    bus->writeIntoMemory(0x0010, 0x12);
+    bus->writeWordIntoMemory(0xFFFF, 0x3456);
+
+    EXPECT_EQ(0x12, bus->readFromMemory(0x0010));
+    EXPECT_EQ(0x56, bus->readFromMemory(0xFFFF));
+    EXPECT_EQ(0x34, bus->readFromMemory(0x0000));
+    // Top of memory for programs which set stack below BDOS
+    EXPECT_EQ(CpmBus::BDOS_STUB, bus->readWordFromMemory(CpmBus::BDOS_ENTRY + 1));
+}
+
+TEST_F(CpmBusTests, testBdosPrintsToConsole)
+{
+    // 0100: LXI D,0120; MVI C,09; CALL 0005; MVI E,21; MVI C,02; CALL 0005; JMP 0000
+    // 0120: "OK$"
+    bus->loadProgram({ 0x11, 0x20, 0x01, 0x0E, 0x09, 0xCD, 0x05, 0x00, 0x1E, 0x21, 0x0E, 0x02, 0xCD, 0x05, 0x00, 0xC3,
+                       0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+                       'O', 'K', '$' });
+    std::ostringstream console;
+    bus->setConsole(&console);
+
+    cpu->run(1000);
+
+    EXPECT_EQ("OK!", bus->getConsoleOutput());
+    EXPECT_EQ("OK!", console.str());
+}
+
+TEST_F(CpmBusTests, testWarmBootHaltsCpu)
+{
+    // 0100: JMP 0000
+    bus->loadProgram({ 0xC3, 0x00, 0x00 });
+
+    cpu->run(1000);
+
+    EXPECT_TRUE(cpu->isHalted());
+    EXPECT_EQ(0x0001, cpu->getRegisters().getPc());
+    EXPECT_FALSE(bus->loadProgram(std::vector<u8>(0x10000, 0)));
+}
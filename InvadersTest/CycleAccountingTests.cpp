@@ -0,0 +1,131 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "mocks/MemoryBusTest.hpp"
+
+#include "..//Invaders/CpuImpl.hpp"
+#include "..//Invaders/ThreadedCpuImpl.hpp"
+
+class CycleAccountingTests : public MemoryBusTest
+{
+    protected:
+        void SetUp() override
+        {
+            MemoryBusTest::SetUp();
+            testedCpu = std::make_unique<CpuImpl>(bus);
+        }
+
+        u64 measureInstruction(CpuImpl& cpu, u8 opcode)
+        {
+            auto before = cpu.getCycles();
+            cpu.executeInstruction(opcode);
+            return cpu.getCycles() - before;
+        }
+
+        std::unique_ptr<CpuImpl> testedCpu;
+
+        const u8 NOP_OPCODE = 0x00;
+        const u8 MOVE_B_C_OPCODE = 0x41;
+        const u8 MOVE_MEM_B_OPCODE = 0x70;
+        const u8 STORE_HL_DIRECT_OPCODE = 0x22;
+        const u8 EXCHANGE_STACK_HL_OPCODE = 0xE3;
+        const u8 CALL_ZERO_OPCODE = 0xCC;
+        const u8 RETURN_ZERO_OPCODE = 0xC8;
+};
+
+TEST_F(CycleAccountingTests, testInstructionCycles)
+{
+    for (auto mode : { DispatchMode::DECODER, DispatchMode::TABLE })
+    {
+        testedCpu->setDispatchMode(mode);
+        testedCpu->getRegisters().getSp() = 0x2400;
+
+        EXPECT_EQ(4, measureInstruction(*testedCpu, NOP_OPCODE));
+        EXPECT_EQ(5, measureInstruction(*testedCpu, MOVE_B_C_OPCODE));
+        EXPECT_EQ(7, measureInstruction(*testedCpu, MOVE_MEM_B_OPCODE));
+        EXPECT_EQ(16, measureInstruction(*testedCpu, STORE_HL_DIRECT_OPCODE));
+        EXPECT_EQ(18, measureInstruction(*testedCpu, EXCHANGE_STACK_HL_OPCODE));
+    }
+}
+
+TEST_F(CycleAccountingTests, testConditionalCallAndReturnCycles)
+{
+    for (auto mode : { DispatchMode::DECODER, DispatchMode::TABLE })
+    {
+        testedCpu->setDispatchMode(mode);
+        auto& regs = testedCpu->getRegisters();
+        auto& flags = regs.getAf().getLow();
+        regs.getSp() = 0x2400;
+        regs.getPc() = 0x0100;
+
+        flags.Z = 0;
+        EXPECT_EQ(11, measureInstruction(*testedCpu, CALL_ZERO_OPCODE));
+        EXPECT_EQ(5, measureInstruction(*testedCpu, RETURN_ZERO_OPCODE));
+
+        flags.Z = 1;
+        EXPECT_EQ(17, measureInstruction(*testedCpu, CALL_ZERO_OPCODE));
+        EXPECT_EQ(11, measureInstruction(*testedCpu, RETURN_ZERO_OPCODE));
+    }
+}
+
+TEST_F(CycleAccountingTests, testRunReturnsOvershoot)
+{
+    // loop: JMP loop
+    loadProgram(0x0000, { 0xC3, 0x00, 0x00 });
+
+    for (auto mode : { DispatchMode::DECODER, DispatchMode::TABLE })
+    {
+        testedCpu->setDispatchMode(mode);
+        testedCpu->getRegisters().getPc() = 0x0000;
+        auto before = testedCpu->getCycles();
+
+        EXPECT_EQ(5, testedCpu->run(25));
+        EXPECT_EQ(30, testedCpu->getCycles() - before);
+        EXPECT_EQ(0, testedCpu->run(20));
+        EXPECT_EQ(50, testedCpu->getCycles() - before);
+    }
+}
+
+TEST_F(CycleAccountingTests, testHaltedCpuConsumesBudget)
+{
+    // NOP; HLT
+    loadProgram(0x0000, { 0x00, 0x76 });
+    testedCpu->getRegisters().getPc() = 0x0000;
+
+    EXPECT_EQ(0, testedCpu->run(100));
+    EXPECT_TRUE(testedCpu->isHalted());
+    EXPECT_EQ(100, testedCpu->getCycles());
+    EXPECT_EQ(0x0002, testedCpu->getRegisters().getPc());
+
+    EXPECT_EQ(0, testedCpu->run(100));
+    EXPECT_EQ(200, testedCpu->getCycles());
+
+    // NOP and HLT take 4 + 7 cycles of first batch
+    EXPECT_EQ(189, testedCpu->getIdleStats().haltedCycles);
+}
+
+TEST_F(CycleAccountingTests, testThreadedRunMatchesInterpreter)
+{
+    // MVI B,20; loop: DCR B; CZ 0010; JMP loop
+    // 0010: MVI B,20; RET
+    loadProgram(0x0000, { 0x06, 0x20, 0x05, 0xCC, 0x10, 0x00, 0xC3, 0x02, 0x00 });
+    loadProgram(0x0010, { 0x06, 0x20, 0xC9 });
+
+    std::array<u8, 0x10000> threadedMemory = memory;
+    auto threadedBus = makeMemoryBus(threadedMemory);
+    ThreadedCpuImpl threadedCpu(threadedBus);
+
+    for (auto* regs : { &testedCpu->getRegisters(), &threadedCpu.getRegisters() })
+    {
+        regs->getPc() = 0x0000;
+        regs->getSp() = 0x2400;
+    }
+
+    for (auto budget : { 1000u, 33333u, 7u, 16666u })
+    {
+        EXPECT_EQ(testedCpu->run(budget), threadedCpu.run(budget));
+        EXPECT_EQ(testedCpu->getCycles(), threadedCpu.getCycles());
+        EXPECT_EQ(testedCpu->getRegisters().getPc(), threadedCpu.getRegisters().getPc());
+        EXPECT_EQ(testedCpu->getRegisters().getBc().getRaw(), threadedCpu.getRegisters().getBc().getRaw());
+    }
+}
@@ -0,0 +1,132 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "mocks/MemoryBusTest.hpp"
+
+#include "..//Invaders/BusImpl.hpp"
+#include "..//Invaders/CpuImpl.hpp"
+#include "..//Invaders/Debugger.hpp"
+#include "..//Invaders/JitCpuImpl.hpp"
+
+class DebuggerTests : public MemoryBusTest
+{
+    protected:
+        void SetUp() override
+        {
+            MemoryBusTest::SetUp();
+            cpu = std::make_unique<CpuImpl>(bus);
+
+            cpu->setDebugger(&debugger);
+        }
+
+        Debugger debugger;
+        std::unique_ptr<CpuImpl> cpu;
+};
+
+TEST_F(DebuggerTests, testBreakpointStopsBeforeInstruction)
+{
+    loadProgram(0x0000, { 0x06, 0x01,           // MVI B,01H
+                          0x04,                 // INR B
+                          0xC3, 0x02, 0x00 });  // JMP 0002H
+    debugger.addBreakpoint(0x0002);
+
+    cpu->run(1000);
+    ASSERT_TRUE(debugger.hasStopped());
+    EXPECT_EQ(StopReason::BREAKPOINT, debugger.getStop().reason);
+    EXPECT_EQ(0x0002, debugger.getStop().pc);
+    EXPECT_EQ(0x0002, cpu->getRegisters().getPc());
+    EXPECT_EQ(0x01, cpu->getRegisters().getBc().getHigh());
+    EXPECT_EQ(7, cpu->getCycles());
+
+    // Next run continues from breakpoint and stops on it in the next iteration
+    debugger.resume();
+    cpu->run(1000);
+    EXPECT_TRUE(debugger.hasStopped());
+    EXPECT_EQ(0x02, cpu->getRegisters().getBc().getHigh());
+    EXPECT_EQ(22, cpu->getCycles());
+
+    debugger.removeBreakpoint(0x0002);
+    EXPECT_FALSE(debugger.isActive());
+    cpu->run(1000);
+    EXPECT_LE(1022, cpu->getCycles());
+}
+
+TEST_F(DebuggerTests, testWriteWatchpointStopsAfterInstruction)
+{
+    loadProgram(0x0000, { 0x21, 0xFF, 0x1F,     // LXI H,1FFFH
+                          0x36, 0x11,           // MVI M,11H
+                          0x23,                 // INX H
+                          0x7E,                 // MOV A,M
+                          0x36, 0x22,           // MVI M,22H
+                          0x76 });              // HLT
+    debugger.addWatchpoint(0x2000, 0x23FF, WatchAccess::WRITE);
+
+    cpu->run(1000);
+    ASSERT_TRUE(debugger.hasStopped());
+    const auto& stop = debugger.getStop();
+    EXPECT_EQ(StopReason::WATCHPOINT, stop.reason);
+    EXPECT_EQ(0x0007, stop.pc);
+    EXPECT_EQ(0x2000, stop.addr);
+    EXPECT_EQ(WatchAccess::WRITE, stop.access);
+    EXPECT_EQ(0x22, stop.value);
+    EXPECT_EQ(0x0009, cpu->getRegisters().getPc());
+}
+
+TEST_F(DebuggerTests, testStackAccessIsWatchedOnlyWhenTaken)
+{
+    loadProgram(0x0000, { 0x31, 0x00, 0x24,     // LXI SP,2400H
+                          0xAF,                 // XRA A
+                          0xC4, 0x10, 0x00,     // CNZ 0010H
+                          0xCC, 0x10, 0x00 });  // CZ 0010H
+    loadProgram(0x0010, { 0xC0,                 // RNZ
+                          0xC9 });              // RET
+    debugger.addWatchpoint(0x23FE, 0x23FF, WatchAccess::READ_WRITE);
+
+    cpu->run(1000);
+    ASSERT_TRUE(debugger.hasStopped());
+    EXPECT_EQ(0x0007, debugger.getStop().pc);
+    EXPECT_EQ(WatchAccess::WRITE, debugger.getStop().access);
+
+    debugger.resume();
+    cpu->run(1000);
+    ASSERT_TRUE(debugger.hasStopped());
+    EXPECT_EQ(0x0011, debugger.getStop().pc);
+    EXPECT_EQ(WatchAccess::READ, debugger.getStop().access);
+    EXPECT_EQ(0x0A, debugger.getStop().value);
+}
+
+TEST_F(DebuggerTests, testReturnAliasReadsWatchedStack)
+{
+    loadProgram(0x0000, { 0x31, 0x00, 0x24,     // LXI SP,2400H
+                          0xCD, 0x10, 0x00 });  // CALL 0010H
+    loadProgram(0x0010, { 0xD9 });              // RET (undocumented alias)
+    debugger.addWatchpoint(0x23FE, 0x23FF, WatchAccess::READ);
+
+    cpu->run(1000);
+    ASSERT_TRUE(debugger.hasStopped());
+    EXPECT_EQ(0x0010, debugger.getStop().pc);
+    EXPECT_EQ(WatchAccess::READ, debugger.getStop().access);
+    EXPECT_EQ(0x0006, cpu->getRegisters().getPc());
+}
+
+TEST_F(DebuggerTests, testDebuggerStopsCachingBackend)
+{
+    auto busImpl = std::make_shared<BusImpl>();
+    busImpl->loadIntoMemory(0x0000, { 0x06, 0x00,           // MVI B,00H
+                                      0x04,                 // INR B
+                                      0xC3, 0x02, 0x00 });  // JMP 0002H
+    JitCpuImpl jit(busImpl);
+    jit.run(1000);
+
+    // Breakpoint set between runs is seen by the next batch
+    jit.setDebugger(&debugger);
+    debugger.addBreakpoint(0x0002);
+    jit.run(1000);
+    ASSERT_TRUE(debugger.hasStopped());
+    EXPECT_EQ(0x0002, jit.getRegisters().getPc());
+
+    const u8 iterations = jit.getRegisters().getBc().getHigh();
+    debugger.clear();
+    jit.run(15);
+    EXPECT_EQ(static_cast<u8>(iterations + 1), jit.getRegisters().getBc().getHigh());
+}
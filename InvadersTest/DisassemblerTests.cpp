@@ -0,0 +1,32 @@
+#include "gtest/gtest.h"
+
+#include "..//Invaders/Disassembler.hpp"
+
+TEST(DisassemblerTests, testMnemonics)
+{
+    EXPECT_EQ("NOP", Disassembler::getMnemonic(0x00));
+    EXPECT_EQ("LXI SP", Disassembler::getMnemonic(0x31));
+    EXPECT_EQ("LDAX D", Disassembler::getMnemonic(0x1A));
+    EXPECT_EQ("DCR B", Disassembler::getMnemonic(0x05));
+    EXPECT_EQ("MOV M,A", Disassembler::getMnemonic(0x77));
+    EXPECT_EQ("HLT", Disassembler::getMnemonic(0x76));
+    EXPECT_EQ("CMP M", Disassembler::getMnemonic(0xBE));
+    EXPECT_EQ("RNZ", Disassembler::getMnemonic(0xC0));
+    EXPECT_EQ("POP PSW", Disassembler::getMnemonic(0xF1));
+    EXPECT_EQ("PCHL", Disassembler::getMnemonic(0xE9));
+    EXPECT_EQ("JPE", Disassembler::getMnemonic(0xEA));
+    EXPECT_EQ("XCHG", Disassembler::getMnemonic(0xEB));
+    EXPECT_EQ("CALL", Disassembler::getMnemonic(0xCD));
+    EXPECT_EQ("ANI", Disassembler::getMnemonic(0xE6));
+    EXPECT_EQ("RST 7", Disassembler::getMnemonic(0xFF));
+}
+
+TEST(DisassemblerTests, testImmedateOperands)
+{
+    EXPECT_EQ("MVI B,40H", Disassembler::disassemble(0x06, 0x0040));
+    EXPECT_EQ("LXI H,2400H", Disassembler::disassemble(0x21, 0x2400));
+    EXPECT_EQ("JNZ 0105H", Disassembler::disassemble(0xC2, 0x0105));
+    EXPECT_EQ("ANI 0FFH", Disassembler::disassemble(0xE6, 0x00FF));
+    EXPECT_EQ("OUT 03H", Disassembler::disassemble(0xD3, 0x0003));
+    EXPECT_EQ("INR A", Disassembler::disassemble(0x3C, 0x1234));
+}
@@ -0,0 +1,83 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "mocks/MemoryBusTest.hpp"
+
+#include "..//Invaders/CpuImpl.hpp"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+class DispatchTableTests : public testing::TestWithParam<int>
+{
+    protected:
+        void SetUp() override
+        {
+            fillMemory(decoderMemory);
+            fillMemory(tableMemory);
+            decoderBus = makeMemoryBus(decoderMemory);
+            tableBus = makeMemoryBus(tableMemory);
+            mockInputPorts(*decoderBus);
+            mockInputPorts(*tableBus);
+
+            decoderCpu = std::make_unique<CpuImpl>(decoderBus, DispatchMode::DECODER);
+            tableCpu = std::make_unique<CpuImpl>(tableBus, DispatchMode::TABLE);
+
+            initRegisters(decoderCpu->getRegisters());
+            initRegisters(tableCpu->getRegisters());
+        }
+
+        // Fills memory with pseudo-random pattern
+        void fillMemory(std::array<u8, 0x10000>& memory)
+        {
+            for (unsigned addr = 0; addr < memory.size(); addr++)
+                memory[addr] = static_cast<u8>(addr * 7 + (addr >> 8));
+        }
+
+        void mockInputPorts(BusMock& bus)
+        {
+            ON_CALL(bus, readFromInputPort(_))
+                .WillByDefault(Invoke([](u8 port) { return static_cast<u8>(port ^ 0x5A); }));
+        }
+
+        void initRegisters(Registers& regs)
+        {
+            regs.getAf() = 0x9BD7;
+            regs.getBc() = 0x1234;
+            regs.getDe() = 0x3456;
+            regs.getHl() = 0x2468;
+            regs.getSp() = 0x2400;
+            regs.getPc() = 0x0100;
+        }
+
+        std::unique_ptr<CpuImpl> decoderCpu;
+        std::unique_ptr<CpuImpl> tableCpu;
+        std::shared_ptr<NiceMock<BusMock>> decoderBus;
+        std::shared_ptr<NiceMock<BusMock>> tableBus;
+        std::array<u8, 0x10000> decoderMemory;
+        std::array<u8, 0x10000> tableMemory;
+};
+
+TEST_P(DispatchTableTests, testTableHandlerMatchesDecoder)
+{
+    const auto opcode = static_cast<u8>(GetParam());
+
+    decoderCpu->executeInstruction(opcode);
+    tableCpu->executeInstruction(opcode);
+
+    auto& expected = decoderCpu->getRegisters();
+    auto& actual = tableCpu->getRegisters();
+
+    EXPECT_EQ(expected.getAf().getRaw(), actual.getAf().getRaw());
+    EXPECT_EQ(expected.getBc().getRaw(), actual.getBc().getRaw());
+    EXPECT_EQ(expected.getDe().getRaw(), actual.getDe().getRaw());
+    EXPECT_EQ(expected.getHl().getRaw(), actual.getHl().getRaw());
+    EXPECT_EQ(expected.getSp(), actual.getSp());
+    EXPECT_EQ(expected.getPc(), actual.getPc());
+    EXPECT_EQ(decoderCpu->isHalted(), tableCpu->isHalted());
+    EXPECT_EQ(decoderCpu->interruptsEnabled(), tableCpu->interruptsEnabled());
+    EXPECT_TRUE(decoderMemory == tableMemory);
+}
+
+INSTANTIATE_TEST_SUITE_P(AllOpcodes, DispatchTableTests, testing::Range(0, 256));
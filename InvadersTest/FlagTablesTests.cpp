@@ -0,0 +1,67 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "..//Invaders/FlagTables.hpp"
+
+class FlagTablesTests : public testing::Test
+{
+    protected:
+        const FlagTables& tables = FlagTables::getInstance();
+};
+
+TEST_F(FlagTablesTests, testSzp)
+{
+    EXPECT_EQ(FlagTables::ZERO | FlagTables::PARITY, tables.getSzp(0x00));
+    EXPECT_EQ(FlagTables::SIGN, tables.getSzp(0x80));
+    EXPECT_EQ(FlagTables::PARITY, tables.getSzp(0x03));
+    EXPECT_EQ(0, tables.getSzp(0x01));
+    EXPECT_EQ(FlagTables::SIGN | FlagTables::PARITY, tables.getSzp(0xFF));
+}
+
+TEST_F(FlagTablesTests, testAdd)
+{
+    const auto& result = tables.getAdd(0x2E, 0x6C, 0);
+    EXPECT_EQ(0x9A, result.result);
+    EXPECT_EQ(FlagTables::SIGN | FlagTables::AUX_CARRY | FlagTables::PARITY, result.flags);
+
+    const auto& carryResult = tables.getAdd(0xF0, 0x0F, 1);
+    EXPECT_EQ(0x00, carryResult.result);
+    EXPECT_EQ(FlagTables::ZERO | FlagTables::PARITY | FlagTables::CARRY, carryResult.flags);
+}
+
+TEST_F(FlagTablesTests, testSubtract)
+{
+    const auto& result = tables.getSubtract(0x3E, 0x3E, 0);
+    EXPECT_EQ(0x00, result.result);
+    EXPECT_EQ(FlagTables::ZERO | FlagTables::AUX_CARRY | FlagTables::PARITY, result.flags);
+
+    const auto& borrowResult = tables.getSubtract(0x04, 0x02, 1);
+    EXPECT_EQ(0x01, borrowResult.result);
+    EXPECT_EQ(FlagTables::AUX_CARRY, borrowResult.flags);
+
+    const auto& negativeResult = tables.getSubtract(0x02, 0x05, 0);
+    EXPECT_EQ(0xFD, negativeResult.result);
+    EXPECT_EQ(FlagTables::SIGN | FlagTables::CARRY, negativeResult.flags);
+}
+
+TEST_F(FlagTablesTests, testIncrementAndDecrement)
+{
+    const auto& incremented = tables.getIncrement(0x8F);
+    EXPECT_EQ(0x90, incremented.result);
+    EXPECT_EQ(FlagTables::SIGN | FlagTables::AUX_CARRY | FlagTables::PARITY, incremented.flags);
+
+    const auto& decremented = tables.getDecrement(0x00);
+    EXPECT_EQ(0xFF, decremented.result);
+    EXPECT_EQ(FlagTables::SIGN | FlagTables::AUX_CARRY | FlagTables::PARITY, decremented.flags);
+}
+
+TEST_F(FlagTablesTests, testDecimalAdjust)
+{
+    const auto& result = tables.getDecimalAdjust(0x9B, 0, 0);
+    EXPECT_EQ(0x01, result.result);
+    EXPECT_EQ(FlagTables::AUX_CARRY | FlagTables::CARRY, result.flags);
+
+    const auto& unchanged = tables.getDecimalAdjust(0x42, 0, 0);
+    EXPECT_EQ(0x42, unchanged.result);
+    EXPECT_EQ(FlagTables::PARITY, unchanged.flags);
+}
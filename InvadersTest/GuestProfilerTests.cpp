@@ -0,0 +1,112 @@
+#include <sstream>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "mocks/MemoryBusTest.hpp"
+
+#include "..//Invaders/CpuImpl.hpp"
+#include "..//Invaders/GuestProfiler.hpp"
+
+class GuestProfilerTests : public MemoryBusTest
+{
+    protected:
+        void SetUp() override
+        {
+            MemoryBusTest::SetUp();
+            cpu = std::make_unique<CpuImpl>(bus);
+        }
+
+        std::unique_ptr<CpuImpl> cpu;
+};
+
+TEST_F(GuestProfilerTests, testSamplesAreAttributedToCallStack)
+{
+    loadProgram(0x0000, { 0x31, 0x00, 0x24,     // LXI SP,2400H
+                          0xCD, 0x10, 0x00,     // CALL 0010H
+                          0xC3, 0x03, 0x00 });  // JMP 0003H
+    loadProgram(0x0010, { 0x06, 0x10,           // MVI B,10H
+                          0x05,                 // DCR B
+                          0xC2, 0x12, 0x00,     // JNZ 0012H
+                          0xC9 });              // RET
+
+    GuestProfiler profiler(7);
+    profiler.addSymbol(0x0000, "main");
+    profiler.addSymbol(0x0010, "delay");
+    cpu->setProfiler(&profiler);
+    cpu->run(10000);
+
+    EXPECT_EQ(cpu->getCycles() / 7, profiler.getSampleCount());
+    EXPECT_LE(profiler.getDepth(), 1);
+
+    std::ostringstream folded;
+    profiler.writeFoldedStacks(folded);
+    std::istringstream lines(folded.str());
+    std::string stack;
+    u64 count = 0;
+    u64 total = 0;
+    std::vector<std::string> stacks;
+    while (lines >> stack >> count)
+    {
+        stacks.push_back(stack);
+        total += count;
+    }
+    EXPECT_EQ((std::vector<std::string>{ "main", "main;delay" }), stacks);
+    EXPECT_EQ(profiler.getSampleCount(), total);
+}
+
+TEST_F(GuestProfilerTests, testHaltedCpuIsSampled)
+{
+    loadProgram(0x0000, { 0x76 });  // HLT
+
+    GuestProfiler profiler(100);
+    cpu->setProfiler(&profiler);
+    cpu->run(1000);
+
+    std::ostringstream folded;
+    profiler.writeFoldedStacks(folded);
+    EXPECT_EQ("0001 10\n", folded.str());
+}
+
+TEST_F(GuestProfilerTests, testReturnLeavesAbandonedFrames)
+{
+    loadProgram(0x0000, { 0x31, 0x00, 0x24,     // LXI SP,2400H
+                          0xCD, 0x10, 0x00,     // CALL 0010H
+                          0x76 });              // HLT
+    loadProgram(0x0010, { 0xCD, 0x20, 0x00 });  // CALL 0020H
+    loadProgram(0x0020, { 0xE1,                 // POP H
+                          0xC9 });              // RET
+
+    GuestProfiler profiler;
+    cpu->setProfiler(&profiler);
+
+    cpu->run(1);
+    cpu->run(1);
+    EXPECT_EQ(1, profiler.getDepth());
+    cpu->run(1);
+    EXPECT_EQ(2, profiler.getDepth());
+    cpu->run(1);
+    cpu->run(1);
+    EXPECT_EQ(0x0006, cpu->getRegisters().getPc());
+    EXPECT_EQ(0, profiler.getDepth());
+}
+
+TEST_F(GuestProfilerTests, testSymbolFileIsParsed)
+{
+    GuestProfiler profiler;
+    std::istringstream symbols("; Space Invaders\n0000 Reset\n\n# Routines\n01E4 BlockCopy\n0x1A32 DrawSprite\n");
+    ASSERT_TRUE(profiler.loadSymbols(symbols));
+
+    EXPECT_EQ(3, profiler.getSymbolCount());
+    EXPECT_EQ("Reset", profiler.getSymbolName(0x0005));
+    EXPECT_EQ("BlockCopy", profiler.getSymbolName(0x01E4));
+    EXPECT_EQ("DrawSprite", profiler.getSymbolName(0x1A40));
+
+    std::istringstream invalidAddress("01G4 BlockCopy\n");
+    EXPECT_FALSE(profiler.loadSymbols(invalidAddress));
+    std::istringstream missingName("01E4\n");
+    EXPECT_FALSE(profiler.loadSymbols(missingName));
+
+    GuestProfiler withoutSymbols;
+    EXPECT_EQ("01E4", withoutSymbols.getSymbolName(0x01E4));
+}
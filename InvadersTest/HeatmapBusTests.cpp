@@ -0,0 +1,109 @@
+#include <cstring>
+#include <sstream>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "..//Invaders/BlockCacheCpuImpl.hpp"
+#include "..//Invaders/BusImpl.hpp"
+#include "..//Invaders/CpuImpl.hpp"
+#include "..//Invaders/HeatmapBus.hpp"
+#include "..//Invaders/InstructionTrace.hpp"
+
+class HeatmapBusTests : public testing::Test
+{
+    protected:
+        void SetUp() override
+        {
+            busImpl = std::make_shared<BusImpl>();
+            bus = std::make_shared<HeatmapBus>(busImpl);
+            cpu = std::make_unique<CpuImpl>(bus);
+
+            busImpl->loadIntoMemory(0x0000, { 0x21, 0x00, 0x24,     // LXI H,2400H
+                                              0x36, 0xFF,           // MVI M,0FFH
+                                              0x34,                 // INR M
+                                              0x3A, 0x01, 0x24,     // LDA 2401H
+                                              0x32, 0x02, 0x24,     // STA 2402H
+                                              0x22, 0x10, 0x24,     // SHLD 2410H
+                                              0xD3, 0x03,           // OUT 03H
+                                              0xDB, 0x01,           // IN 01H
+                                              0x76 });              // HLT
+            cpu->run(1000);
+        }
+
+        std::shared_ptr<BusImpl> busImpl;
+        std::shared_ptr<HeatmapBus> bus;
+        std::unique_ptr<CpuImpl> cpu;
+};
+
+TEST_F(HeatmapBusTests, testAccessesAreCountedByKind)
+{
+    EXPECT_EQ(1, bus->getCount(BusAccess::FETCH, 0x0000));
+    EXPECT_EQ(1, bus->getCount(BusAccess::FETCH, 0x0002));
+    EXPECT_EQ(1, bus->getCount(BusAccess::FETCH, 0x0013));
+    EXPECT_EQ(0, bus->getCount(BusAccess::READ, 0x0000));
+
+    EXPECT_EQ(1, bus->getCount(BusAccess::READ, 0x2400));
+    EXPECT_EQ(2, bus->getCount(BusAccess::WRITE, 0x2400));
+    EXPECT_EQ(0, bus->getCount(BusAccess::REFERENCE, 0x2400));
+    EXPECT_EQ(1, bus->getCount(BusAccess::READ, 0x2401));
+    EXPECT_EQ(1, bus->getCount(BusAccess::WRITE, 0x2402));
+    EXPECT_EQ(1, bus->getCount(BusAccess::WRITE, 0x2411));
+    EXPECT_EQ(5, bus->getPageCount(BusAccess::WRITE, 0x24));
+
+    EXPECT_EQ(1, bus->getPortWrites(3));
+    EXPECT_EQ(1, bus->getPortReads(1));
+    EXPECT_EQ(0, bus->getPortReads(3));
+
+    bus->clear();
+    EXPECT_EQ(0, bus->getPageCount(BusAccess::FETCH, 0x00));
+}
+
+TEST_F(HeatmapBusTests, testHeatmapIsExported)
+{
+    std::ostringstream csv;
+    bus->writeCsv(csv);
+    EXPECT_EQ(0, csv.str().find("address,reads,writes,fetches,references\n"));
+    EXPECT_NE(std::string::npos, csv.str().find("\n2402,0,1,0,0\n"));
+    EXPECT_NE(std::string::npos, csv.str().find("\nport,reads,writes\n01,1,0\n03,0,1\n"));
+
+    std::ostringstream pageCsv;
+    bus->writeCsv(pageCsv, HeatmapGranularity::PAGE);
+    EXPECT_NE(std::string::npos, pageCsv.str().find("\n0000,0,0,20,0\n2400,2,5,0,0\n"));
+
+    std::ostringstream binary;
+    bus->writeBinary(binary, HeatmapGranularity::PAGE);
+    const auto data = binary.str();
+    ASSERT_EQ(sizeof(HeatmapFileHeader) + (4 * 256 + 2 * 256) * sizeof(u64), data.size());
+
+    HeatmapFileHeader header;
+    std::memcpy(&header, data.data(), sizeof(header));
+    EXPECT_STREQ("I8080HM", header.magic);
+    EXPECT_EQ(HeatmapBus::FILE_VERSION, header.version);
+    EXPECT_EQ(HeatmapBus::PAGE_SIZE, header.granularity);
+
+    u64 pageWrites = 0;
+    std::memcpy(&pageWrites, data.data() + sizeof(header) + (256 + 0x24) * sizeof(u64), sizeof(pageWrites));
+    EXPECT_EQ(5, pageWrites);
+}
+
+TEST_F(HeatmapBusTests, testOnlyInstructionBytesAreFetched)
+{
+    // Traced instructions are read again for trace records
+    InstructionTrace trace;
+    bus->clear();
+    CpuImpl tracedCpu(bus);
+    tracedCpu.setTrace(&trace);
+    tracedCpu.run(1000);
+    EXPECT_EQ(1, bus->getCount(BusAccess::FETCH, 0x0005));
+    EXPECT_EQ(1, bus->getCount(BusAccess::FETCH, 0x0006));
+    EXPECT_EQ(20, bus->getPageCount(BusAccess::FETCH, 0x00));
+
+    // Block decoder fetches instruction windows
+    bus->clear();
+    BlockCacheCpuImpl blockCpu(bus);
+    blockCpu.run(1000);
+    EXPECT_EQ(1, bus->getCount(BusAccess::FETCH, 0x0005));
+    EXPECT_EQ(1, bus->getCount(BusAccess::FETCH, 0x0006));
+    EXPECT_EQ(20, bus->getPageCount(BusAccess::FETCH, 0x00));
+}
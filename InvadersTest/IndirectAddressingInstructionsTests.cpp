@@ -24,6 +24,8 @@ class IndirectAddressingInstructionsTests : public testing::Test
         const u8 STORE_ACCUMULATOR_EXTENDED_DE_OPCODE = 0x12;
         const u8 LOAD_ACCUMULATOR_EXTENDED_BC_OPCODE = 0x0A;
         const u8 LOAD_ACCUMULATOR_EXTENDED_DE_OPCODE = 0x1A;
+        const u8 STORE_HL_DIRECT_OPCODE = 0x22;
+        const u8 LOAD_HL_DIRECT_OPCODE = 0x2A;
 };
 
 TEST_F(IndirectAddressingInstructionsTests, testStoreAccumulatorBc)
@@ -102,4 +104,42 @@ TEST_F(IndirectAddressingInstructionsTests, testLoadAccumulatorDe)
     testedCpu->executeInstruction(LOAD_ACCUMULATOR_EXTENDED_DE_OPCODE);
 
     EXPECT_EQ(VALUE, a);
-}
\ No newline at end of file
+}
+
+TEST_F(IndirectAddressingInstructionsTests, testStoreHlDirect)
+{
+    const auto ADDR = 0x2400;
+
+    auto& regs = testedCpu->getRegisters();
+    regs.getPc() = 0x0100;
+    regs.getHl() = 0x1234;
+
+    EXPECT_CALL(*bus, readFromMemory(Eq(0x0100))).WillOnce(Return(ADDR & 0xFF));
+    EXPECT_CALL(*bus, readFromMemory(Eq(0x0101))).WillOnce(Return(ADDR >> 8));
+    EXPECT_CALL(*bus, writeIntoMemory(Eq(ADDR), Eq(0x34)))
+        .Times(1);
+    EXPECT_CALL(*bus, writeIntoMemory(Eq(ADDR + 1), Eq(0x12)))
+        .Times(1);
+
+    testedCpu->executeInstruction(STORE_HL_DIRECT_OPCODE);
+
+    EXPECT_EQ(0x0102, regs.getPc());
+}
+
+TEST_F(IndirectAddressingInstructionsTests, testLoadHlDirect)
+{
+    const auto ADDR = 0x2400;
+
+    auto& regs = testedCpu->getRegisters();
+    regs.getPc() = 0x0100;
+    regs.getHl() = 0;
+
+    EXPECT_CALL(*bus, readFromMemory(Eq(0x0100))).WillOnce(Return(ADDR & 0xFF));
+    EXPECT_CALL(*bus, readFromMemory(Eq(0x0101))).WillOnce(Return(ADDR >> 8));
+    EXPECT_CALL(*bus, readFromMemory(Eq(ADDR))).WillOnce(Return(0x34));
+    EXPECT_CALL(*bus, readFromMemory(Eq(ADDR + 1))).WillOnce(Return(0x12));
+
+    testedCpu->executeInstruction(LOAD_HL_DIRECT_OPCODE);
+
+    EXPECT_EQ(0x1234, regs.getHl().getRaw());
+}
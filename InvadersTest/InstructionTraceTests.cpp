@@ -0,0 +1,124 @@
+#include <sstream>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "mocks/MemoryBusTest.hpp"
+
+#include "..//Invaders/CpuImpl.hpp"
+#include "..//Invaders/InstructionTrace.hpp"
+
+class InstructionTraceTests : public MemoryBusTest
+{
+    protected:
+        void SetUp() override
+        {
+            MemoryBusTest::SetUp();
+            cpu = std::make_unique<CpuImpl>(bus);
+        }
+
+        std::unique_ptr<CpuImpl> cpu;
+};
+
+TEST_F(InstructionTraceTests, testRingBufferKeepsLastRecords)
+{
+    InstructionTrace trace(5);
+    EXPECT_EQ(8, trace.getCapacity());
+
+    for (u16 i = 0; i < 10; i++)
+    {
+        TraceRecord record = {};
+        record.pc = i;
+        trace.record(record, i * 10);
+    }
+
+    EXPECT_EQ(8, trace.getRecordCount());
+    EXPECT_EQ(10, trace.getTotalRecordCount());
+    const auto records = trace.getRecords();
+    ASSERT_EQ(8, records.size());
+    EXPECT_EQ(2, records.front().pc);
+    EXPECT_EQ(9, records.back().pc);
+
+    trace.clear();
+    EXPECT_EQ(0, trace.getRecordCount());
+}
+
+TEST_F(InstructionTraceTests, testCpuRecordsStateBeforeInstruction)
+{
+    loadProgram(0x0000, { 0x3E, 0x12,           // MVI A,12H
+                          0x31, 0x00, 0x24,     // LXI SP,2400H
+                          0xCD, 0x10, 0x00 });  // CALL 0010H
+    loadProgram(0x0010, { 0x76 });              // HLT
+
+    InstructionTrace trace;
+    cpu->setTrace(&trace);
+    cpu->run(100);
+
+    const auto records = trace.getRecords();
+    ASSERT_EQ(4, records.size());
+    EXPECT_EQ(0x0000, records[0].pc);
+    EXPECT_EQ(0x3E, records[0].opcode);
+    EXPECT_EQ(0x12, records[0].operand[0]);
+    EXPECT_EQ(0x00, records[0].a);
+    EXPECT_EQ(0x12, records[1].a);
+    EXPECT_EQ(7, records[1].cycles);
+    EXPECT_EQ(0x0005, records[2].pc);
+    EXPECT_EQ(0x0010, records[2].operand[0] | (records[2].operand[1] << 8));
+    EXPECT_EQ(0x2400, records[2].sp);
+    EXPECT_EQ(0x0010, records[3].pc);
+    EXPECT_EQ(0x23FE, records[3].sp);
+    EXPECT_EQ(TraceRecordKind::INSTRUCTION, records[3].kind);
+
+    cpu->setTrace(nullptr);
+    cpu->getRegisters().getPc() = 0x0000;
+    cpu->run(100);
+    EXPECT_EQ(4, trace.getTotalRecordCount());
+}
+
+TEST_F(InstructionTraceTests, testInterruptIsRecorded)
+{
+    loadProgram(0x0000, { 0xFB,                 // EI
+                          0xC3, 0x01, 0x00 });  // JMP 0001H
+
+    InstructionTrace trace;
+    cpu->setTrace(&trace);
+    cpu->run(20);
+    cpu->requestInterrupt(1);
+    cpu->run(1);
+
+    const auto interrupt = trace.getRecords().back();
+    EXPECT_EQ(TraceRecordKind::INTERRUPT, interrupt.kind);
+    EXPECT_EQ(0xCF, interrupt.opcode);
+    EXPECT_EQ(0x0001, interrupt.pc);
+
+    cpu->run(1);
+    EXPECT_EQ(0x0008, trace.getRecords().back().pc);
+}
+
+TEST_F(InstructionTraceTests, testTraceIsWrittenAndRead)
+{
+    InstructionTrace trace(4);
+    // Low bits of cycle counter wrap between records
+    const u64 cycles[] = { 0xFFFFFFF0ull, 0xFFFFFFFAull, 0x100000004ull, 0x100000010ull, 0x100000020ull };
+    for (auto cycle : cycles)
+    {
+        TraceRecord record = {};
+        record.cycles = static_cast<u32>(cycle);
+        record.opcode = 0x00;
+        trace.record(record, cycle);
+    }
+
+    std::stringstream file;
+    trace.write(file);
+
+    TraceFileHeader header;
+    std::vector<TraceRecord> records;
+    ASSERT_TRUE(InstructionTrace::read(file, header, records));
+    EXPECT_EQ(4, header.recordCount);
+    EXPECT_EQ(0xFFFFFFFAull, header.firstCycles);
+    ASSERT_EQ(4, records.size());
+    EXPECT_EQ(0x00000020u, records.back().cycles);
+
+    std::stringstream invalid("not a trace file, but long enough for header");
+    EXPECT_FALSE(InstructionTrace::read(invalid, header, records));
+}
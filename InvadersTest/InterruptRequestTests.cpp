@@ -0,0 +1,164 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "mocks/MemoryBusTest.hpp"
+
+#include "..//Invaders/BlockCacheCpuImpl.hpp"
+#include "..//Invaders/CpuImpl.hpp"
+
+class InterruptRequestTests : public MemoryBusTest
+{
+    protected:
+        void SetUp() override
+        {
+            MemoryBusTest::SetUp();
+            testedCpu = std::make_unique<CpuImpl>(bus);
+
+            testedCpu->getRegisters().getSp() = 0x2400;
+        }
+
+        u16 readStack(u16 addr)
+        {
+            return memory[addr] | (memory[addr + 1] << 8);
+        }
+
+        std::unique_ptr<CpuImpl> testedCpu;
+
+        const u8 ENABLE_INTERRUPTS_OPCODE = 0xFB;
+        const u8 RESTART_2_OPCODE = 0xD7;
+};
+
+TEST_F(InterruptRequestTests, testRestartPushesReturnAddress)
+{
+    testedCpu->getRegisters().getPc() = 0x1234;
+
+    testedCpu->executeInstruction(RESTART_2_OPCODE);
+
+    EXPECT_EQ(0x0010, testedCpu->getRegisters().getPc());
+    EXPECT_EQ(0x23FE, testedCpu->getRegisters().getSp());
+    EXPECT_EQ(0x12, memory[0x23FF]);
+    EXPECT_EQ(0x34, memory[0x23FE]);
+}
+
+TEST_F(InterruptRequestTests, testInterruptIsTakenAtStartOfBatch)
+{
+    testedCpu->executeInstruction(ENABLE_INTERRUPTS_OPCODE);
+    testedCpu->getRegisters().getPc() = 0x1234;
+
+    testedCpu->requestInterrupt(2);
+    EXPECT_TRUE(testedCpu->isInterruptPending());
+
+    // RST takes 11 cycles
+    EXPECT_EQ(0, testedCpu->run(11));
+
+    EXPECT_FALSE(testedCpu->isInterruptPending());
+    EXPECT_FALSE(testedCpu->interruptsEnabled());
+    EXPECT_EQ(0x0010, testedCpu->getRegisters().getPc());
+    EXPECT_EQ(0x1234, readStack(testedCpu->getRegisters().getSp()));
+}
+
+TEST_F(InterruptRequestTests, testInterruptIsLatchedUntilEnabled)
+{
+    // 0000: NOP; NOP; EI; NOP; NOP
+    // 0008: EI; RET
+    loadProgram(0x0000, { 0x00, 0x00, 0xFB, 0x00, 0x00 });
+    loadProgram(0x0008, { 0xFB, 0xC9 });
+
+    testedCpu->requestInterrupt(1);
+    testedCpu->run(8);
+    EXPECT_TRUE(testedCpu->isInterruptPending());
+    EXPECT_EQ(0x0002, testedCpu->getRegisters().getPc());
+
+    // EI, NOP after it, then RST 1 and handler returning to second NOP
+    EXPECT_EQ(0, testedCpu->run(4 + 4 + 11 + 4 + 10));
+
+    EXPECT_FALSE(testedCpu->isInterruptPending());
+    EXPECT_TRUE(testedCpu->interruptsEnabled());
+    EXPECT_EQ(0x0004, testedCpu->getRegisters().getPc());
+    EXPECT_EQ(0x2400, testedCpu->getRegisters().getSp());
+    EXPECT_EQ(0x0004, readStack(0x23FE));
+}
+
+TEST_F(InterruptRequestTests, testInterruptWakesHaltedCpu)
+{
+    // 0000: EI; HLT
+    loadProgram(0x0000, { 0xFB, 0x76 });
+
+    testedCpu->run(100);
+    EXPECT_TRUE(testedCpu->isHalted());
+
+    testedCpu->requestInterrupt(7);
+    testedCpu->run(100);
+
+    EXPECT_FALSE(testedCpu->isHalted());
+    EXPECT_EQ(0x0002, readStack(0x23FE));
+    // Rest of batch after RST 7 is filled with NOPs, last one overruns it
+    EXPECT_EQ(0x0038 + 23, testedCpu->getRegisters().getPc());
+}
+
+TEST_F(InterruptRequestTests, testHaltedCpuWithInterruptsDisabledKeepsWaiting)
+{
+    // 0000: HLT
+    loadProgram(0x0000, { 0x76 });
+
+    testedCpu->run(100);
+    testedCpu->requestInterrupt(1);
+    testedCpu->run(100);
+
+    EXPECT_TRUE(testedCpu->isHalted());
+    EXPECT_TRUE(testedCpu->isInterruptPending());
+    EXPECT_EQ(0x2400, testedCpu->getRegisters().getSp());
+}
+
+TEST_F(InterruptRequestTests, testInterruptPushInvalidatesCachedBlocks)
+{
+    auto cachedCpu = std::make_unique<BlockCacheCpuImpl>(bus);
+    // 0000: LXI SP,2002; EI; JMP 2000
+    // 2000: MVI A,01; JMP 2000
+    // 0028: EI; JMP 0000
+    loadProgram(0x0000, { 0x31, 0x02, 0x20, 0xFB, 0xC3, 0x00, 0x20 });
+    loadProgram(0x2000, { 0x3E, 0x01, 0xC3, 0x00, 0x20 });
+    loadProgram(0x0028, { 0xFB, 0xC3, 0x00, 0x00 });
+
+    cachedCpu->run(100);
+    EXPECT_EQ(0x01, cachedCpu->getRegisters().getAf().getHigh());
+
+    // Pushed return address 053E replaces MVI A,01 with MVI A,05
+    cachedCpu->getRegisters().getPc() = 0x053E;
+    cachedCpu->requestInterrupt(5);
+    cachedCpu->run(100);
+
+    EXPECT_EQ(0x05, cachedCpu->getRegisters().getAf().getHigh());
+    EXPECT_GE(cachedCpu->getBlockCacheStats().invalidations, 1);
+}
+
+TEST_F(InterruptRequestTests, testInstructionAfterEiRunsWhenBatchEndsOnEi)
+{
+    // 0000: EI; NOP; NOP
+    loadProgram(0x0000, { 0xFB, 0x00, 0x00 });
+
+    testedCpu->run(1);
+    testedCpu->requestInterrupt(1);
+    testedCpu->run(1);
+
+    // NOP following EI is executed before interrupt is taken
+    EXPECT_EQ(0x0008, testedCpu->getRegisters().getPc());
+    EXPECT_EQ(0x0002, readStack(testedCpu->getRegisters().getSp()));
+}
+
+TEST_F(InterruptRequestTests, testInterruptIsNotDelayedByEarlierEi)
+{
+    // 0000: EI; NOP; JMP 0001
+    loadProgram(0x0000, { 0xFB, 0x00, 0xC3, 0x01, 0x00 });
+
+    // Batch ends on EI, then NOP and JMP back to address following EI
+    testedCpu->run(4);
+    testedCpu->run(14);
+    EXPECT_EQ(0x0001, testedCpu->getRegisters().getPc());
+
+    testedCpu->requestInterrupt(1);
+    testedCpu->run(1);
+
+    EXPECT_EQ(0x0008, testedCpu->getRegisters().getPc());
+    EXPECT_EQ(0x0001, readStack(testedCpu->getRegisters().getSp()));
+}
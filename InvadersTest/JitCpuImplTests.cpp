@@ -0,0 +1,199 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "mocks/MemoryBusTest.hpp"
+
+#include "..//Invaders/CpuImpl.hpp"
+#include "..//Invaders/JitCpuImpl.hpp"
+
+using testing::_;
+using testing::Invoke;
+using testing::NiceMock;
+
+class JitCpuImplTests : public testing::TestWithParam<int>
+{
+    protected:
+        void SetUp() override
+        {
+            fillMemory(interpreterMemory);
+            fillMemory(jitMemory);
+            interpreterBus = makeMemoryBus(interpreterMemory);
+            jitBus = makeMemoryBus(jitMemory);
+            mockInputPorts(*interpreterBus);
+            mockInputPorts(*jitBus);
+
+            interpreterCpu = std::make_unique<CpuImpl>(interpreterBus);
+            jitCpu = std::make_unique<JitCpuImpl>(jitBus);
+            initRegisters(interpreterCpu->getRegisters());
+            initRegisters(jitCpu->getRegisters());
+        }
+
+        // Fills memory with pseudo-random pattern
+        void fillMemory(std::array<u8, 0x10000>& memory)
+        {
+            for (unsigned addr = 0; addr < memory.size(); addr++)
+                memory[addr] = static_cast<u8>(addr * 7 + (addr >> 8));
+        }
+
+        void mockInputPorts(BusMock& bus)
+        {
+            ON_CALL(bus, readFromInputPort(_))
+                .WillByDefault(Invoke([](u8 port) { return static_cast<u8>(port ^ 0x5A); }));
+        }
+
+        void initRegisters(Registers& regs)
+        {
+            regs.getAf() = 0x9BD7;
+            regs.getBc() = 0x1234;
+            regs.getDe() = 0x3456;
+            regs.getHl() = 0x2468;
+            regs.getSp() = 0x2400;
+            regs.getPc() = 0x0100;
+        }
+
+        void loadProgram(u16 addr, std::initializer_list<u8> bytes)
+        {
+            for (auto byte : bytes)
+            {
+                interpreterMemory[addr] = byte;
+                jitMemory[addr] = byte;
+                addr++;
+            }
+        }
+
+        void expectSameState()
+        {
+            auto& expected = interpreterCpu->getRegisters();
+            auto& actual = jitCpu->getRegisters();
+
+            EXPECT_EQ(interpreterCpu->getCycles(), jitCpu->getCycles());
+            EXPECT_EQ(expected.getAf().getRaw(), actual.getAf().getRaw());
+            EXPECT_EQ(expected.getBc().getRaw(), actual.getBc().getRaw());
+            EXPECT_EQ(expected.getDe().getRaw(), actual.getDe().getRaw());
+            EXPECT_EQ(expected.getHl().getRaw(), actual.getHl().getRaw());
+            EXPECT_EQ(expected.getSp(), actual.getSp());
+            EXPECT_EQ(expected.getPc(), actual.getPc());
+            EXPECT_EQ(interpreterCpu->isHalted(), jitCpu->isHalted());
+            EXPECT_TRUE(interpreterMemory == jitMemory);
+        }
+
+        std::unique_ptr<CpuImpl> interpreterCpu;
+        std::unique_ptr<JitCpuImpl> jitCpu;
+        std::shared_ptr<NiceMock<BusMock>> interpreterBus;
+        std::shared_ptr<NiceMock<BusMock>> jitBus;
+        std::array<u8, 0x10000> interpreterMemory;
+        std::array<u8, 0x10000> jitMemory;
+};
+
+TEST_P(JitCpuImplTests, testTranslatedCodeMatchesInterpreter)
+{
+    // Block starting with given opcode, followed by whatever pattern in memory decodes to
+    loadProgram(0x0100, { static_cast<u8>(GetParam()) });
+
+    for (auto budget : { 30u, 2000u, 5000u })
+    {
+        EXPECT_EQ(interpreterCpu->run(budget), jitCpu->run(budget));
+        expectSameState();
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(AllOpcodes, JitCpuImplTests, testing::Range(0, 256));
+
+TEST_F(JitCpuImplTests, testLoopRunsInNativeCode)
+{
+    if (!JitCpuImpl::isJitSupported())
+        GTEST_SKIP();
+
+    // MVI B,40; loop: MOV A,B; ADD C; RAL; MOV C,A; DCR B; JNZ loop; HLT
+    loadProgram(0x0100, { 0x06, 0x40, 0x78, 0x81, 0x17, 0x4F, 0x05, 0xC2, 0x02, 0x01, 0x76 });
+
+    EXPECT_EQ(interpreterCpu->run(10000), jitCpu->run(10000));
+    expectSameState();
+
+    const auto& stats = jitCpu->getJitStats();
+    EXPECT_TRUE(jitCpu->isHalted());
+    EXPECT_EQ(3, stats.translatedBlocks);
+    EXPECT_GT(stats.nativeEntries, 0);
+    EXPECT_EQ(1, stats.fallbackInstructions);
+    EXPECT_EQ(0, stats.interpretedInstructions);
+}
+
+TEST_F(JitCpuImplTests, testWriteIntoTranslatedBlockInvalidatesIt)
+{
+    if (!JitCpuImpl::isJitSupported())
+        GTEST_SKIP();
+
+    // 0100: JMP 2000
+    // 0103: INR A; STA 2001; MVI B,FF; JMP 2000
+    // 2000: MVI A,01; INR B; JNZ 0103; HLT
+    loadProgram(0x0100, { 0xC3, 0x00, 0x20, 0x3C, 0x32, 0x01, 0x20, 0x06, 0xFF, 0xC3, 0x00, 0x20 });
+    loadProgram(0x2000, { 0x3E, 0x01, 0x04, 0xC2, 0x03, 0x01, 0x76 });
+    interpreterCpu->getRegisters().getBc() = 0;
+    jitCpu->getRegisters().getBc() = 0;
+
+    EXPECT_EQ(interpreterCpu->run(1000), jitCpu->run(1000));
+    expectSameState();
+
+    EXPECT_TRUE(jitCpu->isHalted());
+    EXPECT_EQ(0x02, jitCpu->getRegisters().getAf().getHigh());
+    EXPECT_EQ(1, jitCpu->getJitStats().invalidations);
+}
+
+TEST_F(JitCpuImplTests, testInputOutputIsInterpreted)
+{
+    // IN 10; OUT 20; IN 30; HLT
+    loadProgram(0x0100, { 0xDB, 0x10, 0xD3, 0x20, 0xDB, 0x30, 0x76 });
+
+    EXPECT_CALL(*jitBus, writeIntoOutputPort(0x20, 0x10 ^ 0x5A)).Times(1);
+
+    jitCpu->run(1000);
+
+    EXPECT_TRUE(jitCpu->isHalted());
+    EXPECT_EQ(0x30 ^ 0x5A, jitCpu->getRegisters().getAf().getHigh());
+    EXPECT_EQ(3, jitCpu->getJitStats().interpretedInstructions);
+}
+
+TEST_F(JitCpuImplTests, testKillSwitchFallsBackToInterpreter)
+{
+    // loop: INR A; JMP loop
+    loadProgram(0x0100, { 0x3C, 0xC3, 0x00, 0x01 });
+    jitCpu->setJitEnabled(false);
+
+    EXPECT_EQ(interpreterCpu->run(5000), jitCpu->run(5000));
+    expectSameState();
+
+    EXPECT_FALSE(jitCpu->isJitEnabled());
+    EXPECT_EQ(0, jitCpu->getJitStats().nativeEntries);
+    EXPECT_EQ(0, jitCpu->getCachedBlockCount());
+
+    jitCpu->setJitEnabled(true);
+    EXPECT_EQ(interpreterCpu->run(5000), jitCpu->run(5000));
+    expectSameState();
+}
+
+TEST_F(JitCpuImplTests, testBlocksWrittenWhileDisabledAreNotRun)
+{
+    if (!JitCpuImpl::isJitSupported())
+        GTEST_SKIP();
+
+    // 0100: MVI A,01; JMP 0100
+    loadProgram(0x0100, { 0x3E, 0x01, 0xC3, 0x00, 0x01 });
+    jitCpu->run(170);
+    EXPECT_EQ(1, jitCpu->getJitStats().translatedBlocks);
+    EXPECT_EQ(0x01, jitCpu->getRegisters().getAf().getHigh());
+
+    // 0200: MVI A,02; STA 0101; JMP 0100
+    loadProgram(0x0200, { 0x3E, 0x02, 0x32, 0x01, 0x01, 0xC3, 0x00, 0x01 });
+    jitCpu->getRegisters().getPc() = 0x0200;
+    jitCpu->setJitEnabled(false);
+    jitCpu->run(30);
+    EXPECT_EQ(0x0100, jitCpu->getRegisters().getPc());
+    EXPECT_EQ(0x02, jitMemory[0x0101]);
+
+    // Block translated before the write is not run
+    jitCpu->setJitEnabled(true);
+    jitCpu->getRegisters().getAf().getHigh() = 0;
+    jitCpu->run(17);
+    EXPECT_EQ(0x02, jitCpu->getRegisters().getAf().getHigh());
+    EXPECT_EQ(2, jitCpu->getJitStats().translatedBlocks);
+}
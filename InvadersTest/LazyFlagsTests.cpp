@@ -0,0 +1,108 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "mocks/MemoryBusTest.hpp"
+
+#include "..//Invaders/CpuImpl.hpp"
+
+using testing::Eq;
+
+class LazyFlagsTests : public MemoryBusTest
+{
+    protected:
+        void SetUp() override
+        {
+            MemoryBusTest::SetUp();
+            testedCpu = std::make_unique<CpuImpl>(bus, DispatchMode::TABLE);
+            testedCpu->setLazyFlagsEnabled(true);
+        }
+
+        std::unique_ptr<CpuImpl> testedCpu;
+
+        const u8 ADD_B_OPCODE = 0x80;
+        const u8 INCREMENT_A_OPCODE = 0x3C;
+        const u8 DECREMENT_B_OPCODE = 0x05;
+        const u8 JUMP_NOT_ZERO_OPCODE = 0xC2;
+        const u8 PUSH_PSW_OPCODE = 0xF5;
+};
+
+TEST_F(LazyFlagsTests, testFlagsMaterializedOnRegistersInspection)
+{
+    auto& regs = testedCpu->getRegisters();
+    regs.getAf().getHigh() = 0x2E;
+    regs.getAf().getLow().raw = 0x02;
+    regs.getBc().getHigh() = 0x6C;
+
+    testedCpu->executeInstruction(ADD_B_OPCODE);
+    testedCpu->executeInstruction(INCREMENT_A_OPCODE);
+
+    auto& flags = testedCpu->getRegisters().getAf().getLow();
+    EXPECT_EQ(0x9B, testedCpu->getRegisters().getAf().getHigh());
+    EXPECT_EQ(1, flags.S);
+    EXPECT_EQ(0, flags.Z);
+    EXPECT_EQ(0, flags.AC);
+    EXPECT_EQ(0, flags.P);
+    EXPECT_EQ(0, flags.C);
+}
+
+TEST_F(LazyFlagsTests, testConditionalJumpReadsDeferredZero)
+{
+    auto& regs = testedCpu->getRegisters();
+    regs.getBc().getHigh() = 0x01;
+    regs.getPc() = 0x0101;
+    memory[0x0101] = 0x00;
+    memory[0x0102] = 0x30;
+
+    testedCpu->executeInstruction(DECREMENT_B_OPCODE);
+    testedCpu->executeInstruction(JUMP_NOT_ZERO_OPCODE);
+
+    EXPECT_EQ(0x0103, testedCpu->getRegisters().getPc());
+}
+
+TEST_F(LazyFlagsTests, testPushPswWritesMaterializedFlags)
+{
+    auto& regs = testedCpu->getRegisters();
+    regs.getAf() = 0xFF02;
+    regs.getSp() = 0x2400;
+
+    testedCpu->executeInstruction(INCREMENT_A_OPCODE);
+
+    EXPECT_CALL(*bus, writeIntoMemory(Eq(0x23FF), Eq(0x00))).Times(1);
+    EXPECT_CALL(*bus, writeIntoMemory(Eq(0x23FE), Eq(0x56))).Times(1);
+
+    testedCpu->executeInstruction(PUSH_PSW_OPCODE);
+}
+
+TEST_F(LazyFlagsTests, testMatchesEagerFlags)
+{
+    // Pseudo-random code, compared against cpu computing flags eagerly
+    for (unsigned addr = 0; addr < memory.size(); addr++)
+        memory[addr] = static_cast<u8>((addr * 0x9E37) >> 5);
+
+    std::array<u8, 0x10000> eagerMemory = memory;
+    auto eagerBus = makeMemoryBus(eagerMemory);
+    CpuImpl eagerCpu(eagerBus, DispatchMode::TABLE);
+
+    for (auto* regs : { &testedCpu->getRegisters(), &eagerCpu.getRegisters() })
+    {
+        regs->getPc() = 0x1000;
+        regs->getSp() = 0x8000;
+    }
+
+    for (auto i = 0; i < 5000 && !eagerCpu.isHalted(); i++)
+    {
+        eagerCpu.executeInstruction(eagerCpu.fetchOpcode());
+        testedCpu->executeInstruction(testedCpu->fetchOpcode());
+    }
+
+    auto& expected = eagerCpu.getRegisters();
+    auto& actual = testedCpu->getRegisters();
+
+    EXPECT_EQ(expected.getAf().getRaw(), actual.getAf().getRaw());
+    EXPECT_EQ(expected.getBc().getRaw(), actual.getBc().getRaw());
+    EXPECT_EQ(expected.getDe().getRaw(), actual.getDe().getRaw());
+    EXPECT_EQ(expected.getHl().getRaw(), actual.getHl().getRaw());
+    EXPECT_EQ(expected.getSp(), actual.getSp());
+    EXPECT_EQ(expected.getPc(), actual.getPc());
+    EXPECT_TRUE(eagerMemory == memory);
+}
@@ -0,0 +1,131 @@
+#include <sstream>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "..//Invaders/BlockCacheCpuImpl.hpp"
+#include "..//Invaders/BusImpl.hpp"
+#include "..//Invaders/CpuImpl.hpp"
+#include "..//Invaders/JitCpuImpl.hpp"
+#include "..//Invaders/LockstepExecutor.hpp"
+#include "..//Invaders/ThreadedCpuImpl.hpp"
+#include "..//Invaders/TieredCpuImpl.hpp"
+
+namespace
+{
+    template <typename TCpu>
+    std::unique_ptr<Cpu> createCpu(const std::shared_ptr<Bus>& bus)
+    {
+        return std::make_unique<TCpu>(bus);
+    }
+}
+
+class LockstepExecutorTests : public testing::Test
+{
+    protected:
+        void SetUp() override
+        {
+            referenceBus = std::make_shared<BusImpl>();
+            testedBus = std::make_shared<BusImpl>();
+        }
+
+        void loadProgram(u16 addr, const std::vector<u8>& bytes)
+        {
+            referenceBus->loadIntoMemory(addr, bytes);
+            testedBus->loadIntoMemory(addr, bytes);
+        }
+
+        std::unique_ptr<LockstepExecutor> createExecutor(const CpuFactory& testedFactory)
+        {
+            auto executor = std::make_unique<LockstepExecutor>(referenceBus, createCpu<CpuImpl>, testedBus, testedFactory);
+            executor->getReferenceCpu().getRegisters().getSp() = 0x2400;
+            executor->getTestedCpu().getRegisters().getSp() = 0x2400;
+            return executor;
+        }
+
+        std::string getReport(const LockstepExecutor& executor)
+        {
+            std::ostringstream report;
+            executor.writeDivergenceReport(report);
+            return report.str();
+        }
+
+        std::shared_ptr<BusImpl> referenceBus;
+        std::shared_ptr<BusImpl> testedBus;
+};
+
+TEST_F(LockstepExecutorTests, testEquivalentCpusDoNotDiverge)
+{
+    // LXI H,2400; MVI B,20; loop: MOV A,B; ADD M; MOV M,A; INX H; PUSH PSW; POP PSW; DCR B; JNZ loop; OUT 03; JMP 0000
+    loadProgram(0x0000, { 0x21, 0x00, 0x24, 0x06, 0x20, 0x78, 0x86, 0x77, 0x23, 0xF5, 0xF1, 0x05, 0xC2, 0x05, 0x00, 0xD3, 0x03, 0xC3, 0x00, 0x00 });
+
+    for (auto interval : { 1u, 7u, 1000u })
+    {
+        for (const CpuFactory& factory : { CpuFactory(createCpu<ThreadedCpuImpl>), CpuFactory(createCpu<BlockCacheCpuImpl>),
+                                           CpuFactory(createCpu<TieredCpuImpl>), CpuFactory(createCpu<JitCpuImpl>) })
+        {
+            auto executor = createExecutor(factory);
+            executor->setCheckInterval(interval);
+
+            EXPECT_TRUE(executor->run(20000));
+
+            EXPECT_FALSE(executor->hasDiverged());
+            EXPECT_TRUE(getReport(*executor).empty());
+            EXPECT_GE(executor->getComparisonCount(), executor->getInstructionCount() / interval);
+        }
+    }
+}
+
+TEST_F(LockstepExecutorTests, testInterruptsAreDeliveredToBothCpus)
+{
+    // 0000: LXI SP,2400; EI; loop: INR B; JMP loop
+    // 0010: PUSH PSW; INR C; MOV A,C; STA 2000; POP PSW; EI; RET
+    loadProgram(0x0000, { 0x31, 0x00, 0x24, 0xFB, 0x04, 0xC3, 0x04, 0x00 });
+    loadProgram(0x0010, { 0xF5, 0x0C, 0x79, 0x32, 0x00, 0x20, 0xF1, 0xFB, 0xC9 });
+    auto executor = createExecutor(createCpu<BlockCacheCpuImpl>);
+    executor->setCheckInterval(5);
+
+    for (int frame = 0; frame < 50; frame++)
+    {
+        EXPECT_TRUE(executor->run(997));
+        executor->requestInterrupt(2);
+    }
+
+    EXPECT_EQ(49, executor->getTestedCpu().getRegisters().getBc().getLow());
+    EXPECT_EQ(49, testedBus->readFromMemory(0x2000));
+}
+
+TEST_F(LockstepExecutorTests, testRegisterDivergenceIsReported)
+{
+    // MVI B,10; INR B; HLT
+    loadProgram(0x0000, { 0x06, 0x10, 0x04, 0x76 });
+    testedBus->loadIntoMemory(0x0001, { 0x11 });
+    auto executor = createExecutor(createCpu<BlockCacheCpuImpl>);
+    executor->setCheckInterval(1);
+
+    EXPECT_FALSE(executor->run(100));
+    EXPECT_FALSE(executor->run(100));
+
+    const auto report = getReport(*executor);
+    EXPECT_TRUE(executor->hasDiverged());
+    EXPECT_EQ(1, executor->getInstructionCount());
+    EXPECT_NE(std::string::npos, report.find("BC: 1000 / 1100"));
+    EXPECT_NE(std::string::npos, report.find("0000  MVI B,10H"));
+    EXPECT_EQ(std::string::npos, report.find("PC:"));
+}
+
+TEST_F(LockstepExecutorTests, testBusWriteDivergenceIsReported)
+{
+    // MVI A,12; STA 2400; LXI H,2410; MVI M,34; OUT 05; HLT
+    loadProgram(0x0000, { 0x3E, 0x12, 0x32, 0x00, 0x24, 0x21, 0x10, 0x24, 0x36, 0x34, 0xD3, 0x05, 0x76 });
+    testedBus->loadIntoMemory(0x0003, { 0x01 });
+    testedBus->loadIntoMemory(0x0009, { 0x35 });
+    auto executor = createExecutor(createCpu<ThreadedCpuImpl>);
+
+    EXPECT_FALSE(executor->run(1000));
+
+    const auto report = getReport(*executor);
+    EXPECT_NE(std::string::npos, report.find("Write 0 of 2 / 2: 2400=12 / 2401=12"));
+    EXPECT_NE(std::string::npos, report.find("Memory 2410: 34 / 35"));
+    EXPECT_NE(std::string::npos, report.find("OUT 05H"));
+}
@@ -0,0 +1,72 @@
+#include <sstream>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "mocks/MemoryBusTest.hpp"
+
+#include "..//Invaders/CpuImpl.hpp"
+#include "..//Invaders/OpcodeStats.hpp"
+
+class OpcodeStatsTests : public MemoryBusTest
+{
+    protected:
+        OpcodeStats stats;
+};
+
+TEST_F(OpcodeStatsTests, testOpcodesAreGroupedAndSorted)
+{
+    for (int i = 0; i < 3; i++)
+        stats.record(0x3E, 7);
+    for (int i = 0; i < 5; i++)
+        stats.record(0xC3, 10);
+    stats.record(0x80, 4);
+
+    EXPECT_EQ(9, stats.getTotalExecutions());
+    EXPECT_EQ(3, stats.getGroupExecutions(0));
+    EXPECT_EQ(0, stats.getGroupExecutions(1));
+    EXPECT_EQ(1, stats.getGroupExecutions(2));
+    EXPECT_EQ(50, stats.getGroupCycles(3));
+
+    std::ostringstream text;
+    stats.writeText(text, 2);
+    EXPECT_NE(std::string::npos, text.str().find("Executed opcodes: 3 of 256"));
+    EXPECT_LT(text.str().find("C3  JMP: 5"), text.str().find("3E  MVI A: 3"));
+    EXPECT_EQ(std::string::npos, text.str().find("ADD B"));
+
+    std::ostringstream json;
+    stats.writeJson(json);
+    EXPECT_NE(std::string::npos, json.str().find("{ \"opcode\": \"C3\", \"mnemonic\": \"JMP\", \"executions\": 5, \"cycles\": 50 },"));
+    EXPECT_NE(std::string::npos, json.str().find("{ \"opcode\": \"80\", \"mnemonic\": \"ADD B\", \"executions\": 1, \"cycles\": 4 }\n"));
+
+    stats.reset();
+    EXPECT_EQ(0, stats.getTotalExecutions());
+}
+
+TEST_F(OpcodeStatsTests, testInterpreterCountsExecutedOpcodes)
+{
+    if (!OpcodeStats::ENABLED)
+    {
+        GTEST_SKIP() << "Built without OPCODE_STATS_ENABLED";
+    }
+
+    // LXI SP,2400; MVI B,03; loop: CALL sub; DCR B; JNZ loop; HLT
+    // sub: RNZ; RET
+    loadProgram(0x0000, { 0x31, 0x00, 0x24, 0x06, 0x03, 0xCD, 0x0D, 0x00, 0x05, 0xC2, 0x05, 0x00, 0x76, 0xC0, 0xC9 });
+
+    for (auto mode : { DispatchMode::TABLE, DispatchMode::DECODER })
+    {
+        CpuImpl cpu(bus, mode);
+        cpu.run(1000);
+
+        const auto& cpuStats = cpu.getOpcodeStats();
+        EXPECT_EQ(3, cpuStats.getExecutions(0xCD));
+        EXPECT_EQ(3, cpuStats.getExecutions(0xC2));
+        // B is not zero after LXI and MVI, so RNZ always returns
+        EXPECT_EQ(3 * (5 + 6), cpuStats.getCycles(0xC0));
+        EXPECT_EQ(0, cpuStats.getExecutions(0xC9));
+        EXPECT_EQ(1 + 1 + 3 * 4 + 1, cpuStats.getTotalExecutions());
+        EXPECT_EQ(cpu.getCycles() - cpu.getIdleStats().haltedCycles, cpuStats.getGroupCycles(0) + cpuStats.getGroupCycles(1)
+                  + cpuStats.getGroupCycles(2) + cpuStats.getGroupCycles(3));
+    }
+}
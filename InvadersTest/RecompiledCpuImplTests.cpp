@@ -0,0 +1,132 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "mocks/MemoryBusTest.hpp"
+
+#include "..//Invaders/CpuImpl.hpp"
+#include "..//Invaders/RecompiledCpuImpl.hpp"
+
+using testing::NiceMock;
+
+// Defined in RecompiledTestProgram.cpp, generated by Recompiler from TEST_PROGRAM
+extern const RecompiledProgram recompiledTestProgram;
+
+namespace
+{
+    // 0100: LXI SP,2400; MVI B,40
+    // 0105: CALL 0118
+    // 0108: DCR B; JNZ 0105
+    // 010C: LXI H,0114; PCHL
+    // 0114: INR A; HLT             (reached only through PCHL, so it is not translated)
+    // 0118: POP H; ADD B; RAR; MOV C,A; STA 2000; JMP 0108
+    const std::vector<u8> TEST_PROGRAM = {
+        0x31, 0x00, 0x24, 0x06, 0x40, 0xCD, 0x18, 0x01, 0x05, 0xC2, 0x05, 0x01, 0x21, 0x14, 0x01, 0xE9,
+        0x00, 0x00, 0x00, 0x00, 0x3C, 0x76, 0x00, 0x00,
+        0xE1, 0x80, 0x1F, 0x4F, 0x32, 0x00, 0x20, 0xC3, 0x08, 0x01
+    };
+}
+
+class RecompiledCpuImplTests : public testing::Test
+{
+    protected:
+        void SetUp() override
+        {
+            loadTestProgram(interpreterMemory);
+            loadTestProgram(recompiledMemory);
+            interpreterBus = makeMemoryBus(interpreterMemory);
+            recompiledBus = makeMemoryBus(recompiledMemory);
+
+            interpreterCpu = std::make_unique<CpuImpl>(interpreterBus);
+            recompiledCpu = std::make_unique<RecompiledCpuImpl>(recompiledBus, recompiledTestProgram);
+            interpreterCpu->getRegisters().getPc() = 0x0100;
+            recompiledCpu->getRegisters().getPc() = 0x0100;
+        }
+
+        void loadTestProgram(std::array<u8, 0x10000>& memory)
+        {
+            memory.fill(0);
+            std::copy(TEST_PROGRAM.begin(), TEST_PROGRAM.end(), memory.begin() + 0x0100);
+        }
+
+        void expectSameState()
+        {
+            auto& expected = interpreterCpu->getRegisters();
+            auto& actual = recompiledCpu->getRegisters();
+
+            EXPECT_EQ(interpreterCpu->getCycles(), recompiledCpu->getCycles());
+            EXPECT_EQ(expected.getAf().getRaw(), actual.getAf().getRaw());
+            EXPECT_EQ(expected.getBc().getRaw(), actual.getBc().getRaw());
+            EXPECT_EQ(expected.getDe().getRaw(), actual.getDe().getRaw());
+            EXPECT_EQ(expected.getHl().getRaw(), actual.getHl().getRaw());
+            EXPECT_EQ(expected.getSp(), actual.getSp());
+            EXPECT_EQ(expected.getPc(), actual.getPc());
+            EXPECT_EQ(interpreterCpu->isHalted(), recompiledCpu->isHalted());
+            EXPECT_TRUE(interpreterMemory == recompiledMemory);
+        }
+
+        std::unique_ptr<CpuImpl> interpreterCpu;
+        std::unique_ptr<RecompiledCpuImpl> recompiledCpu;
+        std::shared_ptr<NiceMock<BusMock>> interpreterBus;
+        std::shared_ptr<NiceMock<BusMock>> recompiledBus;
+        std::array<u8, 0x10000> interpreterMemory;
+        std::array<u8, 0x10000> recompiledMemory;
+};
+
+TEST_F(RecompiledCpuImplTests, testGeneratedProgramMatchesMemory)
+{
+    EXPECT_TRUE(recompiledCpu->matchesMemory());
+
+    recompiledMemory[0x0110] = 0xFF;
+
+    EXPECT_FALSE(recompiledCpu->matchesMemory());
+}
+
+TEST_F(RecompiledCpuImplTests, testChecksumOfProgramImage)
+{
+    EXPECT_EQ(recompiledTestProgram.checksum, RecompiledCpuImpl::computeChecksum(TEST_PROGRAM.data(), TEST_PROGRAM.size()));
+}
+
+TEST_F(RecompiledCpuImplTests, testRecompiledCodeMatchesInterpreter)
+{
+    EXPECT_EQ(interpreterCpu->run(100000), recompiledCpu->run(100000));
+    expectSameState();
+
+    const auto& stats = recompiledCpu->getRecompiledStats();
+    EXPECT_TRUE(recompiledCpu->isHalted());
+    EXPECT_GT(stats.routineEntries, 0);
+    // INR A and HLT, reached through PCHL
+    EXPECT_EQ(2, stats.interpretedInstructions);
+}
+
+TEST_F(RecompiledCpuImplTests, testBatchesEndOnSameInstructionAsInterpreter)
+{
+    for (auto budget : { 7u, 100u, 33u, 1u, 250u, 10000u })
+    {
+        EXPECT_EQ(interpreterCpu->run(budget), recompiledCpu->run(budget));
+        expectSameState();
+    }
+}
+
+TEST_F(RecompiledCpuImplTests, testKillSwitchFallsBackToInterpreter)
+{
+    recompiledCpu->setRecompiledCodeEnabled(false);
+
+    EXPECT_EQ(interpreterCpu->run(100000), recompiledCpu->run(100000));
+    expectSameState();
+
+    EXPECT_FALSE(recompiledCpu->isRecompiledCodeEnabled());
+    EXPECT_EQ(0, recompiledCpu->getRecompiledStats().routineEntries);
+}
+
+TEST_F(RecompiledCpuImplTests, testProgramOfDifferentMemoryIsNotRun)
+{
+    // MVI B,40 becomes MVI B,20
+    interpreterMemory[0x0104] = 0x20;
+    recompiledMemory[0x0104] = 0x20;
+
+    EXPECT_EQ(interpreterCpu->run(100000), recompiledCpu->run(100000));
+    expectSameState();
+
+    EXPECT_FALSE(recompiledCpu->isRecompiledCodeEnabled());
+    EXPECT_EQ(0, recompiledCpu->getRecompiledStats().routineEntries);
+}
@@ -0,0 +1,100 @@
+// Generated by Recompiler from 0x0100-0x0121, do not edit.
+// Declare with: extern const RecompiledProgram recompiledTestProgram;
+
+#include "..//Invaders/RecompiledCpuImpl.hpp"
+
+namespace
+{
+    void routine_0100(RecompiledCpuImpl& cpu)
+    {
+        switch (cpu.getPc())
+        {
+            case 0x0100: goto block_0100;
+            case 0x0105: goto block_0105;
+            case 0x0108: goto block_0108;
+            case 0x010C: goto block_010C;
+            default: return;
+        }
+
+    block_0100:
+        if (!cpu.enterBlock(17)) return;
+        cpu.step<0x31>(0x0103, 0x2400);
+        cpu.step<0x06>(0x0105, 0x0040);
+        goto block_0105;
+
+    block_0105:
+        if (!cpu.enterBlock(17)) return;
+        cpu.step<0xCD>(0x0108, 0x0118);
+        return;
+
+    block_0108:
+        if (!cpu.enterBlock(15)) return;
+        cpu.step<0x05>(0x0109, 0x0000);
+        cpu.step<0xC2>(0x010C, 0x0105);
+        if (cpu.getPc() == 0x0105)
+            goto block_0105;
+        goto block_010C;
+
+    block_010C:
+        if (!cpu.enterBlock(15)) return;
+        cpu.step<0x21>(0x010F, 0x0114);
+        cpu.step<0xE9>(0x0110, 0x0000);
+        return;
+    }
+
+    void routine_0118(RecompiledCpuImpl& cpu)
+    {
+        switch (cpu.getPc())
+        {
+            case 0x0105: goto block_0105;
+            case 0x0108: goto block_0108;
+            case 0x010C: goto block_010C;
+            case 0x0118: goto block_0118;
+            default: return;
+        }
+
+    block_0105:
+        if (!cpu.enterBlock(17)) return;
+        cpu.step<0xCD>(0x0108, 0x0118);
+        return;
+
+    block_0108:
+        if (!cpu.enterBlock(15)) return;
+        cpu.step<0x05>(0x0109, 0x0000);
+        cpu.step<0xC2>(0x010C, 0x0105);
+        if (cpu.getPc() == 0x0105)
+            goto block_0105;
+        goto block_010C;
+
+    block_010C:
+        if (!cpu.enterBlock(15)) return;
+        cpu.step<0x21>(0x010F, 0x0114);
+        cpu.step<0xE9>(0x0110, 0x0000);
+        return;
+
+    block_0118:
+        if (!cpu.enterBlock(46)) return;
+        cpu.step<0xE1>(0x0119, 0x0000);
+        cpu.step<0x80>(0x011A, 0x0000);
+        cpu.step<0x1F>(0x011B, 0x0000);
+        cpu.step<0x4F>(0x011C, 0x0000);
+        cpu.step<0x32>(0x011F, 0x2000);
+        cpu.step<0xC3>(0x0122, 0x0108);
+        goto block_0108;
+    }
+
+    const RecompiledEntry entries[] = {
+        { 0x0100, routine_0100 },
+        { 0x0118, routine_0118 },
+        { 0x0105, routine_0100 },
+        { 0x0108, routine_0100 },
+        { 0x010C, routine_0100 },
+        { 0x0105, routine_0118 },
+        { 0x0108, routine_0118 },
+        { 0x010C, routine_0118 },
+    };
+}
+
+extern const RecompiledProgram recompiledTestProgram = {
+    0x0100, 34, 0x84B902C5, entries, 8
+};
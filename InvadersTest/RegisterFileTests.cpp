@@ -0,0 +1,62 @@
+#include "gtest/gtest.h"
+
+#include "..//Invaders/Registers.hpp"
+
+TEST(RegisterFileTests, testRegistersAreIndexedByRegisterTable)
+{
+    Registers registers;
+    auto& file = registers.getFile();
+    registers.getBc() = 0x0102;
+    registers.getDe() = 0x0304;
+    registers.getHl() = 0x0506;
+    registers.getAf() = 0x0700;
+
+    // B, C, D, E, H, L, (HL), A
+    EXPECT_EQ(0x01, file.getRegister(0));
+    EXPECT_EQ(0x02, file.getRegister(1));
+    EXPECT_EQ(0x03, file.getRegister(2));
+    EXPECT_EQ(0x04, file.getRegister(3));
+    EXPECT_EQ(0x05, file.getRegister(4));
+    EXPECT_EQ(0x06, file.getRegister(5));
+    EXPECT_EQ(0x07, file.getRegister(7));
+}
+
+TEST(RegisterFileTests, testRegistersWrittenByIndexAreVisibleInPairs)
+{
+    Registers registers;
+    auto& file = registers.getFile();
+
+    file.getRegister(0) = 0xB0;
+    file.getRegister(1) = 0xC0;
+    file.getRegister(4) = 0x80;
+    file.getRegister(5) = 0x40;
+    file.getRegister(7) = 0xA0;
+
+    EXPECT_EQ(0xB0C0, registers.getBc().getRaw());
+    EXPECT_EQ(0xB0, registers.getBc().getHigh());
+    EXPECT_EQ(0xC0, registers.getBc().getLow());
+    EXPECT_EQ(0x8040, registers.getHl().getRaw());
+    EXPECT_EQ(0xA0, registers.getAf().getHigh());
+}
+
+TEST(RegisterFileTests, testRegisterPairTables)
+{
+    Registers registers;
+    auto& file = registers.getFile();
+    registers.getBc() = 0x1111;
+    registers.getDe() = 0x2222;
+    registers.getHl() = 0x3333;
+    registers.getSp() = 0x4444;
+    registers.getAf() = 0x5555;
+
+    // BC, DE, HL, SP
+    EXPECT_EQ(&registers.getBc().getRaw(), &file.getRegisterPair(0));
+    EXPECT_EQ(&registers.getDe().getRaw(), &file.getRegisterPair(1));
+    EXPECT_EQ(&registers.getHl().getRaw(), &file.getRegisterPair(2));
+    EXPECT_EQ(&registers.getSp(), &file.getRegisterPair(3));
+    // BC, DE, HL, AF
+    EXPECT_EQ(0x1111, file.getStackRegisterPair(0));
+    EXPECT_EQ(0x2222, file.getStackRegisterPair(1));
+    EXPECT_EQ(0x3333, file.getStackRegisterPair(2));
+    EXPECT_EQ(0x5555, file.getStackRegisterPair(3));
+}
@@ -0,0 +1,98 @@
+#include <sstream>
+
+#include "gtest/gtest.h"
+
+#include "..//Invaders/StaticRecompiler.hpp"
+
+namespace
+{
+    std::string generate(const StaticRecompiler& recompiler)
+    {
+        std::ostringstream out;
+        recompiler.generate(out, "testProgram", "Custom.hpp");
+        return out.str();
+    }
+}
+
+TEST(StaticRecompilerTests, testRoutinesStartAtEntryPointsAndTargetsOfCalls)
+{
+    // 0000: CALL 0008; RST 2; JMP 0000
+    // 0008: RET
+    // 0010: PCHL
+    const std::vector<u8> image = {
+        0xCD, 0x08, 0x00, 0xD7, 0xC3, 0x00, 0x00, 0x00,
+        0xC9, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00,
+        0xE9
+    };
+    StaticRecompiler recompiler(0x0000, image);
+    recompiler.addEntryPoint(0x0000);
+
+    recompiler.analyze();
+
+    EXPECT_EQ(std::vector<u16>({ 0x0000, 0x0008, 0x0010 }), recompiler.getRoutines());
+    EXPECT_EQ(std::set<u16>({ 0x0000, 0x0003, 0x0004 }), recompiler.getBlocks(0x0000));
+    EXPECT_EQ(std::set<u16>({ 0x0008 }), recompiler.getBlocks(0x0008));
+    EXPECT_EQ(std::set<u16>({ 0x0010 }), recompiler.getBlocks(0x0010));
+}
+
+TEST(StaticRecompilerTests, testTargetsOutsideImageAreIgnored)
+{
+    // 0100: JNZ 0000; CALL 2000; HLT
+    const std::vector<u8> image = { 0xC2, 0x00, 0x00, 0xCD, 0x00, 0x20, 0x76 };
+    StaticRecompiler recompiler(0x0100, image);
+    recompiler.addEntryPoint(0x0000);
+    recompiler.addEntryPoint(0x0100);
+
+    recompiler.analyze();
+
+    EXPECT_EQ(std::vector<u16>({ 0x0100 }), recompiler.getRoutines());
+    EXPECT_EQ(std::set<u16>({ 0x0100, 0x0103, 0x0106 }), recompiler.getBlocks(0x0100));
+}
+
+TEST(StaticRecompilerTests, testGeneratedSource)
+{
+    // 0000: MVI B,10
+    // 0002: DCR B; JNZ 0002; JMP 0000
+    const std::vector<u8> image = { 0x06, 0x10, 0x05, 0xC2, 0x02, 0x00, 0xC3, 0x00, 0x00 };
+    StaticRecompiler recompiler(0x0000, image);
+    recompiler.addEntryPoint(0x0000);
+    recompiler.analyze();
+
+    const auto source = generate(recompiler);
+
+    EXPECT_NE(std::string::npos, source.find("#include \"Custom.hpp\""));
+    EXPECT_NE(std::string::npos, source.find("void routine_0000(RecompiledCpuImpl& cpu)"));
+    EXPECT_NE(std::string::npos, source.find("cpu.step<0x06>(0x0002, 0x0010);"));
+    EXPECT_NE(std::string::npos, source.find("if (!cpu.enterBlock(15)) return;"));
+    EXPECT_NE(std::string::npos, source.find("if (cpu.getPc() == 0x0002)\n            goto block_0002;"));
+    EXPECT_NE(std::string::npos, source.find("{ 0x0006, routine_0000 },"));
+    EXPECT_NE(std::string::npos, source.find("extern const RecompiledProgram testProgram = {\n    0x0000, 9, "));
+}
+
+TEST(StaticRecompilerTests, testLongBlocksAreSplit)
+{
+    std::vector<u8> image(40, 0x00);
+    image.insert(image.end(), { 0xC3, 0x00, 0x00 });
+    StaticRecompiler recompiler(0x0000, image);
+    recompiler.addEntryPoint(0x0000);
+
+    recompiler.analyze();
+
+    EXPECT_EQ(std::set<u16>({ 0x0000, StaticRecompiler::MAX_BLOCK_INSTRUCTIONS }), recompiler.getBlocks(0x0000));
+    EXPECT_NE(std::string::npos, generate(recompiler).find("goto block_0020;"));
+}
+
+TEST(StaticRecompilerTests, testInstructionCutByEndOfImageIsNotTranslated)
+{
+    // NOP; JMP (without second byte of address)
+    const std::vector<u8> image = { 0x00, 0xC3, 0x00 };
+    StaticRecompiler recompiler(0x0000, image);
+    recompiler.addEntryPoint(0x0000);
+
+    recompiler.analyze();
+
+    const auto source = generate(recompiler);
+    EXPECT_EQ(std::set<u16>({ 0x0000 }), recompiler.getBlocks(0x0000));
+    EXPECT_NE(std::string::npos, source.find("cpu.step<0x00>(0x0001, 0x0000);"));
+    EXPECT_EQ(std::string::npos, source.find("cpu.step<0xC3>"));
+}
@@ -0,0 +1,82 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "mocks/MemoryBusTest.hpp"
+
+#include "..//Invaders/ThreadedCpuImpl.hpp"
+
+class ThreadedCpuImplTests : public MemoryBusTest
+{
+    protected:
+        void SetUp() override
+        {
+            MemoryBusTest::SetUp();
+            testedCpu = std::make_unique<ThreadedCpuImpl>(bus);
+        }
+
+        std::unique_ptr<ThreadedCpuImpl> testedCpu;
+};
+
+TEST_F(ThreadedCpuImplTests, testExecutesRequestedNumberOfInstructions)
+{
+    // loop: INR B; JMP loop
+    loadProgram(0x0000, { 0x04, 0xC3, 0x00, 0x00 });
+    auto& regs = testedCpu->getRegisters();
+    regs.getPc() = 0x0000;
+    regs.getBc() = 0x0000;
+
+    auto executed = testedCpu->executeInstructions(21);
+
+    EXPECT_EQ(21, executed);
+    EXPECT_EQ(11, regs.getBc().getHigh());
+    EXPECT_EQ(0x0001, regs.getPc());
+}
+
+TEST_F(ThreadedCpuImplTests, testStopsOnHalt)
+{
+    // MVI B,03; loop: DCR B; JNZ loop; HLT
+    loadProgram(0x0000, { 0x06, 0x03, 0x05, 0xC2, 0x02, 0x00, 0x76 });
+    auto& regs = testedCpu->getRegisters();
+    regs.getPc() = 0x0000;
+
+    auto executed = testedCpu->executeInstructions(1000);
+
+    EXPECT_EQ(8, executed);
+    EXPECT_TRUE(testedCpu->isHalted());
+    EXPECT_EQ(0, regs.getBc().getHigh());
+    EXPECT_EQ(0x0007, regs.getPc());
+    EXPECT_EQ(0, testedCpu->executeInstructions(1000));
+}
+
+TEST_F(ThreadedCpuImplTests, testMatchesSteppedInterpreter)
+{
+    // Pseudo-random code, compared against plain interpreter stepping one instruction at a time
+    for (unsigned addr = 0; addr < memory.size(); addr++)
+        memory[addr] = static_cast<u8>((addr * 0x9E37) >> 7);
+
+    auto referenceMemory = memory;
+    auto referenceBus = makeMemoryBus(referenceMemory);
+    CpuImpl referenceCpu(referenceBus);
+
+    for (auto* regs : { &testedCpu->getRegisters(), &referenceCpu.getRegisters() })
+    {
+        regs->getPc() = 0x1000;
+        regs->getSp() = 0x8000;
+    }
+
+    auto executed = testedCpu->executeInstructions(5000);
+    for (unsigned long i = 0; i < executed; i++)
+        referenceCpu.executeInstruction(referenceCpu.fetchOpcode());
+
+    auto& expected = referenceCpu.getRegisters();
+    auto& actual = testedCpu->getRegisters();
+
+    EXPECT_EQ(expected.getAf().getRaw(), actual.getAf().getRaw());
+    EXPECT_EQ(expected.getBc().getRaw(), actual.getBc().getRaw());
+    EXPECT_EQ(expected.getDe().getRaw(), actual.getDe().getRaw());
+    EXPECT_EQ(expected.getHl().getRaw(), actual.getHl().getRaw());
+    EXPECT_EQ(expected.getSp(), actual.getSp());
+    EXPECT_EQ(expected.getPc(), actual.getPc());
+    EXPECT_EQ(referenceCpu.isHalted(), testedCpu->isHalted());
+    EXPECT_TRUE(referenceMemory == memory);
+}
@@ -0,0 +1,132 @@
+#include <sstream>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "mocks/MemoryBusTest.hpp"
+
+#include "..//Invaders/CpuImpl.hpp"
+#include "..//Invaders/TieredCpuImpl.hpp"
+
+namespace
+{
+    constexpr auto INTERPRETER = static_cast<std::size_t>(ExecutionTier::INTERPRETER);
+    constexpr auto BLOCK_CACHE = static_cast<std::size_t>(ExecutionTier::BLOCK_CACHE);
+}
+
+class TieredCpuImplTests : public MemoryBusTest
+{
+    protected:
+        void SetUp() override
+        {
+            MemoryBusTest::SetUp();
+            testedCpu = std::make_unique<TieredCpuImpl>(bus);
+
+            testedCpu->getRegisters().getSp() = 0x2400;
+        }
+
+        std::unique_ptr<TieredCpuImpl> testedCpu;
+};
+
+TEST_F(TieredCpuImplTests, testColdBlocksAreInterpreted)
+{
+    // MVI B,10; loop: DCR B; JNZ loop; HLT
+    loadProgram(0x0000, { 0x06, 0x10, 0x05, 0xC2, 0x02, 0x00, 0x76 });
+
+    testedCpu->run(1000);
+
+    const auto& stats = testedCpu->getTierStats();
+    EXPECT_TRUE(testedCpu->isHalted());
+    EXPECT_EQ(0x0007, testedCpu->getRegisters().getPc());
+    EXPECT_EQ(15, testedCpu->getHotness(0x0002));
+    EXPECT_EQ(0, stats.promotions);
+    EXPECT_EQ(17, stats.blockEntries[INTERPRETER]);
+    EXPECT_EQ(0, testedCpu->getCachedBlockCount());
+}
+
+TEST_F(TieredCpuImplTests, testHotBlockIsPromoted)
+{
+    // MVI B,10; loop: DCR B; JNZ loop; HLT
+    loadProgram(0x0000, { 0x06, 0x10, 0x05, 0xC2, 0x02, 0x00, 0x76 });
+    testedCpu->setPromotionThreshold(4);
+
+    testedCpu->run(1000);
+
+    // Loop is interpreted 4 times and runs remaining 11 times from block cache
+    const auto& stats = testedCpu->getTierStats();
+    EXPECT_TRUE(testedCpu->isHalted());
+    EXPECT_EQ(1, stats.promotions);
+    EXPECT_EQ(6, stats.blockEntries[INTERPRETER]);
+    EXPECT_EQ(11, stats.blockEntries[BLOCK_CACHE]);
+    EXPECT_EQ(11 * (5 + 10), stats.cycles[BLOCK_CACHE]);
+    EXPECT_EQ(testedCpu->getCycles() - testedCpu->getIdleStats().haltedCycles,
+              stats.cycles[INTERPRETER] + stats.cycles[BLOCK_CACHE]);
+    EXPECT_EQ(1, testedCpu->getCachedBlockCount());
+}
+
+TEST_F(TieredCpuImplTests, testWrittenBlockIsDemoted)
+{
+    // 0000: JMP 2000
+    // 0003: INR A; STA 2001; MVI B,FF; JMP 2000
+    // 2000: MVI A,01; INR B; JNZ 0003; HLT
+    loadProgram(0x0000, { 0xC3, 0x00, 0x20, 0x3C, 0x32, 0x01, 0x20, 0x06, 0xFF, 0xC3, 0x00, 0x20 });
+    loadProgram(0x2000, { 0x3E, 0x01, 0x04, 0xC2, 0x03, 0x00, 0x76 });
+    testedCpu->setPromotionThreshold(0);
+
+    testedCpu->run(200);
+
+    const auto& stats = testedCpu->getTierStats();
+    EXPECT_TRUE(testedCpu->isHalted());
+    EXPECT_EQ(0x02, testedCpu->getRegisters().getAf().getHigh());
+    EXPECT_EQ(1, stats.demotions);
+    EXPECT_EQ(5, stats.promotions);
+    EXPECT_EQ(0, stats.blockEntries[INTERPRETER]);
+    EXPECT_EQ(4, testedCpu->getCachedBlockCount());
+}
+
+TEST_F(TieredCpuImplTests, testRunMatchesInterpreter)
+{
+    // LXI H,2000; MVI B,20; loop: MOV A,B; ADD M; MOV M,A; INX H; PUSH PSW; XRA A; POP PSW; DCR B; JNZ loop; JMP 0000
+    loadProgram(0x0000, { 0x21, 0x00, 0x20, 0x06, 0x20, 0x78, 0x86, 0x77, 0x23, 0xF5, 0xAF, 0xF1, 0x05, 0xC2, 0x05, 0x00, 0xC3, 0x00, 0x00 });
+    const auto program = memory;
+
+    for (auto threshold : { 0u, 3u, 100000u })
+    {
+        memory = program;
+        testedCpu = std::make_unique<TieredCpuImpl>(bus);
+        testedCpu->getRegisters().getSp() = 0x2400;
+        testedCpu->setPromotionThreshold(threshold);
+
+        std::array<u8, 0x10000> interpreterMemory = program;
+        auto interpreterBus = makeMemoryBus(interpreterMemory);
+        CpuImpl interpreterCpu(interpreterBus);
+        interpreterCpu.getRegisters().getSp() = 0x2400;
+
+        for (auto budget : { 1000u, 33333u, 7u, 16666u })
+        {
+            EXPECT_EQ(interpreterCpu.run(budget), testedCpu->run(budget));
+            EXPECT_EQ(interpreterCpu.getCycles(), testedCpu->getCycles());
+            EXPECT_EQ(interpreterCpu.getRegisters().getPc(), testedCpu->getRegisters().getPc());
+            EXPECT_EQ(interpreterCpu.getRegisters().getAf().getRaw(), testedCpu->getRegisters().getAf().getRaw());
+            EXPECT_EQ(interpreterCpu.getRegisters().getHl().getRaw(), testedCpu->getRegisters().getHl().getRaw());
+        }
+        EXPECT_EQ(interpreterMemory, memory);
+    }
+}
+
+TEST_F(TieredCpuImplTests, testTierReport)
+{
+    // MVI B,10; loop: DCR B; JNZ loop; HLT
+    loadProgram(0x0000, { 0x06, 0x10, 0x05, 0xC2, 0x02, 0x00, 0x76 });
+    testedCpu->setPromotionThreshold(4);
+    testedCpu->run(1000);
+
+    std::ostringstream report;
+    testedCpu->writeTierReport(report);
+
+    EXPECT_NE(std::string::npos, report.str().find("Promotions: 1, demotions: 0"));
+    EXPECT_NE(std::string::npos, report.str().find("block cache: 11 blocks, 165 cycles"));
+
+    testedCpu->resetTierStats();
+    EXPECT_EQ(0, testedCpu->getTierStats().promotions);
+}
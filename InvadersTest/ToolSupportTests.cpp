@@ -0,0 +1,58 @@
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+
+#include "..//Invaders/BlockCacheCpuImpl.hpp"
+#include "..//Invaders/BusImpl.hpp"
+#include "..//Invaders/ToolSupport.hpp"
+
+TEST(ToolSupportTests, testNumbersAreParsed)
+{
+    unsigned value = 0;
+    EXPECT_TRUE(ToolSupport::parseNumber("600", value));
+    EXPECT_EQ(600, value);
+    EXPECT_TRUE(ToolSupport::parseNumber("0x1800", value));
+    EXPECT_EQ(0x1800, value);
+    EXPECT_FALSE(ToolSupport::parseNumber("", value));
+    EXPECT_FALSE(ToolSupport::parseNumber("12ab", value));
+
+    u16 addr = 0;
+    EXPECT_TRUE(ToolSupport::parseAddress("0xFFFF", addr));
+    EXPECT_EQ(0xFFFF, addr);
+    EXPECT_FALSE(ToolSupport::parseAddress("0x10000", addr));
+    EXPECT_EQ(0xFFFF, addr);
+}
+
+TEST(ToolSupportTests, testBackendsAreFoundByName)
+{
+    EXPECT_EQ(6, ToolSupport::getBackends().size());
+    EXPECT_EQ("decoder|table|threaded|block|tiered|jit", ToolSupport::getBackendNames());
+    EXPECT_EQ(nullptr, ToolSupport::findBackend("interpreter"));
+
+    const auto* backend = ToolSupport::findBackend("tiered");
+    ASSERT_NE(nullptr, backend);
+    auto cpu = backend->create(std::make_shared<BusImpl>());
+    EXPECT_NE(nullptr, dynamic_cast<BlockCacheCpuImpl*>(cpu.get()));
+}
+
+TEST(ToolSupportTests, testRomFileArgumentIsChecked)
+{
+    RomFile rom;
+    std::string error;
+    EXPECT_FALSE(ToolSupport::loadRomFile("invaders.h", rom, error));
+    EXPECT_EQ("Expected <address>:<file>, got invaders.h", error);
+    EXPECT_FALSE(ToolSupport::loadRomFile("0x0000:missing/invaders.h", rom, error));
+    EXPECT_EQ("Cannot open missing/invaders.h", error);
+}
+
+TEST(ToolSupportTests, testImageIsBuiltFromRomFiles)
+{
+    const std::vector<RomFile> roms = { { 0x1004, { 0x05, 0x06 } }, { 0x1000, { 0x01, 0x02 } } };
+    u16 origin = 0;
+    std::vector<u8> image;
+    ASSERT_TRUE(ToolSupport::buildImage(roms, origin, image));
+    EXPECT_EQ(0x1000, origin);
+    EXPECT_EQ(std::vector<u8>({ 0x01, 0x02, 0x00, 0x00, 0x05, 0x06 }), image);
+
+    EXPECT_FALSE(ToolSupport::buildImage({ { 0xFFFF, { 0x01, 0x02 } } }, origin, image));
+    EXPECT_FALSE(ToolSupport::buildImage({}, origin, image));
+}
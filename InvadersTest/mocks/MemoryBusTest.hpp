@@ -0,0 +1,45 @@
+#pragma once
+
+#include <array>
+#include <initializer_list>
+#include <memory>
+
+#include "gmock/gmock.h"
+#include "gtest/gtest.h"
+#include "BusMock.hpp"
+
+// Mocked bus backed with plain array, kept alive by caller
+inline std::shared_ptr<testing::NiceMock<BusMock>> makeMemoryBus(std::array<u8, 0x10000>& memory)
+{
+    using testing::_;
+    using testing::Invoke;
+
+    auto bus = std::make_shared<testing::NiceMock<BusMock>>();
+    ON_CALL(*bus, readFromMemory(_))
+        .WillByDefault(Invoke([&memory](u16 addr) { return memory[addr]; }));
+    ON_CALL(*bus, writeIntoMemory(_, _))
+        .WillByDefault(Invoke([&memory](u16 addr, u8 value) { memory[addr] = value; }));
+    ON_CALL(*bus, getMemoryLocationRef(_))
+        .WillByDefault(Invoke([&memory](u16 addr) -> u8& { return memory[addr]; }));
+    return bus;
+}
+
+// Fixture with zeroed memory-backed bus, derived fixtures create cpu in their SetUp
+class MemoryBusTest : public testing::Test
+{
+    protected:
+        void SetUp() override
+        {
+            memory.fill(0);
+            bus = makeMemoryBus(memory);
+        }
+
+        void loadProgram(u16 addr, std::initializer_list<u8> bytes)
+        {
+            for (auto byte : bytes)
+                memory[addr++] = byte;
+        }
+
+        std::shared_ptr<testing::NiceMock<BusMock>> bus;
+        std::array<u8, 0x10000> memory;
+};
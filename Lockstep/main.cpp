@@ -0,0 +1,104 @@
+#include <iostream>
+#include <string>
+
+#include "..//Invaders/BusImpl.hpp"
+#include "..//Invaders/CpuImpl.hpp"
+#include "..//Invaders/LockstepExecutor.hpp"
+#include "..//Invaders/ToolSupport.hpp"
+
+// Runs ROM in attract mode on interpreter and on tested backend at the same time,
+// stopping at first instruction on which they disagree.
+//
+// Usage: Lockstep <backend> [options] <address>:<file>...
+//   backend             decoder, table, threaded, block, tiered or jit
+//   --interval <n>      Instructions between comparisons, 1 compares after every instruction
+//   --frames <n>        Frames to run, 0 runs until cpus diverge
+//
+// Space Invaders:
+//   Lockstep jit --frames 216000 0x0000:invaders.h 0x0800:invaders.g 0x1000:invaders.f 0x1800:invaders.e
+
+int main(int argc, char* argv[])
+{
+    if (argc < 3)
+    {
+        std::cerr << "Usage: Lockstep <" << ToolSupport::getBackendNames() << "> [--interval <n>] [--frames <n>] <address>:<file>..." << std::endl;
+        return 1;
+    }
+
+    const auto* testedBackend = ToolSupport::findBackend(argv[1]);
+    if (testedBackend == nullptr)
+    {
+        std::cerr << "Unknown backend " << argv[1] << std::endl;
+        return 1;
+    }
+
+    unsigned interval = LockstepExecutor::DEFAULT_CHECK_INTERVAL;
+    unsigned frames = 0;
+    auto bus = std::make_shared<BusImpl>();
+    bool romLoaded = false;
+
+    for (int i = 2; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        if ((argument == "--interval" || argument == "--frames") && i + 1 < argc)
+        {
+            const std::string value = argv[++i];
+            if (!ToolSupport::parseNumber(value, argument == "--interval" ? interval : frames))
+            {
+                std::cerr << "Invalid value " << value << " of " << argument << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            RomFile rom;
+            std::string error;
+            if (!ToolSupport::loadRomFile(argument, rom, error))
+            {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+            bus->loadIntoMemory(rom.addr, rom.data);
+            romLoaded = true;
+        }
+    }
+
+    if (!romLoaded)
+    {
+        std::cerr << "No ROM files given" << std::endl;
+        return 1;
+    }
+
+    // Both cpus get their own copy of the machine
+    auto testedBus = std::make_shared<BusImpl>(*bus);
+    LockstepExecutor executor(bus, [](const std::shared_ptr<Bus>& busPtr) { return std::make_unique<CpuImpl>(busPtr); },
+                              testedBus, testedBackend->create);
+    executor.setCheckInterval(interval);
+
+    unsigned frame = 0;
+    while (frames == 0 || frame < frames)
+    {
+        if (!executor.run(ToolSupport::CYCLES_PER_HALF_FRAME))
+        {
+            break;
+        }
+        executor.requestInterrupt(1);
+        if (!executor.run(ToolSupport::CYCLES_PER_HALF_FRAME))
+        {
+            break;
+        }
+        executor.requestInterrupt(2);
+        frame++;
+    }
+
+    if (executor.hasDiverged())
+    {
+        std::cout << "Frame " << frame << ": ";
+        executor.writeDivergenceReport(std::cout);
+        return 2;
+    }
+
+    std::cout << "Ran " << frames << " frames, " << executor.getInstructionCount() << " instructions, "
+              << executor.getComparisonCount() << " comparisons without divergence" << std::endl;
+    return 0;
+}
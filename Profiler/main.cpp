@@ -0,0 +1,198 @@
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <string>
+
+#include "..//Invaders/BlockCacheCpuImpl.hpp"
+#include "..//Invaders/BusImpl.hpp"
+#include "..//Invaders/CpuImpl.hpp"
+#include "..//Invaders/GuestProfiler.hpp"
+#include "..//Invaders/HeatmapBus.hpp"
+#include "..//Invaders/ToolSupport.hpp"
+
+// Runs ROM in attract mode with guest profiler attached, and writes folded
+// stacks which flame graph tools (e.g. flamegraph.pl, speedscope) read.
+//
+// Usage: Profiler [options] <address>:<file>...
+//   --backend <name>    interpreter (default), decoder, table, threaded, block, tiered or jit,
+//                       interpreter being the same as table
+//   --frames <n>        Frames to run, 3600 by default
+//   --interval <n>      Cycles between samples, 1000 by default
+//   --symbols <file>    Names of routines, "<hex address> <name>" per line
+//   --output <file>     Write folded stacks into file instead of standard output
+//   --heatmap <file>    Count bus accesses and write them as CSV (.csv) or binary heatmap
+//   --heatmap-pages     Sum heatmap over 256 byte pages instead of single addresses
+//   --sequence-report <file>  Write most frequent instruction sequences executed from
+//                       block cache, marking fused ones (block or tiered backend)
+//
+// Space Invaders:
+//   Profiler --symbols invaders.sym --output invaders.folded 0x0000:invaders.h 0x0800:invaders.g 0x1000:invaders.f 0x1800:invaders.e
+
+namespace
+{
+    // Sequences of every length written into sequence report
+    constexpr std::size_t SEQUENCE_REPORT_COUNT = 20;
+}
+
+int main(int argc, char* argv[])
+{
+    std::string backend = "interpreter";
+    std::string symbolsPath;
+    std::string outputPath;
+    std::string heatmapPath;
+    std::string sequenceReportPath;
+    auto heatmapGranularity = HeatmapGranularity::ADDRESS;
+    unsigned frames = 3600;
+    unsigned interval = GuestProfiler::DEFAULT_SAMPLE_INTERVAL;
+    auto bus = std::make_shared<BusImpl>();
+    bool romLoaded = false;
+
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        const bool hasValue = i + 1 < argc;
+        if (argument == "--backend" && hasValue)
+        {
+            backend = argv[++i];
+        }
+        else if (argument == "--symbols" && hasValue)
+        {
+            symbolsPath = argv[++i];
+        }
+        else if (argument == "--output" && hasValue)
+        {
+            outputPath = argv[++i];
+        }
+        else if (argument == "--heatmap" && hasValue)
+        {
+            heatmapPath = argv[++i];
+        }
+        else if (argument == "--sequence-report" && hasValue)
+        {
+            sequenceReportPath = argv[++i];
+        }
+        else if (argument == "--heatmap-pages")
+        {
+            heatmapGranularity = HeatmapGranularity::PAGE;
+        }
+        else if ((argument == "--frames" || argument == "--interval") && hasValue)
+        {
+            const std::string value = argv[++i];
+            if (!ToolSupport::parseNumber(value, argument == "--frames" ? frames : interval) || (argument == "--interval" && interval == 0))
+            {
+                std::cerr << "Invalid value " << value << " of " << argument << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            RomFile rom;
+            std::string error;
+            if (!ToolSupport::loadRomFile(argument, rom, error))
+            {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+            bus->loadIntoMemory(rom.addr, rom.data);
+            romLoaded = true;
+        }
+    }
+
+    if (!romLoaded)
+    {
+        std::cerr << "Usage: Profiler [--backend <name>] [--frames <n>] [--interval <n>] [--symbols <file>] [--output <file>] [--heatmap <file>] [--heatmap-pages] [--sequence-report <file>] <address>:<file>..." << std::endl;
+        return 1;
+    }
+
+    GuestProfiler profiler(interval);
+    if (!symbolsPath.empty())
+    {
+        std::ifstream symbols(symbolsPath);
+        if (!symbols || !profiler.loadSymbols(symbols))
+        {
+            std::cerr << "Cannot read symbols from " << symbolsPath << std::endl;
+            return 1;
+        }
+    }
+
+    // Cpu is created over the decorator only when heatmap is requested
+    std::shared_ptr<HeatmapBus> heatmap;
+    if (!heatmapPath.empty())
+    {
+        heatmap = std::make_shared<HeatmapBus>(bus);
+    }
+
+    const auto* cpuBackend = ToolSupport::findBackend(backend == "interpreter" ? "table" : backend);
+    if (cpuBackend == nullptr)
+    {
+        std::cerr << "Unknown backend " << backend << std::endl;
+        return 1;
+    }
+    auto cpu = cpuBackend->create(heatmap ? std::static_pointer_cast<Bus>(heatmap) : std::static_pointer_cast<Bus>(bus));
+
+    const auto* blockCache = dynamic_cast<const BlockCacheCpuImpl*>(cpu.get());
+    if (!sequenceReportPath.empty() && blockCache == nullptr)
+    {
+        std::cerr << "Sequence report needs block or tiered backend" << std::endl;
+        return 1;
+    }
+
+    cpu->setProfiler(&profiler);
+    for (unsigned frame = 0; frame < frames; frame++)
+    {
+        cpu->run(ToolSupport::CYCLES_PER_HALF_FRAME);
+        cpu->requestInterrupt(1);
+        cpu->run(ToolSupport::CYCLES_PER_HALF_FRAME);
+        cpu->requestInterrupt(2);
+    }
+    cpu->setProfiler(nullptr);
+
+    if (outputPath.empty())
+    {
+        profiler.writeFoldedStacks(std::cout);
+    }
+    else
+    {
+        std::ofstream output(outputPath);
+        if (!output)
+        {
+            std::cerr << "Cannot write " << outputPath << std::endl;
+            return 1;
+        }
+        profiler.writeFoldedStacks(output);
+    }
+
+    if (!sequenceReportPath.empty())
+    {
+        std::ofstream report(sequenceReportPath);
+        if (!report)
+        {
+            std::cerr << "Cannot write " << sequenceReportPath << std::endl;
+            return 1;
+        }
+        blockCache->writeSequenceReport(report, SEQUENCE_REPORT_COUNT);
+    }
+
+    if (heatmap)
+    {
+        const bool csv = heatmapPath.size() >= 4 && heatmapPath.compare(heatmapPath.size() - 4, 4, ".csv") == 0;
+        std::ofstream output(heatmapPath, csv ? std::ios::out : std::ios::binary);
+        if (!output)
+        {
+            std::cerr << "Cannot write " << heatmapPath << std::endl;
+            return 1;
+        }
+        if (csv)
+        {
+            heatmap->writeCsv(output, heatmapGranularity);
+        }
+        else
+        {
+            heatmap->writeBinary(output, heatmapGranularity);
+        }
+    }
+
+    std::cerr << "Profiled " << frames << " frames on " << backend << ", " << profiler.getSampleCount()
+              << " samples every " << interval << " cycles" << std::endl;
+    return 0;
+}
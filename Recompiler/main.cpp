@@ -0,0 +1,123 @@
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "..//Invaders/ReachableCodeMap.hpp"
+#include "..//Invaders/StaticRecompiler.hpp"
+#include "..//Invaders/ToolSupport.hpp"
+
+// Build time tool translating ROM images into C++ source for RecompiledCpuImpl.
+//
+// Usage: Recompiler <output.cpp> <program name> [options] <address>:<file>...
+//   --include <path>   Path through which generated file includes RecompiledCpuImpl.hpp
+//   --entry <address>  Additional entry point, reset and RST vectors are always used
+//   --code-map <file>  Routines found by Analyzer are entry points as well, which
+//                      adds targets of jump tables static analysis could resolve
+//
+// Space Invaders:
+//   Recompiler InvadersRom.cpp invadersProgram 0x0000:invaders.h 0x0800:invaders.g 0x1000:invaders.f 0x1800:invaders.e
+
+int main(int argc, char* argv[])
+{
+    if (argc < 4)
+    {
+        std::cerr << "Usage: Recompiler <output.cpp> <program name> [--include <path>] [--entry <address>] [--code-map <file>] <address>:<file>..." << std::endl;
+        return 1;
+    }
+
+    const std::string outputPath = argv[1];
+    const std::string programName = argv[2];
+    std::string includePath = "RecompiledCpuImpl.hpp";
+    std::string codeMapPath;
+    std::vector<u16> entryPoints;
+    std::vector<RomFile> roms;
+
+    for (int i = 3; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        if ((argument == "--include" || argument == "--entry" || argument == "--code-map") && i + 1 < argc)
+        {
+            const std::string value = argv[++i];
+            u16 addr = 0;
+            if (argument == "--include")
+            {
+                includePath = value;
+            }
+            else if (argument == "--code-map")
+            {
+                codeMapPath = value;
+            }
+            else if (ToolSupport::parseAddress(value, addr))
+            {
+                entryPoints.push_back(addr);
+            }
+            else
+            {
+                std::cerr << "Invalid entry point " << value << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            RomFile rom;
+            std::string error;
+            if (!ToolSupport::loadRomFile(argument, rom, error))
+            {
+                std::cerr << error << std::endl;
+                return 1;
+            }
+            roms.push_back(std::move(rom));
+        }
+    }
+
+    if (roms.empty())
+    {
+        std::cerr << "No ROM files given" << std::endl;
+        return 1;
+    }
+
+    u16 origin = 0;
+    std::vector<u8> image;
+    if (!ToolSupport::buildImage(roms, origin, image))
+    {
+        std::cerr << "ROM files do not fit into address space" << std::endl;
+        return 1;
+    }
+
+    StaticRecompiler recompiler(origin, image);
+    for (unsigned vector = 0; vector < 0x40; vector += 8)
+    {
+        recompiler.addEntryPoint(vector);
+    }
+    for (auto addr : entryPoints)
+    {
+        recompiler.addEntryPoint(addr);
+    }
+    if (!codeMapPath.empty())
+    {
+        std::ifstream codeMapFile(codeMapPath, std::ios::binary);
+        ReachableCodeMap codeMap;
+        if (!codeMapFile || !ReachableCodeMap::read(codeMapFile, codeMap) || !codeMap.matches(origin, image))
+        {
+            std::cerr << "Cannot use code map " << codeMapPath << ", it has to be made from the same ROM files" << std::endl;
+            return 1;
+        }
+        for (auto addr : codeMap.getRoutines())
+        {
+            recompiler.addEntryPoint(addr);
+        }
+    }
+    recompiler.analyze();
+
+    std::ofstream output(outputPath);
+    if (!output)
+    {
+        std::cerr << "Cannot write " << outputPath << std::endl;
+        return 1;
+    }
+    recompiler.generate(output, programName, includePath);
+
+    std::cout << "Translated " << recompiler.getRoutines().size() << " routines into " << outputPath << std::endl;
+    return 0;
+}
@@ -0,0 +1,109 @@
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "..//Invaders/Disassembler.hpp"
+#include "..//Invaders/FlagRegister.hpp"
+#include "..//Invaders/InstructionTrace.hpp"
+#include "..//Invaders/ToolSupport.hpp"
+
+// Prints instruction trace dumped by InstructionTrace, one instruction per line:
+//
+//   1234567       1A5C  MVI B,40H         A=00 F=46 [ZP]     SP=2400
+//   1234577       0ADA  INT RST 2         A=00 F=46 [ZP]     SP=2400
+//
+// Columns are cycle counter, PC and state of registers before instruction.
+// Taken interrupts are marked with INT, their PC is the interrupted address.
+//
+// Usage: TraceDecoder [--last <n>] <trace file>
+//   --last <n>          Print only last n records
+
+namespace
+{
+    std::string flagsToString(u8 flags)
+    {
+        FlagRegister f;
+        f.raw = flags;
+        std::string names = "[";
+        names += f.S ? "S" : "";
+        names += f.Z ? "Z" : "";
+        names += f.AC ? "A" : "";
+        names += f.P ? "P" : "";
+        names += f.C ? "C" : "";
+        return names + "]";
+    }
+}
+
+int main(int argc, char* argv[])
+{
+    std::string path;
+    unsigned last = 0;
+    for (int i = 1; i < argc; i++)
+    {
+        const std::string argument = argv[i];
+        if (argument == "--last" && i + 1 < argc)
+        {
+            const std::string value = argv[++i];
+            if (!ToolSupport::parseNumber(value, last))
+            {
+                std::cerr << "Invalid value " << value << " of " << argument << std::endl;
+                return 1;
+            }
+        }
+        else
+        {
+            path = argument;
+        }
+    }
+
+    if (path.empty())
+    {
+        std::cerr << "Usage: TraceDecoder [--last <n>] <trace file>" << std::endl;
+        return 1;
+    }
+
+    std::ifstream file(path, std::ios::binary);
+    TraceFileHeader header;
+    std::vector<TraceRecord> records;
+    if (!file || !InstructionTrace::read(file, header, records))
+    {
+        std::cerr << "Cannot read trace from " << path << std::endl;
+        return 1;
+    }
+
+    // Whole cycle counters are restored for every record, including skipped ones
+    std::size_t first = 0;
+    if (last != 0 && last < records.size())
+    {
+        first = records.size() - static_cast<std::size_t>(last);
+    }
+
+    static char outputBuffer[1 << 16];
+    std::setvbuf(stdout, outputBuffer, _IOFBF, sizeof(outputBuffer));
+
+    u64 cycles = header.firstCycles;
+    for (std::size_t i = 0; i < records.size(); i++)
+    {
+        const auto& record = records[i];
+        if (i != 0)
+        {
+            cycles += static_cast<u32>(record.cycles - records[i - 1].cycles);
+        }
+        if (i < first)
+        {
+            continue;
+        }
+
+        const u16 operand = record.operand[0] | (record.operand[1] << 8);
+        const auto instruction = (record.kind == TraceRecordKind::INTERRUPT ? "INT " : "") + Disassembler::disassemble(record.opcode, operand);
+        char line[128];
+        std::snprintf(line, sizeof(line), "%-12llu  %04X  %-16s  A=%02X F=%02X %-7s  SP=%04X\n",
+                      static_cast<unsigned long long>(cycles), record.pc, instruction.c_str(),
+                      record.a, record.flags, flagsToString(record.flags).c_str(), record.sp);
+        std::fputs(line, stdout);
+    }
+    std::fflush(stdout);
+    return 0;
+}